@@ -56,6 +56,7 @@ struct command_t
     size_t argumentsCount                                               = 0;
     int MRI                                                             = 0; // MRI <-> Memory, Register, Immediate (general)
     bool isSpecialCommand                                               = false; // special instrs are jmp, call (1), otherwise 0
+    bool isIntegerCommand                                               = false; // integer instrs are iadd, icmp, etc. (register, register/immediate)
 
     encoded_command_t encoded                                           = {};
 };
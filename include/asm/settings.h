@@ -4,6 +4,9 @@
 #define COMMAND_FORMAT                  "%[a-zA-Z]%n %n%s%n"
 #define MNEMONICS_FORMAT                "%[a-zA-Z] %n"
 #define REGISTER_FORMAT                 "%2[a-z]%n"
+#define INT_REGISTER_FORMAT             "r%1[0-9]%n"
+#define INT_IMMEDIATE_VALUE_FORMAT      "%lld%n"
+#define ARGUMENTS_SEPARATOR_FORMAT      " , %n"
 #define IMMEDIATE_VALUE_FORMAT          "%lf%n"
 #define EXCLUDE_COMMENTS_FORMAT         "%[^;]"
 
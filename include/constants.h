@@ -1,5 +1,7 @@
 #include <stddef.h>  // for size_t
 
+#include "operands.h"
+
 #define OPDEF(opName, ...) #opName,
 
     const char *MNEMONICS_TABLE[] = {
@@ -25,3 +27,11 @@
     };
 
 #undef OPDEF
+
+#define OPDEF(unused1, unused2, unused3, argType, ...) OPERAND_TYPES::argType,
+
+    const OPERAND_TYPES OPERATION_ARG_TYPES_TABLE[] = {
+        #include "opdefs.h"
+    };
+
+#undef OPDEF
@@ -0,0 +1,125 @@
+/**
+ * @file fusedefs.h
+ * @brief File that is used to define superinstructions (fused sequences of commands from `opdefs.h`) via DSL
+ * @version 0.1
+ * @date 2023-06-04
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+// Pattern helpers (defined by the decoder):
+//      IS(index, opMnemonics)      - command `index` of the sequence is `opMnemonics`
+//      IS_MOVABLE(index)           - command `index` can `pop` into its operand (memory or register)
+//
+// Microcode helpers (defined by the engine) in addition to the ones from `opdefs.h`:
+//      GET_VALUE_OF(index)         - operand value of command `index` of the sequence
+//      MOVE_VALUE_OF(index, value) - 'mov' into operand of command `index` of the sequence
+//      GET_OFFSET_OF(index)        - label operand of command `index` of the sequence
+//      COMPARE(result, VAL_1, VAL_2) - `cmp` result (-1, 0, 1) of two values
+//
+// Patterns are tried in the order they are defined, so longer sequences go first.
+// Commands inside of a fused sequence are kept as is, so jumps into the middle of it stay valid.
+
+// DSL format:
+// fusedMnemonics, sequenceLength (amount of fused commands), pattern (condition on the sequence), code (microcode for the whole sequence)
+FUSEDEF(pushPushAddPop, 4, IS(0, push) && IS(1, push) && IS(2, add) && IS(3, pop) && IS_MOVABLE(3), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    MOVE_VALUE_OF(3, VAL_1 + VAL_2);
+})
+
+FUSEDEF(pushPushSubPop, 4, IS(0, push) && IS(1, push) && IS(2, sub) && IS(3, pop) && IS_MOVABLE(3), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    MOVE_VALUE_OF(3, VAL_1 - VAL_2);
+})
+
+FUSEDEF(pushPushMulPop, 4, IS(0, push) && IS(1, push) && IS(2, mul) && IS(3, pop) && IS_MOVABLE(3), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    MOVE_VALUE_OF(3, VAL_1 * VAL_2);
+})
+
+FUSEDEF(pushPushDivPop, 4, IS(0, push) && IS(1, push) && IS(2, div) && IS(3, pop) && IS_MOVABLE(3), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    MOVE_VALUE_OF(3, VAL_1 / VAL_2);
+})
+
+FUSEDEF(pushPushCmpJe, 4, IS(0, push) && IS(1, push) && IS(2, cmp) && IS(3, je), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    PUSH(VAL_2);
+    PUSH(VAL_1);
+
+    COMPARE(VAL, VAL_1, VAL_2);
+    if (fabs(VAL - DOUBLES_ARE_EQUAL) < EPS)
+    {
+        OFFSET = GET_OFFSET_OF(3);
+        JUMP(OFFSET);
+    }
+    else
+    {
+        PUSH(VAL);
+    }
+})
+
+FUSEDEF(pushPushCmpJl, 4, IS(0, push) && IS(1, push) && IS(2, cmp) && IS(3, jl), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    PUSH(VAL_2);
+    PUSH(VAL_1);
+
+    COMPARE(VAL, VAL_1, VAL_2);
+    if (fabs(VAL - FIRST_DOUBLE_IS_LOWER) < EPS)
+    {
+        OFFSET = GET_OFFSET_OF(3);
+        JUMP(OFFSET);
+    }
+    else
+    {
+        PUSH(VAL);
+    }
+})
+
+FUSEDEF(pushPushCmpJg, 4, IS(0, push) && IS(1, push) && IS(2, cmp) && IS(3, jg), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    PUSH(VAL_2);
+    PUSH(VAL_1);
+
+    COMPARE(VAL, VAL_1, VAL_2);
+    if (fabs(VAL - FIRST_DOUBLE_IS_GREATER) < EPS)
+    {
+        OFFSET = GET_OFFSET_OF(3);
+        JUMP(OFFSET);
+    }
+    else
+    {
+        PUSH(VAL);
+    }
+})
+
+FUSEDEF(pushPushCmpJne, 4, IS(0, push) && IS(1, push) && IS(2, cmp) && IS(3, jne), {
+    VAL_2 = GET_VALUE_OF(0);
+    VAL_1 = GET_VALUE_OF(1);
+    PUSH(VAL_2);
+    PUSH(VAL_1);
+
+    COMPARE(VAL, VAL_1, VAL_2);
+    if (fabs(VAL - DOUBLES_ARE_EQUAL) > EPS)
+    {
+        OFFSET = GET_OFFSET_OF(3);
+        JUMP(OFFSET);
+    }
+    else
+    {
+        PUSH(VAL);
+    }
+})
+
+FUSEDEF(pushPop, 2, IS(0, push) && IS(1, pop) && IS_MOVABLE(1), {
+    VAL = GET_VALUE_OF(0);
+    MOVE_VALUE_OF(1, VAL);
+})
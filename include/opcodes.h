@@ -0,0 +1,33 @@
+#ifndef OPCODES_H
+#define OPCODES_H
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+
+#undef DEBUG_LEVEL
+
+#include "operands.h"
+
+typedef unsigned char byte;
+
+#define OPDEF(opName, opcode, ...) OPCODE_##opName = opcode,
+
+    // Opcodes by their mnemonics
+    enum OPCODES
+    {
+        #include "opdefs.h"
+    };
+
+#undef OPDEF
+
+/**
+ * @brief Get the operand type of the command (based on its opcode)
+ * 
+ * @param opcode 
+ * @param type 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES getOperandType(byte opcode, OPERAND_TYPES *type);
+
+
+#endif  // OPCODES_H
@@ -15,6 +15,10 @@
     #define VAL_2   val2
     #define OFFSET  displacement
     #define IP      CPU->ip
+    #define FLAGS   CPU->flags
+    #define INT_DST (*intDestination)
+    #define INT_SRC intSource
+    #define CELL    cell
 
     // #define SFML    mainData
     // #define WINDOW  SFML->window
@@ -23,119 +27,156 @@
 
 // #define GOUT(indexToOut)            cpuGOut(CPU, indexToOut)
 
-#define PUSH(value)                 cpuPush(CPU, (double) value)
-#define POP()                       cpuPop(CPU)
-#define OUT()                       cpuOut(CPU)
-#define OUTC()                      cpuOutc(CPU)
-#define IN()                        cpuIn(CPU)
-#define EXIT(exitCode)              cpuExit(CPU, byteCode, exitCode)
-
-#define GET_VALUE()                 cpuGetBytecodeValue(CPU, byteCode)
-#define GET_OFFSET()                cpuGetBytecodeOffset(CPU, byteCode)
-#define MOVE_VALUE(value)           cpuMoveValue(CPU, byteCode, value)
 #define READ_STACK_VALUE(saveTo)    saveTo = POP(); PUSH(saveTo);
+#define FLAGS_OF(first, second)     (fabs((first) - (second)) < EPS ? EQUAL_FLAG :                      \
+                                    ((first) < (second) ? LOWER_FLAG : ((first) > (second) ? GREATER_FLAG : 0)))
+#define FLAGS_ARE(mask)             ((FLAGS & (mask)) != 0)
+#define INT_FLAGS_OF(first, second) ((first) == (second) ? EQUAL_FLAG : ((first) < (second) ? LOWER_FLAG : GREATER_FLAG))
+
+#ifndef REDEFINE_HELPERS
+    #define PUSH(value)             cpuPush(CPU, (double) value, CPU->status.ip)
+    #define POP()                   cpuPop(CPU, CPU->status.ip)
+    #define OUT()                   cpuOut(CPU)
+    #define OUTC()                  cpuOutc(CPU)
+    #define IN()                    cpuIn(CPU)
+    #define HALT(exitCode)          cpuHalt(CPU, exitCode)
+    #define TRAP(reason)            cpuTrap(CPU, reason, CPU->status.ip)
+
+    #define GET_VALUE()             cpuGetBytecodeValue(CPU, byteCode)
+    #define GET_OFFSET()            cpuGetBytecodeOffset(CPU, byteCode)
+    #define MOVE_VALUE(value)       cpuMoveValue(CPU, byteCode, value)
+    #define GET_INT_OPERAND()       intDestination = cpuGetIntegerOperand(CPU, byteCode, &intSource)
+
+    #define JUMP(destination)       IP = destination
+    #define SKIP_OFFSET()           IP += sizeof(OFFSET)
+    #define RETURN_ADDRESS()        (offset) (IP + sizeof(OFFSET))
+    #define RETURN_TO(address)      IP = address
+    #define IS_RETURN_ADDRESS(value)    (IS_INTEGRAL(value) && (value) >= 0 && (value) <= (double) byteCode->size)
+    #define CALL_PUSH(address)      cpuCallPush(CPU, address, CPU->status.ip)
+    #define CALL_POP()              cpuCallPop(CPU, CPU->status.ip)
+
+    #define CORE_ID()               CPU->coreId
+    #define SPAWN(address)          smpSpawn(CPU, address)
+    #define JOIN(core)              smpJoin(CPU, core)
+    #define FENCE()                 std::atomic_thread_fence(std::memory_order_seq_cst)
+    #define ACQUIRE_FENCE()         std::atomic_thread_fence(std::memory_order_acquire)
+    #define RELEASE_FENCE()         std::atomic_thread_fence(std::memory_order_release)
+
+    #define RAM_CELL(address)                           cpuRamCell(CPU, address)
+    #define ATOMIC_EXCHANGE(cell, value)                ramAtomicExchange(cell, value)
+    #define ATOMIC_ADD(cell, value)                     ramAtomicAdd(cell, value)
+    #define ATOMIC_COMPARE_EXCHANGE(cell, old, value)   ramAtomicCompareExchange(cell, old, value)
+#endif
 
 
 // DSL format:
-// opMnemonics, opcode, argc (ARGument Count), code (microcode for the defined instruction)
-OPDEF(push, 0, 1, {
+// opMnemonics, opcode, argc (ARGument Count), argType (see `OPERAND_TYPES`), code (microcode for the defined instruction)
+OPDEF(push, 0, 1, VALUE, {
     VAL = GET_VALUE();
     PUSH(VAL);
 })
 
-OPDEF(pop, 1, 1, {
+OPDEF(pop, 1, 1, VALUE, {
     VAL = POP();
     MOVE_VALUE(VAL);
 })
 
-OPDEF(add, 2, 0, {
+OPDEF(add, 2, 0, NONE, {
     VAL_1 = POP();
     VAL_2 = POP();
     PUSH(VAL_1 + VAL_2);
 })
 
-OPDEF(sub, 3, 0, {
+OPDEF(sub, 3, 0, NONE, {
     VAL_1 = POP();
     VAL_2 = POP();
     PUSH(VAL_1 - VAL_2);
 })
 
-OPDEF(mul, 4, 0, {
+OPDEF(mul, 4, 0, NONE, {
     VAL_1 = POP();
     VAL_2 = POP();
     PUSH(VAL_1 * VAL_2);
 })
 
-OPDEF(div, 5, 0, {
+OPDEF(div, 5, 0, NONE, {
     VAL_1 = POP();
     VAL_2 = POP();
     PUSH(VAL_1 / VAL_2);
 })
 
-OPDEF(out, 6, 0, {
+OPDEF(out, 6, 0, NONE, {
     OUT();
 })
 
-OPDEF(in, 7, 0, {
+OPDEF(in, 7, 0, NONE, {
     IN();
 })
 
-OPDEF(jmp, 8, 1, {
+OPDEF(jmp, 8, 1, LABEL, {
     OFFSET = GET_OFFSET();
-    IP = OFFSET;
+    JUMP(OFFSET);
 })
 
-OPDEF(call, 9, 1, {
-    PUSH(IP + sizeof(OFFSET));
+// Calls of the bytecode assembled before the call stack (see `call` and `ret`): the return address is pushed on the stack
+// of values, `vret` pops it (the program may read or replace it)
+OPDEF(vcall, 9, 1, LABEL, {
+    PUSH(RETURN_ADDRESS());
     OFFSET = GET_OFFSET();
-    IP = OFFSET;
+    JUMP(OFFSET);
 })
 
-OPDEF(ret, 10, 0, {
-    OFFSET = (offset) POP();
-    IP = OFFSET;
+OPDEF(vret, 10, 0, NONE, {
+    VAL = POP();
+    if (!IS_RETURN_ADDRESS(VAL))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DURING_JUMP);
+        TRAP(PROCESSOR_EXIT_CODES::ERROR_DURING_JUMP);
+    }
+    OFFSET = (offset) VAL;
+    RETURN_TO(OFFSET);
 })
 
-OPDEF(outc, 11, 0, {
+OPDEF(outc, 11, 0, NONE, {
     OUTC();
 })
 
-OPDEF(sqrt, 12, 0, {
+OPDEF(sqrt, 12, 0, NONE, {
     VAL = sqrt(POP());
     PUSH(VAL);
 })
 
-OPDEF(je, 13, 1, {
+OPDEF(je, 13, 1, LABEL, {
     READ_STACK_VALUE(VAL);
     if (fabs(VAL - DOUBLES_ARE_EQUAL) < EPS)
     {
         POP();
 
         OFFSET = GET_OFFSET();
-        IP = OFFSET;
+        JUMP(OFFSET);
     }
     else
     {
-        IP += sizeof(OFFSET);
+        SKIP_OFFSET();
     }
 })
 
-OPDEF(jl, 14, 1, {
+OPDEF(jl, 14, 1, LABEL, {
     READ_STACK_VALUE(VAL);
     if (fabs(VAL - FIRST_DOUBLE_IS_LOWER) < EPS)
     {
         POP();
 
         OFFSET = GET_OFFSET();
-        IP = OFFSET;
+        JUMP(OFFSET);
     }
     else
     {
-        IP += sizeof(OFFSET);
+        SKIP_OFFSET();
     }
 })
 
-OPDEF(cmp, 15, 0, {
+OPDEF(cmp, 15, 0, NONE, {
     VAL_1 = POP();
     VAL_2 = POP();
     PUSH(VAL_2);
@@ -155,38 +196,294 @@ OPDEF(cmp, 15, 0, {
     }
 })
 
-OPDEF(jg, 16, 1, {
+OPDEF(jg, 16, 1, LABEL, {
     READ_STACK_VALUE(VAL);
     if (fabs(VAL - FIRST_DOUBLE_IS_GREATER) < EPS)
     {
         POP();
 
         OFFSET = GET_OFFSET();
-        IP = OFFSET;
+        JUMP(OFFSET);
     }
     else
     {
-        IP += sizeof(OFFSET);
+        SKIP_OFFSET();
     }
 })
 
-OPDEF(jne, 17, 1, {
+OPDEF(jne, 17, 1, LABEL, {
     READ_STACK_VALUE(VAL);
     if (fabs(VAL - DOUBLES_ARE_EQUAL) > EPS)
     {
         POP();
 
         OFFSET = GET_OFFSET();
-        IP = OFFSET;
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+// Flags-based comparison: `fcmp` pops both values and sets the flags register (`first` is the one pushed first),
+// jumps only test the flags (the stack is not touched)
+OPDEF(fcmp, 25, 0, NONE, {
+    VAL_1 = POP();
+    VAL_2 = POP();
+    FLAGS = FLAGS_OF(VAL_2, VAL_1);
+})
+
+OPDEF(fje, 26, 1, LABEL, {
+    if (FLAGS_ARE(EQUAL_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+OPDEF(fjne, 27, 1, LABEL, {
+    if (!FLAGS_ARE(EQUAL_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+OPDEF(fjl, 28, 1, LABEL, {
+    if (FLAGS_ARE(LOWER_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+OPDEF(fjle, 29, 1, LABEL, {
+    if (FLAGS_ARE(LOWER_FLAG | EQUAL_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
     }
     else
     {
-        IP += sizeof(OFFSET);
+        SKIP_OFFSET();
     }
 })
 
-OPDEF(halt, 255, 0, {
-    EXIT(EXIT_SUCCESS);
+OPDEF(fjg, 30, 1, LABEL, {
+    if (FLAGS_ARE(GREATER_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+OPDEF(fjge, 31, 1, LABEL, {
+    if (FLAGS_ARE(GREATER_FLAG | EQUAL_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+// Integer commands: `op rN, src` (src is an integer register or an integer immediate), values are 64-bit two's complement
+OPDEF(imov, 32, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = INT_SRC;
+})
+
+OPDEF(iadd, 33, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = WRAPPED(INT_DST, +, INT_SRC);
+})
+
+OPDEF(isub, 34, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = WRAPPED(INT_DST, -, INT_SRC);
+})
+
+OPDEF(imul, 35, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = WRAPPED(INT_DST, *, INT_SRC);
+})
+
+OPDEF(idiv, 36, 2, INTEGER, {
+    GET_INT_OPERAND();
+    if (INT_SRC == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::INTEGER_DIVISION_BY_ZERO);
+        TRAP(PROCESSOR_EXIT_CODES::INTEGER_DIVISION_BY_ZERO);
+    }
+    INT_DST = INT_SRC == -1 ? WRAPPED(0, -, INT_DST) : INT_DST / INT_SRC;
+})
+
+OPDEF(imod, 37, 2, INTEGER, {
+    GET_INT_OPERAND();
+    if (INT_SRC == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::INTEGER_DIVISION_BY_ZERO);
+        TRAP(PROCESSOR_EXIT_CODES::INTEGER_DIVISION_BY_ZERO);
+    }
+    INT_DST = INT_SRC == -1 ? 0 : INT_DST % INT_SRC;
+})
+
+OPDEF(iand, 38, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = INT_DST & INT_SRC;
+})
+
+OPDEF(ior, 39, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = INT_DST | INT_SRC;
+})
+
+OPDEF(ixor, 40, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = INT_DST ^ INT_SRC;
+})
+
+OPDEF(ishl, 41, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = WRAPPED(INT_DST, <<, INT_SRC & 63);
+})
+
+// Arithmetic shift (the sign is kept)
+OPDEF(ishr, 42, 2, INTEGER, {
+    GET_INT_OPERAND();
+    INT_DST = INT_DST >> (INT_SRC & 63);
+})
+
+// Same flags as `fcmp` (`rN` is the first one)
+OPDEF(icmp, 43, 2, INTEGER, {
+    GET_INT_OPERAND();
+    FLAGS = INT_FLAGS_OF(INT_DST, INT_SRC);
+})
+
+// `in` sets END_OF_INPUT_FLAG or BAD_INPUT_FLAG if it did not read a value (it pushes NaN then), `fjeof` jumps if any of them is set
+OPDEF(fjeof, 44, 1, LABEL, {
+    if (FLAGS_ARE(END_OF_INPUT_FLAG | BAD_INPUT_FLAG))
+    {
+        OFFSET = GET_OFFSET();
+        JUMP(OFFSET);
+    }
+    else
+    {
+        SKIP_OFFSET();
+    }
+})
+
+// Virtual cores (see `--cores`) share the RAM, every core has its own stack, registers and flags. A RAM cell is read and
+// written as a whole, but the writes of one core may be seen by the others in any order unless they are ordered by `fence`
+// (`spawn` and `join` are fences too)
+OPDEF(coreid, 45, 0, NONE, {
+    PUSH(CORE_ID());
+})
+
+// Starts the free core at the label with a copy of the registers (its stack is empty), pushes its index or SMP_NO_CORE
+OPDEF(spawn, 46, 1, LABEL, {
+    OFFSET = GET_OFFSET();
+    SKIP_OFFSET();
+    PUSH(SPAWN(OFFSET));
+})
+
+// Pops the index of the spawned core, waits for its `halt` and pushes its exit code
+OPDEF(join, 47, 0, NONE, {
+    VAL = JOIN(POP());
+    if (VAL < 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_CORE_TO_JOIN);
+        TRAP(PROCESSOR_EXIT_CODES::BAD_CORE_TO_JOIN);
+    }
+    PUSH(VAL);
+})
+
+OPDEF(fence, 48, 0, NONE, {
+    FENCE();
+})
+
+// `fence` that orders the reads made before it with the reads and writes made after it
+OPDEF(acquire, 49, 0, NONE, {
+    ACQUIRE_FENCE();
+})
+
+// `fence` that orders the reads and writes made before it with the writes made after it
+OPDEF(release, 50, 0, NONE, {
+    RELEASE_FENCE();
+})
+
+// Atomic commands (read-modify-write of one RAM cell, a full barrier each): the address of the cell is pushed before the
+// operands, the value the cell had is pushed back
+OPDEF(xchg, 51, 0, NONE, {
+    VAL_1 = POP();
+    CELL  = RAM_CELL(POP());
+    if (CELL == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+        TRAP(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+    }
+    PUSH(ATOMIC_EXCHANGE(CELL, VAL_1));
+})
+
+OPDEF(xadd, 52, 0, NONE, {
+    VAL_1 = POP();
+    CELL  = RAM_CELL(POP());
+    if (CELL == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+        TRAP(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+    }
+    PUSH(ATOMIC_ADD(CELL, VAL_1));
+})
+
+// Operands are the expected value and the new one: the cell is replaced if it is equal to the expected value without EPS
+// (EQUAL_FLAG is set then, the flags are cleared otherwise)
+OPDEF(cas, 53, 0, NONE, {
+    VAL_2 = POP();
+    VAL_1 = POP();
+    CELL  = RAM_CELL(POP());
+    if (CELL == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+        TRAP(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+    }
+    FLAGS = ATOMIC_COMPARE_EXCHANGE(CELL, &VAL_1, VAL_2) ? EQUAL_FLAG : 0;
+    PUSH(VAL_1);
+})
+
+// The return address is kept on the call stack of the processor (not on the stack of values)
+OPDEF(call, 54, 1, LABEL, {
+    CALL_PUSH(RETURN_ADDRESS());
+    OFFSET = GET_OFFSET();
+    JUMP(OFFSET);
+})
+
+OPDEF(ret, 55, 0, NONE, {
+    OFFSET = CALL_POP();
+    RETURN_TO(OFFSET);
+})
+
+OPDEF(halt, 255, 0, NONE, {
+    HALT(EXIT_SUCCESS);
 })
 
 // TODO: Add GPU commands
@@ -198,12 +495,12 @@ OPDEF(halt, 255, 0, {
 // })
 
 /*
-OPDEF(ginit, 18, 0, {
+OPDEF(ginit, 18, 0, NONE, {
     WINDOW = sfRenderWindow_create({WIDTH, HEIGHT, BITS_PER_PIXEL}, WINDOW_NAME, sfClose, &settings);
     sfRenderWindow_setFramerateLimit(WINDOW, MAX_FPS);
 })
 
-OPDEF(gCircleInit, 19, 0, {
+OPDEF(gCircleInit, 19, 0, NONE, {
     CIRCLE = sfCircleShape_create();
     sfCircleShape_setOutlineThickness(CIRCLE, 1);
     sfCircleShape_setOutlineColor(CIRCLE, sfBlack);
@@ -212,23 +509,23 @@ OPDEF(gCircleInit, 19, 0, {
     sfCircleShape_setPosition(CIRCLE, {WIDTH / 2 - CIRCLE_RADIUS, HEIGHT / 2 - CIRCLE_RADIUS});
 })
 
-OPDEF(gWindowIsOpen, 20, 0, {
+OPDEF(gWindowIsOpen, 20, 0, NONE, {
     PUSH((double) sfRenderWindow_isOpen(WINDOW));
 })
 
-OPDEF(gWindowClear, 21, 0, {
+OPDEF(gWindowClear, 21, 0, NONE, {
     sfRenderWindow_clear(WINDOW, sfWhite);
 })
 
-OPDEF(gDrawCircle, 22, 0, {
+OPDEF(gDrawCircle, 22, 0, NONE, {
     sfRenderWindow_drawCircleShape(WINDOW, CIRCLE, NULL);
 })
 
-OPDEF(gWindowDisplay, 23, 0, {
+OPDEF(gWindowDisplay, 23, 0, NONE, {
     sfRenderWindow_display(WINDOW);
 })
 
-OPDEF(gClean, 24, 0, {
+OPDEF(gClean, 24, 0, NONE, {
     sfCircleShape_destroy(CIRCLE);
     sfRenderWindow_destroy(WINDOW);
 })
@@ -0,0 +1,17 @@
+#ifndef OPERANDS_H
+#define OPERANDS_H
+
+/**
+ * @brief An enum class that contains the types of command operands (`argType` column of `opdefs.h`)
+ * 
+ */
+enum class OPERAND_TYPES
+{
+    NONE,       // Command has no operand
+    VALUE,      // Command has MRI-encoded operand (register, immediate, memory)
+    LABEL,      // Command has an offset (to the label) operand
+    INTEGER,    // Command has an integer register destination and an integer register/immediate source
+};
+
+
+#endif  // OPERANDS_H
@@ -0,0 +1,99 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <atomic>               // for std::atomic
+#include <mutex>                // for std::mutex
+#include <condition_variable>   // for std::condition_variable
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+#include "include/processor/processor.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains batch exit codes
+ * 
+ */
+enum class BATCH_EXIT_CODES
+{
+    ERROR_ALLOCATING_WORKERS,
+    ERROR_STARTING_WORKER,
+    ERROR_CONSTRUCTING_WORKER_CPU,
+};
+
+/**
+ * @brief Structure that represents the deque of the records of one worker: the owner takes them from the front, thieves steal from the back
+ * 
+ * Both ends are kept in one word, so both sides take records with one compare-and-swap
+ * 
+ */
+struct alignas(BATCH_CACHE_LINE_SIZE) batch_deque_t
+{
+    std::atomic<unsigned long long> range { 0 };    // Indices of the records [front, back): front | back << 32
+};
+
+/**
+ * @brief Structure that contains the statistics of one worker thread
+ * 
+ */
+struct batch_worker_t
+{
+    batch_deque_t deque                 = {};
+    int index                           = 0;
+    int runsCount                       = 0;
+    int failedRunsCount                 = 0;
+    int stealsCount                     = 0;    // Successful steals
+    int stolenRecordsCount              = 0;    // Records taken from the other workers
+    double seconds                      = 0;    // Time spent in the runs
+    cpu_stats_t stats                   = {};   // Commands of all the runs
+    EXIT_CODES exitCode                 = EXIT_CODES::NO_ERRORS;
+};
+
+/**
+ * @brief Structure that represents the output of the run of one record (written in the order of the records)
+ * 
+ */
+struct batch_result_t
+{
+    char *text                          = NULL;     // Output of the run with its delimiter line
+    size_t length                       = 0;
+    int exitCode                        = EXIT_SUCCESS;
+    bool isDone                         = false;
+};
+
+/**
+ * @brief Structure that contains everything the worker threads share
+ * 
+ */
+struct batch_t
+{
+    text_t *byteCode                    = NULL;
+    const cpu_t *CPU                    = NULL;     // Settings of the workers and the decoded program (shared read-only)
+    const text_t *records               = NULL;
+
+    batch_worker_t *workers             = NULL;
+    int workersCount                    = 0;
+    int runningWorkersCount             = 0;        // Workers that may still publish results (guarded by `resultsLock`)
+
+    batch_result_t *results             = NULL;     // One per record
+    std::mutex resultsLock              = {};
+    std::condition_variable resultIsDone = {};
+};
+
+/**
+ * @brief Function that executes the bytecode once per record (non-empty line of `records`, it is the input of the run)
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param records 
+ * @param threadsCount amount of worker threads (1 for the runs on the calling thread)
+ * @param lanesCount amount of records run in lockstep (1 for the scalar runs)
+ * @param failedRunsCount amount of runs that did not exit with EXIT_SUCCESS
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteBatch(text_t *byteCode, cpu_t *CPU, const text_t *records, int threadsCount, int lanesCount, int *failedRunsCount);
+
+
+#endif  // BATCH_H
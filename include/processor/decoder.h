@@ -0,0 +1,128 @@
+#ifndef DECODER_H
+#define DECODER_H
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+#include "include/regdefs.h"
+
+#undef DEBUG_LEVEL
+
+typedef unsigned char byte;
+typedef unsigned int offset;
+
+const int MAX_DECODED_REGS          = 2;                    // Register arguments of each kind kept in the command (operands with more are in `extraRegs` of the program)
+const int MAX_OPERAND_ARGS          = 7;                    // Arguments of one operand (every operand `GET_TOTAL_ARGS` can encode)
+const int ZERO_REGISTER             = MAX_REGS_COUNT;       // Index of the hardwired zero register (unused register argument)
+const int ZERO_INT_REGISTER         = MAX_INT_REGS_COUNT;   // Index of the hardwired zero integer register (unused integer register argument)
+const int EXTRA_INT_REGISTER        = ZERO_INT_REGISTER + 1; // `intRegs[0]` of the command whose arguments are in `extraRegs` of the program (not a register)
+const int BAD_TARGET                = -1;                   // Jump target that is not a command boundary
+const byte EXTRA_IMMEDIATE_CODE     = 0xFF;                 // Code of the immediate argument in `extraRegs` of the program (not a register)
+
+// Register byte of the bytecode is `rN` (integer register INT_REGS_BASE + N)
+#define IS_INT_REGISTER_CODE(code)  ((code) >= INT_REGS_BASE && (code) < INT_REGS_BASE + MAX_INT_REGS_COUNT)
+
+// Handler codes of decoded commands that do not correspond to any opcode byte
+const int DECODED_END_OPCODE        = 256;                  // Sentinel after the last command
+const int DECODED_INVALID_OPCODE    = 257;                  // Command that could not be decoded
+
+#define FUSEDEF(fusedName, ...) FUSED_OPCODE_##fusedName,
+
+    // Handler codes of superinstructions (see `include/fusedefs.h`)
+    enum FUSED_OPCODES
+    {
+        FUSED_OPCODES_BEGIN = DECODED_INVALID_OPCODE,
+        #include "include/fusedefs.h"
+        FUSED_OPCODES_END
+    };
+
+#undef FUSEDEF
+
+const int DECODED_OPCODES_COUNT     = FUSED_OPCODES_END;
+
+/**
+ * @brief Structure that represents one command of the bytecode with all its operands already parsed
+ * 
+ */
+struct decoded_command_t
+{
+    double immediate                = 0;        // Sum of all immediate arguments
+    long long intImmediate          = 0;        // Source of INTEGER command, integral `immediate` of the integer RAM address
+    int target                      = 0;        // Index of the command the label argument points to
+    offset address                  = 0;        // Offset of the command in the raw bytecode
+    offset nextAddress              = 0;        // Offset of the next command in the raw bytecode (return address)
+    unsigned short opcode           = 0;        // Opcode byte or one of DECODED_*_OPCODE codes
+    unsigned short handler          = 0;        // Handler to dispatch to: `opcode` or FUSED_OPCODE_* code of the sequence it starts
+    byte MRI                        = 0;        // Global MRI (only memory bit is used)
+    byte destination                = 0;        // Register to `pop` into (ZERO_REGISTER if the first argument is not a register)
+    byte regs[MAX_DECODED_REGS]     = {};       // Register arguments (ZERO_REGISTER if unused)
+    byte intRegs[MAX_DECODED_REGS]  = {};       // Integer register arguments, source of INTEGER command (ZERO_INT_REGISTER if unused)
+    byte intDestination             = 0;        // Integer register to `pop` into, destination of INTEGER command (ZERO_INT_REGISTER if none)
+    bool intAddress                 = false;    // RAM address is `intImmediate` + integer registers (no common registers, no EPS check)
+};
+
+/**
+ * @brief Structure that represents the arguments of the operand the command can not keep
+ * 
+ * More registers than the command has or the immediate after the common register (the sum of the immediates is
+ * the first term of the command, so more than two terms would be added in another order)
+ * 
+ */
+struct decoded_extra_regs_t
+{
+    double immediates[MAX_OPERAND_ARGS] = {};   // Immediate arguments (their code is EXTRA_IMMEDIATE_CODE)
+    byte codes[MAX_OPERAND_ARGS]        = {};   // Bytecode codes of the arguments in their order (common and integer registers, immediates)
+    int count                           = 0;
+};
+
+/**
+ * @brief Structure that represents the entire predecoded bytecode
+ * 
+ */
+struct decoded_program_t
+{
+    decoded_command_t *commands     = NULL;     // All commands + DECODED_END_OPCODE sentinel
+    int commandsCount               = 0;        // Amount of commands (without sentinel)
+    int *commandIndex               = NULL;     // Bytecode offset -> index of the command (BAD_TARGET if not a command boundary)
+    size_t bytesCount               = 0;        // Size of the raw bytecode
+    int fusedCount                  = 0;        // Amount of superinstructions in the program
+    int *blockCosts                 = NULL;     // Command index -> commands of the block from it (metered runs, see `meterDecodedCommands`)
+    int *jumpCosts                  = NULL;     // Command index -> cost of the taken jump: its target block minus the rest of its own block
+    decoded_extra_regs_t *extraRegs = NULL;     // Command index -> arguments of the commands with EXTRA_INT_REGISTER (NULL if there are none)
+};
+
+/**
+ * @brief Function that decodes the raw bytecode into the flat array of fixed-size commands
+ * 
+ * @param program 
+ * @param byteCode 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES decodedProgramCtor(decoded_program_t *program, text_t *byteCode);
+
+/**
+ * @brief Function that replaces sequences of decoded commands with superinstructions (see `include/fusedefs.h`)
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES fuseDecodedCommands(decoded_program_t *program);
+
+/**
+ * @brief Function that precomputes the costs of the blocks and of the jumps between them (metered runs)
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES meterDecodedCommands(decoded_program_t *program);
+
+/**
+ * @brief Function that frees all the memory allocated for the decoded program
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES decodedProgramDtor(decoded_program_t *program);
+
+
+#endif  // DECODER_H
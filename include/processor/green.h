@@ -0,0 +1,89 @@
+#ifndef GREEN_H
+#define GREEN_H
+
+#include <stddef.h>  // for size_t
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+#include "include/processor/processor.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains green threads exit codes
+ * 
+ */
+enum class GREEN_EXIT_CODES
+{
+    BAD_THREADS_COUNT,
+    ERROR_ALLOCATING_THREADS,
+    ERROR_CONSTRUCTING_THREAD_CPU,
+    ERROR_READING_INPUT,
+    UNSUPPORTED_ENGINE,
+};
+
+/**
+ * @brief An enum class that contains all the states of one green thread
+ * 
+ */
+enum class GREEN_STATES
+{
+    READY,      // In the ready queue
+    WAITING,    // `in` found no value, the thread is ready again when its next line of the input comes
+    HALTED,     // `halt` or a runtime error (the output is written and the processor is freed)
+};
+
+/**
+ * @brief Structure that represents one instance of the program run by the scheduler
+ * 
+ */
+struct green_thread_t
+{
+    cpu_t CPU                           = {};       // The whole state of the run (the scheduler never copies it)
+    GREEN_STATES state                  = GREEN_STATES::READY;
+    int next                            = GREEN_NO_THREAD;  // Next thread of the ready queue (the queue is linked through the threads)
+};
+
+/**
+ * @brief Structure that represents the scheduler that runs the green threads by slices on the calling host thread
+ * 
+ */
+struct green_scheduler_t
+{
+    text_t *byteCode                    = NULL;
+    cpu_t *CPU                          = NULL;     // Processor of `main`: its settings are used by the threads, their outputs go to its output
+    green_thread_t *threads             = NULL;
+    int threadsCount                    = 0;
+    unsigned long long quantum          = GREEN_QUANTUM;
+
+    int readyHead                       = GREEN_NO_THREAD;
+    int readyTail                       = GREEN_NO_THREAD;
+    int waitingCount                    = 0;
+    int haltedCount                     = 0;
+    int failedCount                     = 0;        // Threads that did not exit with EXIT_SUCCESS
+
+    char *input                         = NULL;     // Bytes of stdin that are not dispatched yet (the last line may be cut)
+    size_t inputSize                    = 0;
+    size_t inputCapacity                = 0;
+    bool isInputEnd                     = false;    // Inputs of the threads are closed
+
+    unsigned long long slicesCount      = 0;
+    unsigned long long waitsCount       = 0;        // Slices that ended waiting for the input
+    unsigned long long droppedLinesCount = 0;       // Lines of stdin without the thread to go to (bad index or halted thread)
+};
+
+/**
+ * @brief Function that executes `threadsCount` instances of the bytecode as green threads on the calling host thread
+ * 
+ * @param byteCode 
+ * @param CPU processor of `main` (its settings are used for all the threads)
+ * @param threadsCount 
+ * @param quantum commands of one slice
+ * @param exitCode EXIT_SUCCESS if every thread halted without a runtime error
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteGreen(text_t *byteCode, cpu_t *CPU, int threadsCount, unsigned long long quantum, int *exitCode);
+
+
+#endif  // GREEN_H
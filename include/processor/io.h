@@ -0,0 +1,246 @@
+#ifndef IO_H
+#define IO_H
+
+#include <stdio.h>   // for FILE
+#include <stddef.h>  // for size_t
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "include/processor/settings.h"
+#include "include/processor/ring.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains I/O exit codes
+ * 
+ */
+enum class IO_EXIT_CODES
+{
+    ERROR_ALLOCATING_OUTPUT_BUFFER,
+    ERROR_WRITING_OUTPUT,
+    ERROR_ALLOCATING_INPUT_BUFFER,
+    ERROR_READING_INPUT,
+};
+
+/**
+ * @brief An enum class that contains all the text formats of `out`
+ * 
+ */
+enum class OUTPUT_FORMATS
+{
+    LF,         // The same text as `printf("%lf")` (default)
+    SHORTEST,   // The shortest text that is read back into the same double (`std::to_chars`)
+};
+
+/**
+ * @brief An enum class that contains all the formats of `in`
+ * 
+ */
+enum class INPUT_FORMATS
+{
+    TEXT,       // Numbers separated by whitespace (the same syntax as `scanf("%lf")`)
+    BINARY,     // Raw little-endian doubles (8 bytes each)
+};
+
+/**
+ * @brief An enum class that contains all the results of reading one value
+ * 
+ */
+enum class INPUT_RESULTS
+{
+    VALUE,          // The value is read
+    END_OF_INPUT,   // There are no more values
+    BAD_VALUE,      // The word is not a number or the binary value is cut (it is skipped)
+    NOT_READY,      // The appended input has no value yet (more of it may be appended, see `inputAppend`)
+};
+
+/**
+ * @brief Structure that represents the buffered output of the processor (it is written to `stream` when it is full or flushed)
+ * 
+ */
+struct cpu_output_t
+{
+    FILE *stream                        = NULL;     // NULL if the text is kept in memory (see `outputTake`)
+    char *buffer                        = NULL;
+    size_t size                         = 0;        // Amount of buffered bytes
+    size_t capacity                     = 0;
+    OUTPUT_FORMATS format               = OUTPUT_FORMATS::LF;
+    bool interactive                    = false;    // `stream` is a terminal (the output is flushed before the input and on new lines)
+    char lastWritten                    = '\n';     // Last character written to `stream` (see `outputEndLine`)
+    ring_t *ring                        = NULL;     // Values of `out` are pushed here instead of the text (the characters are dropped)
+    unsigned long long valuesCount      = 0;        // Values written by `out`
+};
+
+/**
+ * @brief Structure that represents the input of the processor: regular files are mapped, other streams are read by blocks
+ * 
+ */
+struct cpu_input_t
+{
+    FILE *stream                        = NULL;     // NULL if the text is appended (see `inputAppend`)
+    const char *data                    = NULL;     // Unread bytes are [data + position, data + size)
+    size_t position                     = 0;
+    size_t size                         = 0;
+    char *buffer                        = NULL;     // `data` of the stream that is not mapped
+    size_t capacity                     = 0;
+    void *mapping                       = NULL;     // Whole mapped file (`data` starts at the offset of the stream)
+    size_t mappingSize                  = 0;
+    bool isStreamEnd                    = false;    // Every byte of the stream is in `data` (nothing more is appended, see `inputClose`)
+    INPUT_FORMATS format                = INPUT_FORMATS::TEXT;
+    ring_t *ring                        = NULL;     // Values are popped from here instead of the stream (closed ring is the end of the input)
+    unsigned long long valuesCount      = 0;        // Values read (bad ones are not counted)
+};
+
+/**
+ * @brief Function that constructs the output buffer of `capacity` bytes (at least OUTPUT_MAX_DOUBLE_LENGTH)
+ * 
+ * @param output 
+ * @param stream NULL for the text in memory (see `outputTake`)
+ * @param capacity 
+ * @param format 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputCtor(cpu_output_t *output, FILE *stream, size_t capacity, OUTPUT_FORMATS format);
+
+/**
+ * @brief Function that flushes the output and frees its buffer
+ * 
+ * @param output 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputDtor(cpu_output_t *output);
+
+/**
+ * @brief Function that writes the buffered output to the stream (the output without the stream makes room for the next double)
+ * 
+ * @param output 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputFlush(cpu_output_t *output);
+
+/**
+ * @brief Function that appends the text of the double in the format of the output
+ * 
+ * @param output 
+ * @param value 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputDouble(cpu_output_t *output, double value);
+
+/**
+ * @brief Function that appends a single character
+ * 
+ * @param output 
+ * @param character 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputChar(cpu_output_t *output, char character);
+
+/**
+ * @brief Function that appends the text of `length` bytes
+ * 
+ * @param output 
+ * @param text 
+ * @param length 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputText(cpu_output_t *output, const char *text, size_t length);
+
+/**
+ * @brief Function that appends a new line if the text does not end with one
+ * 
+ * @param output 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputEndLine(cpu_output_t *output);
+
+/**
+ * @brief Function that gives the text of the output without the stream away and empties the output
+ * 
+ * @param output 
+ * @param text allocated copy of the text (it is freed by the caller)
+ * @param length 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputTake(cpu_output_t *output, char **text, size_t *length);
+
+/**
+ * @brief Function that constructs the input of the stream (it is mapped if it is a regular file, otherwise it is read by blocks of `capacity` bytes)
+ * 
+ * @param input 
+ * @param stream NULL for the text that is appended (the buffer of `capacity` bytes is allocated by the first `inputAppend`)
+ * @param capacity 
+ * @param format 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputCtor(cpu_input_t *input, FILE *stream, size_t capacity, INPUT_FORMATS format);
+
+/**
+ * @brief Function that frees the input buffer (or unmaps the file)
+ * 
+ * @param input 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputDtor(cpu_input_t *input);
+
+/**
+ * @brief Function that makes the input read `size` bytes of `data` (the stream is not read anymore, `data` is not copied)
+ * 
+ * @param input 
+ * @param data 
+ * @param size 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputRecord(cpu_input_t *input, const char *data, size_t size);
+
+/**
+ * @brief Function that appends `size` bytes of `data` to the input without the stream (the read bytes are dropped, the buffer grows twice)
+ * 
+ * @param input 
+ * @param data 
+ * @param size 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputAppend(cpu_input_t *input, const char *data, size_t size);
+
+/**
+ * @brief Function that ends the input without the stream: the rest of it is read, then it is the end of the input
+ * 
+ * @param input 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputClose(cpu_input_t *input);
+
+/**
+ * @brief Function that reads the next value in the format of the input (`value` is NaN unless the result is INPUT_RESULTS::VALUE)
+ * 
+ * @param input 
+ * @param value 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputDouble(cpu_input_t *input, double *value, INPUT_RESULTS *result);
+
+/**
+ * @brief Function that parses the whole text of the double (the same syntax as `strtod`, the fast path is exact)
+ * 
+ * @param text 
+ * @param length 
+ * @param value 
+ * @return bool the text is a number
+ */
+bool parseDouble(const char *text, size_t length, double *value);
+
+/**
+ * @brief Function that writes the text of the double into `buffer` of at least OUTPUT_MAX_DOUBLE_LENGTH bytes (not terminated)
+ * 
+ * @param buffer 
+ * @param value 
+ * @param format 
+ * @return size_t length of the text
+ */
+size_t formatDouble(char *buffer, double value, OUTPUT_FORMATS format);
+
+
+#endif  // IO_H
@@ -0,0 +1,246 @@
+#ifndef JIT_H
+#define JIT_H
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "include/processor/decoder.h"
+#include "include/processor/memory.h"
+
+#undef DEBUG_LEVEL
+
+// Native code is generated for x86-64 with System V calling convention only (other hosts always use the interpreter)
+#if defined(__x86_64__) && defined(__linux__)
+    #define JIT_SUPPORTED 1
+#else
+    #define JIT_SUPPORTED 0
+#endif
+
+/**
+ * @brief An enum class that contains JIT exit codes
+ * 
+ */
+enum class JIT_EXIT_CODES
+{
+    JIT_IS_NOT_SUPPORTED,
+    ERROR_ALLOCATING_CODE_BUFFER,
+    CODE_BUFFER_OVERFLOW,
+    ERROR_PROTECTING_CODE_BUFFER,
+    TRACE_IS_NOT_COMPILABLE,
+};
+
+/**
+ * @brief Structure that contains the state shared by the native code and the processor (field offsets are used by the generated code)
+ * 
+ */
+struct jit_state_t
+{
+    double *sp                          = NULL;     // Next free slot of the operand stack
+    double *stackBase                   = NULL;     // Bottom of the operand stack
+    double *stackLimit                  = NULL;     // End of the operand stack memory
+    double *regs                        = NULL;     // Common registers (last one is ZERO_REGISTER)
+    long long *intRegs                  = NULL;     // Integer registers (last one is ZERO_INT_REGISTER)
+    int *flags                          = NULL;     // Flags register of the processor
+    offset *callStack                   = NULL;     // Return addresses of `call` (bytecode offsets)
+    int callDepth                       = 0;
+    int maxCallDepth                    = 0;
+    double *RAM                         = NULL;     // NULL for the paged RAM
+    ram_tlb_entry_t *tlb                = NULL;     // TLB of the paged RAM (misses are exited to the interpreter that fills it)
+    size_t RAMSize                      = 0;        // Amount of cells
+    const void **entries                = NULL;     // Bytecode offset -> native code of the block that starts there (NULL if none)
+    unsigned long long commands         = 0;        // Amount of commands executed by the native code
+    double eps                          = 0;        // Precision of comparisons (see `EPS`)
+
+    void (*in)(jit_state_t *state)      = NULL;     // Callbacks for the I/O commands (operand stack is in `sp`)
+    void (*out)(jit_state_t *state)     = NULL;
+    void (*outc)(jit_state_t *state)    = NULL;
+    void *context                       = NULL;     // User data for the callbacks
+};
+
+/**
+ * @brief Function type of the native code entry: runs from `code` until the command that is not compiled, returns its index
+ * 
+ */
+typedef int (*jit_entry_t)(jit_state_t *state, const void *code);
+
+/**
+ * @brief Structure that represents a jump to the native code of `command` (resolved once it is compiled)
+ * 
+ */
+struct jit_link_t
+{
+    size_t position                     = 0;        // Position of rel32 field of the jump
+    int command                         = 0;
+};
+
+/**
+ * @brief Structure that represents the RAM access of the native code that may fault in the guard region (it continues with the side exit)
+ * 
+ */
+struct jit_fault_t
+{
+    size_t instruction                  = 0;        // Position of the access
+    size_t exit                         = 0;        // Position of its side exit
+};
+
+/**
+ * @brief Structure that contains the native code of the whole program (one piece per basic block)
+ * 
+ */
+struct jit_t
+{
+    byte *code                          = NULL;     // Executable buffer (mmap'd)
+    size_t codeSize                     = 0;
+    size_t codeCapacity                 = 0;
+    size_t exitStub                     = 0;        // Offset of the common exit code (more code is appended by `jitCompileTrace`)
+
+    const void **blockEntries           = NULL;     // Index of the command -> native code of the block (or trace) that starts with it (NULL if none)
+    const void **entries                = NULL;     // Bytecode offset -> native code of the block that starts there (NULL if none)
+    jit_entry_t enter                   = NULL;
+
+    int blocksCount                     = 0;
+    int compiledBlocksCount             = 0;        // Amount of compiled blocks (or traces)
+    bool ramGuarded                     = false;    // Out of range RAM indices fault (bounds are not checked by the native code)
+    bool ramPaged                       = false;    // RAM cells are found via the TLB (see `ram_tlb_entry_t`)
+
+    jit_link_t *unlinkedExits           = NULL;     // Exits of the traces to the commands without native code yet
+    int unlinkedExitsCount              = 0;
+    int unlinkedExitsCapacity           = 0;
+
+    jit_fault_t *faults                 = NULL;     // RAM accesses by position (guarded RAM only)
+    int faultsCount                     = 0;
+    int faultsCapacity                  = 0;
+};
+
+/**
+ * @brief Structure that represents one executed command of the recorded trace
+ * 
+ */
+struct jit_trace_entry_t
+{
+    int command                         = 0;        // Index of the decoded command
+    bool taken                          = false;    // Outcome of the conditional jump
+};
+
+const int NOT_RECORDING                 = -1;   // `head` of the recorder that does not record a trace
+
+/**
+ * @brief Structure that contains the state of the trace recorder (hot loops are found by the interpreter via backward jumps)
+ * 
+ */
+struct jit_recorder_t
+{
+    int *loopCounters                   = NULL;     // Index of the command -> amount of backward jumps to it (negative while backing off)
+    jit_trace_entry_t *trace            = NULL;     // Commands executed since the loop header
+    int length                          = 0;
+    int head                            = NOT_RECORDING;    // Loop header the trace starts with
+};
+
+/**
+ * @brief Function that translates every basic block of the decoded program into native code
+ * 
+ * @param jit 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitCtor(jit_t *jit, const decoded_program_t *program);
+
+/**
+ * @brief Function that prepares the JIT for the traces (they are compiled later by `jitCompileTrace`)
+ * 
+ * @param jit 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitTracesCtor(jit_t *jit, const decoded_program_t *program);
+
+/**
+ * @brief Function that translates the recorded trace into native code (it becomes the entry of its first command)
+ * 
+ * @param jit 
+ * @param program 
+ * @param trace 
+ * @param length 
+ * @param next index of the command executed after the last one of the trace (the first one for a loop)
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitCompileTrace(jit_t *jit, const decoded_program_t *program, const jit_trace_entry_t *trace, int length, int next);
+
+/**
+ * @brief Function that determines whether the command can be translated into native code
+ * 
+ * @param command 
+ * @return bool 
+ */
+bool jitCanCompile(const decoded_command_t *command);
+
+/**
+ * @brief Function that constructs the trace recorder of the program
+ * 
+ * @param recorder 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecorderCtor(jit_recorder_t *recorder, const decoded_program_t *program);
+
+/**
+ * @brief Function that destructs the trace recorder
+ * 
+ * @param recorder 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecorderDtor(jit_recorder_t *recorder);
+
+/**
+ * @brief Function that handles the command executed by the interpreter: counts backward jumps and records the trace of the hot loop
+ * 
+ * @param recorder 
+ * @param jit 
+ * @param program 
+ * @param command index of the executed command
+ * @param ip address of the next command
+ * @param popped the command decreased the stack (outcome of the conditional jump)
+ * @param flags flags register after the command (outcome of the flags jump)
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecordCommand(jit_recorder_t *recorder, const jit_t *jit, const decoded_program_t *program, int command, int ip, bool popped, int flags);
+
+/**
+ * @brief Function that handles the exit from the native code: the hot exit becomes the start of a new trace
+ * 
+ * @param recorder 
+ * @param jit 
+ * @param command index of the command the native code exited to
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecordSideExit(jit_recorder_t *recorder, const jit_t *jit, int command);
+
+/**
+ * @brief Function that finishes the recording: the trace is compiled if the loop is closed or the next command has native code
+ * 
+ * @param jit 
+ * @param recorder 
+ * @param program 
+ * @param next index of the command that is about to be executed
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitFinishTrace(jit_t *jit, jit_recorder_t *recorder, const decoded_program_t *program, int next);
+
+/**
+ * @brief Function that finds the side exit of the faulting RAM access of the native code (NULL if it is not one of them)
+ * 
+ * @param jit 
+ * @param instruction 
+ * @return const void* 
+ */
+const void *jitResolveFault(const jit_t *jit, const void *instruction);
+
+/**
+ * @brief Function that frees the native code and all the tables of the JIT
+ * 
+ * @param jit 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitDtor(jit_t *jit);
+
+
+#endif  // JIT_H
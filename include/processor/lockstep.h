@@ -0,0 +1,136 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+#include "include/processor/processor.h"
+
+#undef DEBUG_LEVEL
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    #define LOCKSTEP_AVX2_SUPPORTED 1   // Lane vectors are AVX2 registers if the host has them (checked at run time)
+#else
+    #define LOCKSTEP_AVX2_SUPPORTED 0
+#endif
+
+/**
+ * @brief An enum class that contains lockstep exit codes
+ * 
+ */
+enum class LOCKSTEP_EXIT_CODES
+{
+    BAD_LANES_COUNT,
+    RAM_IS_TOO_LARGE,
+    ERROR_ALLOCATING_LANES,
+    ERROR_HANDING_OFF_LANE,
+};
+
+/**
+ * @brief An enum class that contains all the states of one lane
+ * 
+ */
+enum class LOCKSTEP_LANE_STATES
+{
+    EMPTY,          // No record (the last group of the batch)
+    RUNNING,
+    DONE,           // `halt` (the exit code is EXIT_SUCCESS)
+    HANDED_OFF,     // The rest of the run is for the scalar engine (see `lockstepHandOff`)
+};
+
+/**
+ * @brief Structure that contains the scalar part of the state of one lane (its values are in the rows of `lockstep_t`)
+ * 
+ */
+struct lockstep_lane_t
+{
+    LOCKSTEP_LANE_STATES state          = LOCKSTEP_LANE_STATES::EMPTY;
+    int ip                              = 0;    // Index of the next decoded command
+    int stackSize                       = 0;
+    int callDepth                       = 0;
+    cpu_input_t input                   = {};   // The record
+    cpu_output_t output                 = {};   // Text of the run (kept in memory)
+};
+
+/**
+ * @brief Structure that contains the statistics of the lockstep execution
+ * 
+ */
+struct lockstep_stats_t
+{
+    unsigned long long steps            = 0;    // Commands executed for the group of lanes at once
+    unsigned long long laneCommands     = 0;    // Commands of all the lanes (sum of the group sizes)
+    unsigned long long divergentSteps   = 0;    // Steps that did not include every running lane
+    int groupsCount                     = 0;
+    int handOffsCount                   = 0;    // Lanes finished by the scalar engine
+};
+
+/**
+ * @brief Structure that represents `lanesCount` virtual CPUs that execute the same program in lockstep
+ * 
+ * Values are kept as rows of lanes (structure of arrays): lane `L` of row `R` is at `[R * lanesCount + L]`,
+ * so one row is one vector register and one command is executed for the whole group of lanes at once
+ * 
+ */
+struct lockstep_t
+{
+    decoded_program_t program           = {};
+    int lanesCount                      = 0;
+    lockstep_lane_t lanes[LOCKSTEP_MAX_LANES] = {};
+    bool avx2                           = false;    // Lane vectors are AVX2 registers
+
+    double *commonRegs                  = NULL;     // MAX_REGS_COUNT + 1 rows (the last one is ZERO_REGISTER)
+    long long *intRegs                  = NULL;     // MAX_INT_REGS_COUNT + 1 rows (the last one is ZERO_INT_REGISTER)
+    long long *flags                    = NULL;     // One row
+    double *stack                       = NULL;
+    int stackCapacity                   = 0;        // Rows of `stack`
+    offset *callStack                   = NULL;
+    int callStackCapacity               = 0;        // Rows of `callStack`
+    int maxCallDepth                    = DEFAULT_MAX_CALL_DEPTH;
+    double *RAM                         = NULL;
+    size_t RAMSize                      = 0;        // Cells of every lane
+
+    lockstep_stats_t stats              = {};
+};
+
+/**
+ * @brief Function that decodes the bytecode and allocates the lanes (settings are taken from `CPU`)
+ * 
+ * @param lockstep 
+ * @param byteCode 
+ * @param CPU 
+ * @param lanesCount 4 or 8
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepCtor(lockstep_t *lockstep, text_t *byteCode, const cpu_t *CPU, int lanesCount);
+
+/**
+ * @brief Function that frees all the memory of the lanes and the decoded program
+ * 
+ * @param lockstep 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepDtor(lockstep_t *lockstep);
+
+/**
+ * @brief Function that runs the group of records (one per lane) in lockstep until every lane is done or handed off
+ * 
+ * @param lockstep 
+ * @param records 
+ * @param recordsCount at most `lanesCount`
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepExecuteGroup(lockstep_t *lockstep, const text_line_t *records, int recordsCount);
+
+/**
+ * @brief Function that moves the state of the handed off lane into the reset `CPU`, `cpuExecuteBytecode` continues the run from it
+ * 
+ * @param lockstep 
+ * @param lane 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepHandOff(lockstep_t *lockstep, int lane, cpu_t *CPU);
+
+
+#endif  // LOCKSTEP_H
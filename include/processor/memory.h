@@ -0,0 +1,272 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>  // for size_t
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "include/processor/settings.h"
+
+#undef DEBUG_LEVEL
+
+// RAM is mapped with guard regions (faults are trapped) on x86-64 Linux only (other hosts use `calloc` and the bounds checks)
+#if defined(__x86_64__) && defined(__linux__)
+    #define RAM_GUARD_SUPPORTED 1
+#else
+    #define RAM_GUARD_SUPPORTED 0
+#endif
+
+/**
+ * @brief An enum class that contains RAM exit codes
+ * 
+ */
+enum class MEMORY_EXIT_CODES
+{
+    ERROR_RESERVING_RAM,
+    ERROR_MAPPING_RAM,
+    ERROR_SETTING_TRAP_HANDLER,
+    ERROR_ALLOCATING_PAGE,
+};
+
+/**
+ * @brief An enum class that contains all the kinds of the processor RAM
+ * 
+ */
+enum class RAM_BACKENDS
+{
+    FLAT,       // One array of cells (see `ramCtor`)
+    PAGED,      // Pages are allocated on the first access and found via the page table (see `ramPagedCtor`)
+};
+
+const size_t RAM_NO_PAGE                = (size_t) -1;  // Tag of the empty TLB entry
+
+/**
+ * @brief Structure that represents the entry of the direct-mapped TLB of the paged RAM (layout is used by the native code)
+ * 
+ */
+struct ram_tlb_entry_t
+{
+    size_t page                         = RAM_NO_PAGE;  // Index of the cell >> RAM_PAGE_BITS
+    double *cells                       = NULL;
+};
+
+/**
+ * @brief Structure that represents the RAM of the processor (flat cells are followed by the guard region)
+ * 
+ */
+struct ram_t
+{
+    double *cells                       = NULL;     // NULL for the paged RAM
+    size_t size                         = 0;        // Amount of cells
+    bool guarded                        = false;    // Any 32-bit unsigned index past the cells faults (see `RAM_GUARD_SIZE`)
+    bool hugePages                      = false;    // Cells are backed by huge pages (explicit or transparent)
+
+    void *mapping                       = NULL;     // Whole reservation (with the guard regions)
+    size_t mappingSize                  = 0;
+
+    void **directory                    = NULL;     // Root of the page table (paged RAM only)
+    ram_tlb_entry_t *tlb                = NULL;     // RAM_TLB_SIZE entries, the page is cached in the entry `page % RAM_TLB_SIZE`
+    size_t pagesCount                   = 0;        // Amount of allocated pages
+};
+
+/**
+ * @brief Function that maps zeroed RAM of `size` cells (pages are allocated on the first touch)
+ * 
+ * @param ram 
+ * @param size amount of cells
+ * @param hugePages back the cells with huge pages if possible
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramCtor(ram_t *ram, size_t size, bool hugePages);
+
+/**
+ * @brief Function that allocates zeroed RAM of `size` cells on the heap (no guard regions, the bounds are checked)
+ * 
+ * @param ram 
+ * @param size amount of cells
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramHeapCtor(ram_t *ram, size_t size);
+
+/**
+ * @brief Function that constructs the paged RAM of `size` cells (the page table and the TLB are empty)
+ * 
+ * @param ram 
+ * @param size amount of cells (up to PAGED_RAM_SIZE)
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramPagedCtor(ram_t *ram, size_t size);
+
+/**
+ * @brief Function that frees the RAM (both flat and paged)
+ * 
+ * @param ram 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramDtor(ram_t *ram);
+
+/**
+ * @brief Function that zeroes every cell of the RAM (both flat and paged), the pages and the TLB stay as they are
+ * 
+ * @param ram 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramClear(ram_t *ram);
+
+/**
+ * @brief Function that finds the page in the page table (it is allocated on the first access) and caches it in the TLB
+ * 
+ * @param ram 
+ * @param page index of the cell >> RAM_PAGE_BITS
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramFillTlb(ram_t *ram, size_t page);
+
+/**
+ * @brief Function that returns the cell of the RAM (NULL if its page can not be allocated), `index` must be less than `size`
+ * 
+ * @param ram 
+ * @param index 
+ * @return double* 
+ */
+inline double *ramCell(ram_t *ram, size_t index)
+{
+    if (ram->cells != NULL)
+    {
+        return &ram->cells[index];
+    }
+
+    size_t page = index >> RAM_PAGE_BITS;
+    ram_tlb_entry_t *entry = &ram->tlb[page & (RAM_TLB_SIZE - 1)];
+    if (entry->page != page && ramFillTlb(ram, page) != EXIT_CODES::NO_ERRORS)
+    {
+        return NULL;
+    }
+
+    return &entry->cells[index & (RAM_PAGE_SIZE - 1)];
+}
+
+/**
+ * @brief Function that reads the cell (relaxed atomic load: the RAM may be shared by the cores, the host load is the same `mov`)
+ * 
+ * @param cell 
+ * @return double 
+ */
+inline double ramLoad(const double *cell)
+{
+    double value = 0;
+    __atomic_load(cell, &value, __ATOMIC_RELAXED);
+
+    return value;
+}
+
+/**
+ * @brief Function that writes the cell (relaxed atomic store: the RAM may be shared by the cores, the host store is the same `mov`)
+ * 
+ * @param cell 
+ * @param value 
+ */
+inline void ramStore(double *cell, double value)
+{
+    __atomic_store(cell, &value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Function that atomically writes `value` into the cell (`xchg` command)
+ * 
+ * @param cell 
+ * @param value 
+ * @return double value the cell had
+ */
+inline double ramAtomicExchange(double *cell, double value)
+{
+    double old = 0;
+    __atomic_exchange(cell, &value, &old, __ATOMIC_SEQ_CST);
+
+    return old;
+}
+
+/**
+ * @brief Function that atomically adds `value` to the cell (`xadd` command, the host has no floating-point fetch-and-add, so it is the CAS loop)
+ * 
+ * @param cell 
+ * @param value 
+ * @return double value the cell had
+ */
+inline double ramAtomicAdd(double *cell, double value)
+{
+    double old = 0;
+    __atomic_load(cell, &old, __ATOMIC_RELAXED);
+
+    double sum = old + value;
+    while (!__atomic_compare_exchange(cell, &old, &sum, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    {
+        sum = old + value;
+    }
+
+    return old;
+}
+
+/**
+ * @brief Function that atomically replaces the cell with `value` if it is equal to `*expected` (`cas` command)
+ * 
+ * Values are compared as numbers (0 is equal to -0, NaN is equal to nothing), not as bits the way the host CAS does
+ * 
+ * @param cell 
+ * @param expected the value the cell had is written here
+ * @param value 
+ * @return true the cell is replaced
+ */
+inline bool ramAtomicCompareExchange(double *cell, double *expected, double value)
+{
+    double old = 0;
+    __atomic_load(cell, &old, __ATOMIC_ACQUIRE);
+
+    bool isEqual = old >= *expected && old <= *expected;
+    while (isEqual && !__atomic_compare_exchange(cell, &old, &value, true, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+    {
+        isEqual = old >= *expected && old <= *expected;
+    }
+
+    *expected = old;
+    return isEqual;
+}
+
+/**
+ * @brief Function type that returns the code to continue with after the faulting instruction (NULL if the fault is not expected)
+ * 
+ */
+typedef const void *(*ram_fault_resolver_t)(const void *instruction, void *context);
+
+#if RAM_GUARD_SUPPORTED
+
+/**
+ * @brief Function that makes the faults of the calling thread inside of the RAM reservation continue with the code given by `resolver` (other faults crash as before)
+ * 
+ * @param ram 
+ * @param resolver 
+ * @param context user data for the resolver
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramTrapCtor(const ram_t *ram, ram_fault_resolver_t resolver, void *context);
+
+/**
+ * @brief Function that removes the trap of the calling thread (the previous handlers of the faults are restored by the last one)
+ * 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramTrapDtor();
+
+#endif
+
+/**
+ * @brief Function that parses the size of the RAM in bytes with an optional `K`, `M` or `G` suffix
+ * 
+ * @param string 
+ * @param size amount of cells
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramParseSize(const char *string, size_t *size);
+
+
+#endif  // MEMORY_H
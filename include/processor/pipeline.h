@@ -0,0 +1,67 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <thread>               // for std::thread
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+#include "include/processor/processor.h"
+#include "include/processor/ring.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains pipeline exit codes
+ * 
+ */
+enum class PIPELINE_EXIT_CODES
+{
+    BAD_STAGES_COUNT,
+    ERROR_ALLOCATING_STAGES,
+    STAGE_BYTECODE_IS_NOT_VERIFIED,
+    ERROR_CONSTRUCTING_STAGE_CPU,
+    ERROR_STARTING_STAGE,
+};
+
+/**
+ * @brief Structure that represents one program of the pipeline and the host thread it runs on
+ * 
+ */
+struct pipeline_stage_t
+{
+    const char *fileName                = NULL;
+    text_t *byteCode                    = NULL;     // `stageByteCode` (bytecode of `main` for the first stage)
+    cpu_t *CPU                          = NULL;     // `stageCPU` (processor of `main` for the first stage)
+    text_t stageByteCode                = {};
+    cpu_t stageCPU                      = {};       // Own RAM, stack and registers, settings are the ones of the first stage
+    std::thread thread                  = {};
+    double seconds                      = 0;        // Wall time of the run
+};
+
+/**
+ * @brief Structure that represents the programs connected by the rings: `out` of every stage is `in` of the next one
+ * 
+ */
+struct pipeline_t
+{
+    pipeline_stage_t *stages            = NULL;
+    int stagesCount                     = 0;
+    ring_t *rings                       = NULL;     // Ring `index` connects the stage `index` to the stage `index + 1`
+};
+
+/**
+ * @brief Function that executes the programs as one pipeline: the first one reads the input, the last one writes the output
+ * 
+ * @param byteCode bytecode of the first stage
+ * @param CPU processor of the first stage (its settings are used for all the stages)
+ * @param fileName bytecode file of the first stage
+ * @param pipeFileNames bytecode files of the next stages
+ * @param pipeFilesCount 
+ * @param exitCode EXIT_SUCCESS if every stage halted without a runtime error
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecutePipeline(text_t *byteCode, cpu_t *CPU, const char *fileName, char **pipeFileNames, int pipeFilesCount, int *exitCode);
+
+
+#endif  // PIPELINE_H
@@ -1,17 +1,30 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include <time.h>    // for clock_t
+#include <setjmp.h>  // for jmp_buf
+
 #define DEBUG_LEVEL 2
 #include "libs/debug/debug.h"
 #include "libs/stack/include/stack.h"
 #include "libs/text/include/text.h"
 #include "include/regdefs.h"
+#include "include/processor/decoder.h"
+#include "include/processor/jit.h"
+#include "include/processor/memory.h"
+#include "include/processor/io.h"
+#include "include/processor/settings.h"
 
 #undef DEBUG_LEVEL
 
 typedef unsigned char byte;
 typedef unsigned int offset;
 
+struct smp_t;   // Machine of the virtual cores (see `include/processor/smp.h`)
+
+typedef checked_stack_t<STACK_CHECKS::NONE>         cpu_stack_t;            // Processor stack without integrity checks (default)
+typedef checked_stack_t<STACK_CHECKS::FULL_HASH>    cpu_paranoid_stack_t;   // Processor stack with all the checks (`--paranoid` mode)
+
 /**
  * @brief An enum class that contains processor exit codes
  * 
@@ -39,6 +52,69 @@ enum class PROCESSOR_EXIT_CODES
     ERROR_DURING_JUMP,
     ERROR_DURING_TAKING_SQUARE_ROOT,
     FAIL_DURING_TAKING_OFFSET,
+    UNKNOWN_EXECUTION_ENGINE,
+    INVALID_DECODED_COMMAND,
+    ERROR_DECODING_BYTECODE,
+    BAD_REGISTER_CODE,
+    OPERAND_IS_OUT_OF_BYTECODE,
+    ERROR_VERIFYING_BYTECODE,
+    BYTECODE_IS_NOT_VERIFIED,
+    CALL_STACK_OVERFLOW,
+    CALL_STACK_UNDERFLOW,
+    INTEGER_DIVISION_BY_ZERO,
+    VALUE_DOES_NOT_FIT_INTEGER_REGISTER,
+    BAD_CORE_TO_JOIN,
+    ERROR_GROWING_CALL_STACK,
+    STACK_UNDERFLOW,
+};
+
+/**
+ * @brief An enum class that contains all the execution engines of the processor
+ * 
+ */
+enum class CPU_ENGINES
+{
+    SWITCH,     // `switch` over the opcode byte for every command (reference engine)
+    THREADED,   // Direct-threaded dispatch via computed `goto` (GNU labels-as-values) over the predecoded commands
+    JIT,        // Basic blocks translated into x86-64 native code (commands without native code are interpreted)
+    TRACING,    // Interpreter that records hot loops and translates their traces into x86-64 native code
+};
+
+/**
+ * @brief An enum class that contains all the states the run of the processor stops in (see `cpu_status_t`)
+ * 
+ */
+enum class CPU_STATES
+{
+    HALTED,                 // `halt` or the end of the bytecode (the exit code of the program is `exitCode`)
+    TRAPPED,                // Runtime error (`trap` is its reason, `ip` is the command it happened at)
+    BUDGET_IS_EXHAUSTED,    // Metered run or the slice is paused at `ip`, it goes on from there when it is executed again
+    WAITING_FOR_INPUT,      // `in` of the green thread at `ip` found no value, it is executed again by the next slice
+};
+
+/**
+ * @brief Structure that represents how the last run of the processor stopped (the processor is never left via `exit`)
+ * 
+ */
+struct cpu_status_t
+{
+    CPU_STATES state                    = CPU_STATES::HALTED;
+    int exitCode                        = EXIT_SUCCESS;  // Operand of `halt` (EXIT_SUCCESS for the end of the bytecode)
+    PROCESSOR_EXIT_CODES trap           = PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE;  // Reason of the runtime error
+    int ip                              = 0;     // Bytecode offset of the command the run stopped at (trapped or paused runs)
+};
+
+/**
+ * @brief Structure that contains the execution statistics of the processor
+ * 
+ */
+struct cpu_stats_t
+{
+    bool enabled                        = false;
+    unsigned long long commands         = 0;    // Total amount of executed commands
+    unsigned long long fusedCommands    = 0;    // Amount of executed commands that did not need their own dispatch (superinstructions)
+    unsigned long long nativeCommands   = 0;    // Amount of commands executed by the native code (JIT and TRACING engines)
+    clock_t startTime                   = 0;
 };
 
 /**
@@ -47,11 +123,55 @@ enum class PROCESSOR_EXIT_CODES
  */
 struct cpu_t
 {
-    stack_t stack                       = {};
-    double *RAM                         = NULL;
+    cpu_stack_t stack                   = {};
+    cpu_paranoid_stack_t paranoidStack  = {};   // Used instead of `stack` in paranoid mode
+    double *RAM                         = NULL;  // Cells of `memory` (NULL for the paged RAM, see `ramCell`)
+    size_t RAMSize                      = DEFAULT_RAM_SIZE;
+    RAM_BACKENDS RAMBackend             = RAM_BACKENDS::FLAT;
+    bool hugePages                      = false;
+    ram_t memory                        = {};
     byte *VRAM                          = {};
-    double commonRegs[MAX_REGS_COUNT]   = {};  // Index is common register opcode, value - its value
+    cpu_output_t output                 = {};  // Buffered text of `out` and `outc` (flushed on halt, on error exit and when it is full)
+    bool captureOutput                  = false; // `output` keeps the text in memory instead of stdout (see `outputTake`)
+    OUTPUT_FORMATS outputFormat         = OUTPUT_FORMATS::LF;
+    cpu_input_t input                   = {};  // Values of `in` (stdin is read by blocks or mapped)
+    INPUT_FORMATS inputFormat           = INPUT_FORMATS::TEXT;
+    double commonRegs[MAX_REGS_COUNT + 1] = {};  // Index is common register opcode, value - its value (last one is ZERO_REGISTER)
+    long long intRegs[MAX_INT_REGS_COUNT + 1] = {};  // Integer registers (`r0`..`r7`, last one is ZERO_INT_REGISTER)
+    int flags                           = 0;   // Result of the last `fcmp` (EQUAL_FLAG, LOWER_FLAG, GREATER_FLAG) or `in` (END_OF_INPUT_FLAG, BAD_INPUT_FLAG)
     int ip                              = 0;
+
+    offset *callStack                   = NULL;  // Return addresses of `call` (separate from the operand stack)
+    int callStackCapacity               = 0;     // Entries of `callStack` (`maxCallDepth` unless the green thread grows it)
+    int callDepth                       = 0;
+    int maxCallDepth                    = DEFAULT_MAX_CALL_DEPTH;
+
+    decoded_program_t program           = {};  // Predecoded bytecode (used by THREADED and JIT engines)
+    jit_t jit                           = {};  // Native code of the program (JIT and TRACING engines)
+    bool ownsProgram                    = true;  // `program` and `jit` are freed by `cpuDtor` (the batch workers share them read-only)
+    jit_state_t jitState                = {};  // Operand stack and registers shared with the native code (JIT and TRACING engines)
+    jit_recorder_t recorder             = {};  // Hot loop detection and trace recording (TRACING engine)
+
+    CPU_ENGINES engine                  = CPU_ENGINES::SWITCH;
+    bool paranoid                       = false; // Check integrity of the processor stack on every operation (canaries + full checksum)
+    bool verify                         = true;  // Verify the bytecode before the execution
+    bool verified                       = false; // Bytecode passed the verifier (THREADED engine skips the checks it proved)
+    bool fusion                         = true;  // Replace command sequences with superinstructions (THREADED engine)
+    bool tosCaching                     = true;  // Keep top of the stack values in host registers (THREADED engine)
+    cpu_stats_t stats                   = {};
+
+    smp_t *smp                          = NULL;  // Machine the core belongs to (NULL for the single core, see `cpuExecuteSmp`)
+    int coreId                          = 0;     // Index of the core in the machine (0 is the core that boots it)
+    bool ownsMemory                     = true;  // `memory` is freed by `cpuDtor` (the cores of the machine share the RAM of the first one)
+
+    jmp_buf *exitPoint                  = NULL;  // `halt` and the runtime errors return here (set by `cpuExecuteBytecode` for the run)
+    cpu_status_t status                 = {};    // How the last run stopped (see `cpuGetExitCode`)
+
+    bool isGreen                        = false; // Green thread: small buffers, RAM on the heap, `in` waits for `inputAppend` (see `cpuExecuteGreen`)
+    bool isWaitingForInput              = false; // `in` of the green thread found no value, it is executed again by the next slice
+
+    unsigned long long budget           = 0;     // Commands of every run, charged per block (`--budget`, 0 if the runs are not metered)
+    unsigned long long budgetLeft       = 0;     // Commands the metered run may still execute (it is added to before the paused run is resumed)
 };
 
 /**
@@ -80,7 +200,24 @@ EXIT_CODES cpuDtor(cpu_t *CPU);
 EXIT_CODES cpuDump(cpu_t *CPU, text_t *byteCode);
 
 /**
- * @brief Main function that executes bytecode file
+ * @brief Function that prints the execution statistics (executed commands, CPU time, MIPS) of an virtual CPU
+ * 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuPrintStats(cpu_t *CPU);
+
+/**
+ * @brief Function that decodes the bytecode for the engine of the virtual CPU (and translates it into native code) unless it is done already
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuLoadProgram(text_t *byteCode, cpu_t *CPU);
+
+/**
+ * @brief Main function that executes bytecode file from `ip` until the run stops, `halt` and the runtime errors stop the run only (see `status`)
  * 
  * @param byteCode 
  * @param CPU 
@@ -88,5 +225,30 @@ EXIT_CODES cpuDump(cpu_t *CPU, text_t *byteCode);
  */
 EXIT_CODES cpuExecuteBytecode(text_t *byteCode, cpu_t *CPU);
 
+/**
+ * @brief Function that maps the status of the last run to the exit code of the process (and of the record of the batch)
+ * 
+ * @param CPU 
+ * @return int 
+ */
+int cpuGetExitCode(const cpu_t *CPU);
+
+/**
+ * @brief Function that resets the virtual CPU to the state of a new one in place (the decoded program and the native code are kept)
+ * 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuReset(cpu_t *CPU);
+
+/**
+ * @brief Function that executes at most `quantum` commands of the bytecode from `ip` (`switch` engine), the next slice goes on from there
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param quantum 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteSlice(text_t *byteCode, cpu_t *CPU, unsigned long long quantum);
 
 #endif  // PROCESSOR_H
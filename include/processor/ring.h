@@ -0,0 +1,179 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stddef.h>             // for size_t
+#include <atomic>               // for std::atomic
+#include <mutex>                // for std::mutex
+#include <condition_variable>   // for std::condition_variable
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "include/processor/settings.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains ring exit codes
+ * 
+ */
+enum class RING_EXIT_CODES
+{
+    ERROR_ALLOCATING_RING,
+};
+
+/**
+ * @brief Structure that represents the single-producer single-consumer ring of doubles between two threads
+ * 
+ * Values are passed without locks: each side writes its own index and caches the index of the other one. The mutex is taken
+ * only to park the side that can not go on (the full ring for the producer, the empty one for the consumer) and to wake it up
+ * 
+ */
+struct ring_t
+{
+    // Producer side
+    alignas(RING_CACHE_LINE_SIZE)
+    std::atomic<size_t> tail            { 0 };      // Values ever pushed
+    size_t cachedHead                   = 0;        // `head` the producer saw last
+    unsigned long long fullWaitsCount   = 0;        // Times the producer was parked
+
+    // Consumer side
+    alignas(RING_CACHE_LINE_SIZE)
+    std::atomic<size_t> head            { 0 };      // Values ever popped
+    size_t cachedTail                   = 0;        // `tail` the consumer saw last
+    unsigned long long emptyWaitsCount  = 0;        // Times the consumer was parked
+
+    // Shared (rarely written)
+    alignas(RING_CACHE_LINE_SIZE)
+    double *values                      = NULL;
+    size_t capacity                     = 0;        // Power of 2
+    std::atomic<bool> isProducerParked  { false };
+    std::atomic<bool> isConsumerParked  { false };
+    std::atomic<bool> isClosed          { false };  // The producer pushes nothing more (the rest is popped, then the ring is empty)
+    std::atomic<bool> isAbandoned       { false };  // The consumer pops nothing more (pushed values are dropped)
+    std::mutex lock                     = {};
+    std::condition_variable isChanged   = {};
+};
+
+/**
+ * @brief Function that allocates the ring of at least `capacity` values (it is rounded up to a power of 2)
+ * 
+ * @param ring 
+ * @param capacity 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ringCtor(ring_t *ring, size_t capacity);
+
+/**
+ * @brief Function that frees the values of the ring (neither side may use it anymore)
+ * 
+ * @param ring 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ringDtor(ring_t *ring);
+
+/**
+ * @brief Function that marks the end of the values (producer side) and wakes the consumer up
+ * 
+ * @param ring 
+ */
+void ringClose(ring_t *ring);
+
+/**
+ * @brief Function that makes the producer drop the values (consumer side) and wakes it up
+ * 
+ * @param ring 
+ */
+void ringAbandon(ring_t *ring);
+
+/**
+ * @brief Function that wakes up the parked side of the ring
+ * 
+ * @param ring 
+ */
+void ringWake(ring_t *ring);
+
+/**
+ * @brief Function that waits until the full ring has room (producer side), the parked producer waits for half of the ring
+ * 
+ * @param ring 
+ * @return true the value may be pushed
+ * @return false the ring is abandoned
+ */
+bool ringWaitForRoom(ring_t *ring);
+
+/**
+ * @brief Function that waits until the empty ring has a value (consumer side)
+ * 
+ * @param ring 
+ * @return true the value may be popped
+ * @return false the ring is closed and empty
+ */
+bool ringWaitForValue(ring_t *ring);
+
+/**
+ * @brief Function that pushes the value (producer side), it waits while the ring is full
+ * 
+ * Indices are written in the same total order as the parking flags are read, so the side that is going to park either
+ * sees the new index or is seen parked and woken up
+ * 
+ * @param ring 
+ * @param value 
+ * @return true the value is pushed
+ * @return false the value is dropped (the ring is abandoned)
+ */
+inline bool ringPush(ring_t *ring, double value)
+{
+    size_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (tail - ring->cachedHead == ring->capacity)
+    {
+        ring->cachedHead = ring->head.load(std::memory_order_seq_cst);
+        if (tail - ring->cachedHead == ring->capacity && !ringWaitForRoom(ring))
+        {
+            return false;
+        }
+    }
+
+    ring->values[tail & (ring->capacity - 1)] = value;
+    ring->tail.store(tail + 1, std::memory_order_seq_cst);
+    if (ring->isConsumerParked.load(std::memory_order_seq_cst))
+    {
+        ringWake(ring);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Function that pops the value (consumer side), it waits while the ring is empty
+ * 
+ * @param ring 
+ * @param value 
+ * @return true the value is popped
+ * @return false the ring is closed and empty
+ */
+inline bool ringPop(ring_t *ring, double *value)
+{
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    if (head == ring->cachedTail)
+    {
+        ring->cachedTail = ring->tail.load(std::memory_order_seq_cst);
+        if (head == ring->cachedTail && !ringWaitForValue(ring))
+        {
+            return false;
+        }
+    }
+
+    // Parked producer does not push until half of the ring is free (it is not woken up for every value)
+    *value = ring->values[head & (ring->capacity - 1)];
+    ring->head.store(head + 1, std::memory_order_seq_cst);
+    if (ring->isProducerParked.load(std::memory_order_seq_cst) &&
+        ring->tail.load(std::memory_order_relaxed) - (head + 1) <= ring->capacity / 2)
+    {
+        ringWake(ring);
+    }
+
+    return true;
+}
+
+
+#endif  // RING_H
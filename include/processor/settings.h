@@ -8,15 +8,70 @@
 #define MRI_IS_MEMORY(byteCodeByte)     (byteCodeByte & 0b100) != 0
 #define GET_TOTAL_ARGS(byteCodeByte)    (byteCodeByte & 0b11100000) >> 5
 #define GET_GLOBAL_MRI(byteCodeByte)    (byteCodeByte & 0b00011100) >> 2
+#define IS_VALID_RAM_INDEX(index, size) ((index) > -1 && (index) < (double) (size) && fabs((index) - fabs((double) (long long) (index))) < EPS)
+#define WRAPPED(first, op, second)      ((long long) ((unsigned long long) (first) op (unsigned long long) (second)))  // Two's complement
+#define FITS_INT_REGISTER(value)        ((value) >= -INT_REGISTER_LIMIT && (value) < INT_REGISTER_LIMIT)   // False for NaN
+#define IS_INTEGRAL(value)              (FITS_INT_REGISTER(value) && (double) (long long) (value) <= (value) && (double) (long long) (value) >= (value))
 
-const int MAX_RAM_SIZE                  = 500;      
+const size_t DEFAULT_RAM_SIZE           = 500;      // Cells of the RAM (see `--ram`)
+const size_t RAM_GUARD_SIZE             = ((size_t) 1 << 32) * sizeof(double);  // Guard region after the cells (any 32-bit unsigned index faults)
+const size_t HUGE_PAGE_SIZE             = (size_t) 1 << 21;
+const size_t RAM_CLEAR_BY_MEMSET_SIZE   = (size_t) 1 << 16;  // Larger mapped RAM is cleared by giving its pages back (see `ramClear`)
+const int RAM_PAGE_BITS                 = 9;        // Cells of the paged RAM page (as a power of 2)
+const int RAM_LEVEL_BITS                = 11;       // Entries of one page table (as a power of 2)
+const int RAM_LEVELS                    = 4;        // Depth of the page table (pages cover every integer that is exact in double)
+const size_t RAM_PAGE_SIZE              = (size_t) 1 << RAM_PAGE_BITS;
+const size_t PAGED_RAM_SIZE             = (size_t) 1 << (RAM_PAGE_BITS + RAM_LEVEL_BITS * RAM_LEVELS);  // Cells of the paged RAM by default
+const int RAM_TLB_SIZE                  = 256;      // Entries of the direct-mapped TLB of the paged RAM (power of 2)
 const int DEFAULT_DOUBLE_VALUE          = 0;
 const double BAD_DOUBLE_VALUE           = -663;
 const int RAM_CELLS_TO_DUMP             = 15;
 const double EPS                        = 0.001;
+const double INT_REGISTER_LIMIT         = 9223372036854775808.0;    // 2^63: doubles in [-2^63, 2^63) are truncated into integer registers
 const double DOUBLES_ARE_EQUAL          = 0;
 const double FIRST_DOUBLE_IS_GREATER    = 1;
 const double FIRST_DOUBLE_IS_LOWER      = -1;
+const int EQUAL_FLAG                    = 1 << 0;   // Bits of the flags register set by `fcmp` (none of them if one of the operands is NaN)
+const int LOWER_FLAG                    = 1 << 1;
+const int GREATER_FLAG                  = 1 << 2;
+const int END_OF_INPUT_FLAG             = 1 << 3;   // Bits of the flags register set by `in` that did not read a value (see `fjeof`)
+const int BAD_INPUT_FLAG                = 1 << 4;
+const int DEFAULT_MAX_CALL_DEPTH        = 1 << 16;  // Capacity of the call stack (see `--max-call-depth`)
+const int JIT_STACK_RESERVE             = 1024;     // Free slots of the native operand stack on every entry to the native code
+const int JIT_HOT_LOOP_THRESHOLD        = 64;       // Backward jumps to the loop header before its trace is recorded
+const int JIT_MAX_TRACE_LENGTH          = 1024;     // Longer traces are not compiled
+const int JIT_TRACE_BACKOFF             = 1024;     // Backward jumps to skip after the failed recording
+const int JIT_TRACE_BUFFER_SIZE         = 1 << 22;  // Size of the native code buffer for all the traces
+const size_t OUTPUT_BUFFER_SIZE         = 1 << 16;  // Bytes of `out`/`outc` text buffered before the write
+const size_t OUTPUT_MAX_DOUBLE_LENGTH   = 352;      // Longest text of one double (`%lf` of DBL_MAX is 316 characters)
+const int OUTPUT_LF_DIGITS              = 6;        // Digits after the point of `%lf`
+const unsigned long long OUTPUT_LF_SCALE = 1000000; // 10^OUTPUT_LF_DIGITS
+const size_t INPUT_BUFFER_SIZE          = 1 << 16;  // Bytes of the input read at once (regular files are mapped instead)
+const size_t INPUT_MAX_WORD_LENGTH      = 512;      // Longer words of the text input are bad values
+#define BATCH_DELIMITER_FORMAT          "--- record %d: exit code %d ---\n"  // Line after the output of every run of the batch (index from 1)
+const int BATCH_DELIMITER_LENGTH        = 64;
+const int BATCH_CACHE_LINE_SIZE         = 64;       // Deques of the batch workers are not shared by one cache line
+const int MAX_BATCH_THREADS             = 1024;     // Worker threads of the batch (see `--threads`)
+const int LOCKSTEP_MAX_LANES            = 8;        // Records of the batch executed at once (see `--lanes`, 4 lanes are one AVX2 register)
+const int LOCKSTEP_MAX_DIVERGENT_STEPS  = 1024;     // Steps in a row without some of the running lanes before the smaller part is handed off
+const size_t LOCKSTEP_MAX_RAM_SIZE      = (size_t) 1 << 16;  // Cells of the RAM of one lane (it is cleared for every group of records)
+const int LOCKSTEP_STACK_ROWS           = 256;      // Initial capacity of the stack of the lanes (it grows twice when it is full)
+const int MAX_SMP_CORES                 = 256;      // Virtual cores of the machine (see `--cores`)
+const double SMP_NO_CORE                = -1;       // Result of `spawn` if every core is busy (and of `join` of the core that is not spawned)
+const int MAX_PIPELINE_STAGES           = 64;       // Programs of the pipeline (see `--pipe`)
+const size_t PIPELINE_RING_SIZE         = 1 << 12;  // Values between two stages of the pipeline (the producer is parked when they are not popped)
+const int RING_CACHE_LINE_SIZE          = 64;       // Indices of the producer and of the consumer are not shared by one cache line
+const int RING_SPIN_COUNT               = 64;       // Yields of the thread that waits for the other side of the ring before it is parked
+const int MAX_GREEN_THREADS             = 1 << 20;  // Instances of the program on one host thread (see `--green`)
+const unsigned long long GREEN_QUANTUM  = 10000;    // Commands of the green thread before the next one runs (see `--quantum`)
+const size_t GREEN_OUTPUT_BUFFER_SIZE   = OUTPUT_MAX_DOUBLE_LENGTH;  // Initial capacity of the kept output of the green thread (it grows twice)
+const size_t GREEN_INPUT_BUFFER_SIZE    = 64;       // Initial capacity of the appended input of the green thread (it grows twice)
+const int GREEN_CALL_STACK_SIZE         = 16;       // Initial capacity of the call stack of the green thread (it grows twice up to `--max-call-depth`)
+const size_t GREEN_READ_SIZE            = 1 << 16;  // Bytes of stdin read at once by the scheduler of the green threads
+#define GREEN_DELIMITER_FORMAT          "--- instance %d: exit code %d ---\n"  // Line after the output of every green thread (index from 0)
+const int GREEN_DELIMITER_LENGTH        = 64;
+const int GREEN_NO_THREAD               = -1;       // End of the ready queue of the green threads
+const int BUDGET_EXHAUSTED_EXIT_CODE    = 2;        // Exit code of the run that is paused by `--budget` (and of the record of the batch)
 // -----------------------------------------------------------------------------------------
 
 // --------------------------------------GPU CONSTANTS--------------------------------------
@@ -0,0 +1,99 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include <thread>               // for std::thread
+#include <mutex>                // for std::mutex
+#include <condition_variable>   // for std::condition_variable
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+#include "include/processor/processor.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains SMP exit codes
+ * 
+ */
+enum class SMP_EXIT_CODES
+{
+    BAD_CORES_COUNT,
+    ERROR_ALLOCATING_CORES,
+    ERROR_CONSTRUCTING_CORE_CPU,
+    ERROR_STARTING_CORE,
+};
+
+/**
+ * @brief An enum class that contains all the states of one virtual core
+ * 
+ */
+enum class SMP_CORE_STATES
+{
+    IDLE,       // Free for `spawn` (it is not started yet or it is joined)
+    RUNNING,
+    HALTED,     // `halt` or a runtime error, waits for `join`
+};
+
+/**
+ * @brief Structure that represents one virtual core of the machine (but the first one) and the host thread it runs on
+ * 
+ */
+struct smp_core_t
+{
+    cpu_t CPU                           = {};       // Own stack, registers and flags, the RAM and the decoded program are shared
+    std::thread thread                  = {};       // Started by the first `spawn` of the core, it waits for the next one after `halt`
+    std::condition_variable isSpawned   = {};
+    SMP_CORE_STATES state               = SMP_CORE_STATES::IDLE;    // Guarded by `smp_t::lock`
+    bool isStarting                     = false;    // `spawn` prepared the core for its thread (guarded by `smp_t::lock`)
+    int runsCount                       = 0;        // Spawns of the core
+};
+
+/**
+ * @brief Structure that represents the machine of `coresCount` virtual cores sharing the RAM of the first one
+ * 
+ */
+struct smp_t
+{
+    text_t *byteCode                    = NULL;
+    smp_core_t *cores                   = NULL;     // Cores 1..coresCount - 1 (core 0 is the processor that boots the machine)
+    int coresCount                      = 0;
+
+    std::mutex lock                     = {};
+    std::condition_variable coreIsHalted = {};
+    int runningCoresCount               = 0;        // Spawned cores that did not halt yet (guarded by `lock`)
+    int failedRunsCount                 = 0;        // Runs of the spawned cores that did not exit with EXIT_SUCCESS (guarded by `lock`)
+    bool isShutDown                     = false;    // Threads of the cores exit instead of waiting for `spawn` (guarded by `lock`)
+};
+
+/**
+ * @brief Function that executes the bytecode on the machine of `coresCount` virtual cores, the first one starts at the beginning of the program
+ * 
+ * @param byteCode 
+ * @param CPU core 0 (its settings are used for all the cores, its RAM is shared by them)
+ * @param coresCount 
+ * @param exitCode EXIT_SUCCESS if every core halted without a runtime error
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteSmp(text_t *byteCode, cpu_t *CPU, int coresCount, int *exitCode);
+
+/**
+ * @brief Function that starts the free core at `address` with a copy of the registers of `CPU` (`spawn` command)
+ * 
+ * @param CPU 
+ * @param address bytecode offset of the first command of the core
+ * @return double index of the core, SMP_NO_CORE if every core is busy (or the processor is not a part of the machine)
+ */
+double smpSpawn(cpu_t *CPU, offset address);
+
+/**
+ * @brief Function that waits for the spawned core to halt and frees it (`join` command)
+ * 
+ * @param CPU 
+ * @param core index of the core
+ * @return double exit code of the core, SMP_NO_CORE if it is not spawned (or it is `CPU` itself)
+ */
+double smpJoin(cpu_t *CPU, double core);
+
+
+#endif  // SMP_H
@@ -0,0 +1,39 @@
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#define DEBUG_LEVEL 2
+#include "libs/debug/debug.h"
+#include "libs/text/include/text.h"
+
+#undef DEBUG_LEVEL
+
+/**
+ * @brief An enum class that contains all the kinds of bytecode violations found by the verifier
+ * 
+ */
+enum class VERIFIER_VIOLATIONS
+{
+    INVALID_OPCODE,                 // Opcode byte is not defined in `opdefs.h` (the rest of the bytecode is not checked)
+    OPERAND_OUT_OF_CODE,            // Operand of the command does not fit inside the bytecode
+    BAD_OPERAND_TYPE,               // Argument is neither register nor immediate (the rest of the bytecode is not checked)
+    BAD_REGISTER_CODE,              // Register code is not less than MAX_REGS_COUNT
+    JUMP_TARGET_IS_NOT_COMMAND,     // Label operand does not point to the command boundary (or the end of the bytecode)
+    RAM_ADDRESS_OUT_OF_RANGE,       // Constant memory operand is not an integer inside of [0, RAMSize)
+    POP_INTO_IMMEDIATE,             // `pop` operand is neither memory nor register
+};
+
+/**
+ * @brief Function that checks the whole bytecode once before the execution (every violation is reported to stderr with its address)
+ * 
+ * Verified bytecode is guaranteed to have only valid opcodes, operands inside of the bytecode, jump targets on the command
+ * boundaries, valid register codes and constant RAM addresses in range (computed RAM addresses are still checked at runtime)
+ * 
+ * @param byteCode 
+ * @param RAMSize amount of RAM cells the bytecode is executed with
+ * @param violationsCount 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES verifyBytecode(text_t *byteCode, size_t RAMSize, int *violationsCount);
+
+
+#endif  // VERIFIER_H
@@ -1,5 +1,8 @@
 #define MAX_REGS_COUNT 4
 
+#define MAX_INT_REGS_COUNT 8    // Integer registers `r0`..`r7` (64-bit, see `iadd` and others)
+#define INT_REGS_BASE 16        // Bytecode code of `r0` (codes of the other integer registers follow it)
+
 // REGDEF(ax, 0)
 
 // REGDEF(dx, 3)
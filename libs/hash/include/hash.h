@@ -5,6 +5,7 @@
 
 
 EXIT_CODES calculateHashSum(void *object, unsigned long long int size, long long int *hashSum);
+EXIT_CODES updateHashSum(const void *oldBytes, const void *newBytes, unsigned long long int size, unsigned long long int position, long long int *hashSum);
 
 
 #endif  // HASH_H
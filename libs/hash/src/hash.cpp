@@ -20,3 +20,25 @@ EXIT_CODES calculateHashSum(void *object, unsigned long long int size, long long
 
     return EXIT_CODES::NO_ERRORS;
 }
+
+EXIT_CODES updateHashSum(const void *oldBytes, const void *newBytes, unsigned long long int size, unsigned long long int position, long long int *hashSum)
+{
+    // Error check
+    if (oldBytes == NULL || newBytes == NULL || hashSum == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Hash sum is a sum of (byte * its position), so only changed bytes contribute to the difference (same wrap-around arithmetic as `calculateHashSum`)
+    const char *oldByteObject = (const char *) oldBytes;
+    const char *newByteObject = (const char *) newBytes;
+    unsigned long long delta = 0;
+    for (unsigned long long byte = 0; byte < size; ++byte)
+    {
+        delta += ((unsigned long long) newByteObject[byte] - (unsigned long long) oldByteObject[byte]) * (position + byte);
+    }
+    *hashSum = (long long int) ((unsigned long long) *hashSum + delta);
+
+    return EXIT_CODES::NO_ERRORS;
+}
@@ -21,9 +21,12 @@
 
 
 #pragma region STACK_SECURITY
+    // Checking policy of `stack_t` (other policies are available via `checked_stack_t<STACK_CHECKS::...>`)
     #define STACK_CANARY    1  // 0 - disable canaries, 1 - enable canaries
     #define STACK_HASH      1  // 0 - disable checksum (hashsum), 1 - enable checksum (hashsum)
 
+    #define STACK_HASH_FULL_CHECK   0  // 0 - recalculate checksum once per `capacity` checks (amortized O(1)), 1 - on every check (O(capacity))
+
     #if defined(STACK_CANARY) && STACK_CANARY == 1
         #define CANARY_VALUE    0xBABE  // Default canary value
     #endif
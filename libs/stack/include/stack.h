@@ -16,6 +16,14 @@
     #define STACK_HASH 0
 #endif
 
+#ifndef STACK_HASH_FULL_CHECK
+    #define STACK_HASH_FULL_CHECK 0
+#endif
+
+#ifndef CANARY_VALUE
+    #define CANARY_VALUE 0xBABE
+#endif
+
 #ifndef DEBUG_LEVEL
     #define DEBUG_LEVEL 0
 #endif
@@ -38,29 +46,50 @@ enum class REALLOC_MODES
     DECREASE
 };
 
+/**
+ * @brief An enum class that contains checking policies of the stack (every next one includes all the previous checks)
+ * 
+ */
+enum class STACK_CHECKS
+{
+    NONE,           // No integrity checks (only popping from the empty stack is reported)
+    BOUNDS,         // Structure check (data pointer, size and capacity) before and after every operation
+    CANARY,         // + canaries around the structure and the data, poisoning of unused elements
+    CANARY_HASH,    // + checksum (hashsum) of the structure and the data (fully recalculated once per `capacity` operations)
+    FULL_HASH,      // + full recalculation of the checksum on every operation (corruption is detected by the next operation)
+};
+
 /**
  * @brief Structure represents stack data structure.
  * 
+ * @tparam checks checking policy (layout is the same for all policies, only the checks differ) 
  */
-struct stack_t
+template <STACK_CHECKS checks>
+struct checked_stack_t
 {
-    #if STACK_CANARY == 1
-        const int canaryLeft = CANARY_VALUE;    // Left canary value to signal out-of-bounds calls (overflow/underflow) (global canaries)
-    #endif
+    const int canaryLeft = CANARY_VALUE;        // Left canary value to signal out-of-bounds calls (overflow/underflow) (global canaries)
 
     stackElem_t *data = NULL;                   // All stack elements are located here (+ left and right canaries to monitor violation of stack bounds) (local canaries)
     int capacity = -1;                          // Current capacity of stack
     int size = -1;                              // Current size of stack
 
-    #if STACK_CANARY == 1
-        const int canaryRight = CANARY_VALUE;   // Right canary value to signal out-of-bounds calls (overflow/underflow)
-    #endif
+    const int canaryRight = CANARY_VALUE;       // Right canary value to signal out-of-bounds calls (overflow/underflow)
 
-    #if STACK_HASH == 1
-        long long int hashSum = 0;              // Checksum (hashsum) to signal arbitrary write to stack structure (global canaries), contains info about all stack structure 
-    #endif
+    long long int hashSum = 0;                  // Checksum (hashsum) to signal arbitrary write to stack structure (global canaries), contains info about all stack structure
+    int checksUntilRehash = 0;                  // Amount of hash checks left before the full recalculation of checksum (not covered by checksum)
 };
 
+// Checking policy of `stack_t` (determined by `settings.h`)
+#if STACK_HASH == 1
+    const STACK_CHECKS DEFAULT_STACK_CHECKS = STACK_CHECKS::CANARY_HASH;
+#elif STACK_CANARY == 1
+    const STACK_CHECKS DEFAULT_STACK_CHECKS = STACK_CHECKS::CANARY;
+#else
+    const STACK_CHECKS DEFAULT_STACK_CHECKS = STACK_CHECKS::BOUNDS;
+#endif
+
+typedef checked_stack_t<DEFAULT_STACK_CHECKS> stack_t;
+
 #if DEBUG_LEVEL == 2
     /**
      * @brief Dump of all stack structure and its fields
@@ -68,66 +97,79 @@ struct stack_t
      * @param stack 
      * @return EXIT_CODES 
      */
-    EXIT_CODES stackDump(stack_t *stack);
+    template <STACK_CHECKS checks>
+    EXIT_CODES stackDump(checked_stack_t<checks> *stack);
 #else
     #define stackDump(stack) EXIT_CODES::NO_ERRORS;
 #endif
 
-#if STACK_CANARY == 1  
-    /**
-     * @brief Check stack canary values (both global and local canaries)
-     * 
-     * @param stack 
-     * @param result 
-     * @return EXIT_CODES 
-     */
-    EXIT_CODES canaryCheck(stack_t *stack, bool *result);
+/**
+ * @brief Check stack canary values (both global and local canaries)
+ * 
+ * @param stack 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+template <STACK_CHECKS checks>
+EXIT_CODES canaryCheck(checked_stack_t<checks> *stack, bool *result);
 
-    /**
-     * @brief Construct local canaries
-     * 
-     * @param stack 
-     * @param stack_capacity 
-     * @return EXIT_CODES 
-     */
-    EXIT_CODES canaryCtor(stack_t *stack, int stack_capacity);
-#endif
+/**
+ * @brief Construct local canaries
+ * 
+ * @param stack 
+ * @param stack_capacity 
+ * @return EXIT_CODES 
+ */
+template <STACK_CHECKS checks>
+EXIT_CODES canaryCtor(checked_stack_t<checks> *stack, int stack_capacity);
 
-#if STACK_HASH == 1
-    /**
-     * @brief Calculate hash sum, that contains information about all stack structure
-     * 
-     * @param stack 
-     * @param hashSum 
-     * @return EXIT_CODES 
-     */
-    EXIT_CODES calculateStackHashSum(stack_t *stack, long long int *hashSum);
+/**
+ * @brief Calculate hash sum, that contains information about all stack structure
+ * 
+ * @param stack 
+ * @param hashSum 
+ * @return EXIT_CODES 
+ */
+template <STACK_CHECKS checks>
+EXIT_CODES calculateStackHashSum(checked_stack_t<checks> *stack, long long int *hashSum);
 
-    /**
-     * @brief Check current stack structure hashsum and previous one
-     * 
-     * @param stack 
-     * @param result 
-     * @return EXIT_CODES 
-     */
-    EXIT_CODES stackHashCheck(stack_t *stack, bool *result);
-#endif
+/**
+ * @brief Update hash sum after the change of one stack element and stack size (O(1) instead of `calculateStackHashSum`)
+ * 
+ * @param stack 
+ * @param index 
+ * @param oldValue 
+ * @param oldSize 
+ * @return EXIT_CODES 
+ */
+template <STACK_CHECKS checks>
+EXIT_CODES updateStackHashSum(checked_stack_t<checks> *stack, int index, stackElem_t oldValue, int oldSize);
 
-#if STACK_CANARY == 1 || STACK_HASH == 1
-    /**
-     * @brief Determine the capacity increase for security fields of the stack
-     * 
-     * @param stack 
-     * @param add_bytes 
-     * @return EXIT_CODES 
-     */
-    EXIT_CODES stackCapacityIncrease(stack_t *stack, int *add_bytes);
-#else
-    #define stackCapacityIncrease(stack, add_bytes)  EXIT_CODES::NO_ERRORS;
-#endif
+/**
+ * @brief Check current stack structure hashsum and previous one
+ * 
+ * @param stack 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+template <STACK_CHECKS checks>
+EXIT_CODES stackHashCheck(checked_stack_t<checks> *stack, bool *result);
+
+/**
+ * @brief Determine the capacity increase for security fields of the stack
+ * 
+ * @param stack 
+ * @param add_bytes 
+ * @return EXIT_CODES 
+ */
+template <STACK_CHECKS checks>
+EXIT_CODES stackCapacityIncrease(checked_stack_t<checks> *stack, int *add_bytes);
+
+template <STACK_CHECKS checks>
+bool stackBasicCheck(checked_stack_t<checks> *stack);
 
-bool stackBasicCheck(stack_t *stack);
-bool stackOk(stack_t *stack);
+template <STACK_CHECKS checks>
+bool stackOk(checked_stack_t<checks> *stack);
 
 /**
  * @brief Spraying poison on all allocated uninitialized stack data
@@ -135,7 +177,8 @@ bool stackOk(stack_t *stack);
  * @param stack 
  * @return EXIT_CODES 
  */
-EXIT_CODES sprayPoisonOnData(stack_t *stack);
+template <STACK_CHECKS checks>
+EXIT_CODES sprayPoisonOnData(checked_stack_t<checks> *stack);
 
 /**
  * @brief Construction of stack data structure
@@ -144,7 +187,8 @@ EXIT_CODES sprayPoisonOnData(stack_t *stack);
  * @param stack_capacity 
  * @return EXIT_CODES 
  */
-EXIT_CODES stackCtor(stack_t *stack, int stack_capacity = 12);
+template <STACK_CHECKS checks>
+EXIT_CODES stackCtor(checked_stack_t<checks> *stack, int stack_capacity = 12);
 
 /**
  * @brief Deconstruction of stack data structure
@@ -152,7 +196,8 @@ EXIT_CODES stackCtor(stack_t *stack, int stack_capacity = 12);
  * @param stack 
  * @return EXIT_CODES 
  */
-EXIT_CODES stackDtor(stack_t *stack);
+template <STACK_CHECKS checks>
+EXIT_CODES stackDtor(checked_stack_t<checks> *stack);
 
 /**
  * @brief Get the New Reallocation Capacity object
@@ -162,7 +207,8 @@ EXIT_CODES stackDtor(stack_t *stack);
  * @param new_capacity 
  * @return EXIT_CODES 
  */
-EXIT_CODES getNewReallocationCapacity(stack_t *stack, REALLOC_MODES mode, int *new_capacity);
+template <STACK_CHECKS checks>
+EXIT_CODES getNewReallocationCapacity(checked_stack_t<checks> *stack, REALLOC_MODES mode, int *new_capacity);
 
 /**
  * @brief Reallocate stack (increase its capacity)
@@ -171,7 +217,8 @@ EXIT_CODES getNewReallocationCapacity(stack_t *stack, REALLOC_MODES mode, int *n
  * @param mode 
  * @return EXIT_CODES 
  */
-EXIT_CODES stackReallocation(stack_t *stack, REALLOC_MODES mode);
+template <STACK_CHECKS checks>
+EXIT_CODES stackReallocation(checked_stack_t<checks> *stack, REALLOC_MODES mode);
 
 /**
  * @brief Push element into stack
@@ -180,7 +227,8 @@ EXIT_CODES stackReallocation(stack_t *stack, REALLOC_MODES mode);
  * @param value 
  * @return EXIT_CODES 
  */
-EXIT_CODES stackPush(stack_t *stack, stackElem_t value);
+template <STACK_CHECKS checks>
+EXIT_CODES stackPush(checked_stack_t<checks> *stack, stackElem_t value);
 
 #define DEFAULT_POPTO_VALUE (stackElem_t *) 1
 /**
@@ -190,6 +238,7 @@ EXIT_CODES stackPush(stack_t *stack, stackElem_t value);
  * @param popTo 
  * @return EXIT_CODES 
  */
-EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo = DEFAULT_POPTO_VALUE);
+template <STACK_CHECKS checks>
+EXIT_CODES stackPop(checked_stack_t<checks> *stack, stackElem_t *popTo = DEFAULT_POPTO_VALUE);
 
 #endif  // STACK_H
@@ -7,14 +7,6 @@
 #include "include/settings.h"
 #include "include/stack.h"
 
-#ifndef STACK_HASH
-    #define STACK_HASH  1
-#endif
-
-#ifndef STACK_CANARY
-    #define STACK_CANARY  1
-#endif
-
 #ifndef stackReallocCoefficient
     #define stackReallocCoefficient 2
 #endif
@@ -23,174 +15,214 @@
     #define POISON  -663
 #endif
 
-#if defined(STACK_HASH) && STACK_HASH == 1
-    #include "libs/hash/include/hash.h"
-#endif
+#include "libs/hash/include/hash.h"
 
 #ifdef STACK_ELEMENT_DUMP_FMT_STR
     #undef STACK_ELEMENT_DUMP_FMT_STR
 #endif
 #define STACK_ELEMENT_DUMP_FMT_STR  "%lf"
 
-#if defined(STACK_CANARY) && STACK_CANARY == 1  
-    
-    EXIT_CODES canaryCtor(stack_t *stack, int stack_capacity)
+// Policies are ordered, so every policy includes the checks of all the previous ones (see `STACK_CHECKS`)
+#define CHECKS_INCLUDE(policy)  (checks >= STACK_CHECKS::policy)
+
+#define STACK_VERIFY(stack)                 \
+    if constexpr (CHECKS_INCLUDE(BOUNDS))   \
+    {                                       \
+        OBJECT_VERIFY(stack, stack);        \
+    }
+
+template <STACK_CHECKS checks>
+EXIT_CODES canaryCtor(checked_stack_t<checks> *stack, int stack_capacity)
+{
+    // Error check
+    if (stack == NULL)
     {
-        // Error check
-        if (stack == NULL)
-        {
-            PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::PASSED_STACK_IS_NULLPTR);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::PASSED_STACK_IS_NULLPTR);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        if (stack->capacity != -1 || stack->size != -1)  // Only just created stack object can call canaryCtor
-        {
-            PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::OLD_STACK_PASSED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+    if (stack->capacity != -1 || stack->size != -1)  // Only just created stack object can call canaryCtor
+    {
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::OLD_STACK_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        // Canary construction
-        int *canaryLeft = (int *) stack->data;
-        *canaryLeft = CANARY_VALUE;
+    // Canary construction
+    int *canaryLeft = (int *) stack->data;
+    *canaryLeft = CANARY_VALUE;
 
-        int *canaryRight = (int *) (((char *) stack->data) + sizeof(stack->canaryLeft) + stack_capacity * sizeof(stackElem_t));
-        *canaryRight = CANARY_VALUE;
+    int *canaryRight = (int *) (((char *) stack->data) + sizeof(stack->canaryLeft) + stack_capacity * sizeof(stackElem_t));
+    *canaryRight = CANARY_VALUE;
 
-        stack->data = (stackElem_t *) (((char *) stack->data) + sizeof(stack->canaryLeft));
+    stack->data = (stackElem_t *) (((char *) stack->data) + sizeof(stack->canaryLeft));
 
-        return EXIT_CODES::NO_ERRORS;
-    }
+    return EXIT_CODES::NO_ERRORS;
+}
 
-    EXIT_CODES canaryCheck(stack_t *stack, bool *result)
+template <STACK_CHECKS checks>
+EXIT_CODES canaryCheck(checked_stack_t<checks> *stack, bool *result)
+{
+    // Error check
+    if (!stackBasicCheck(stack) || result == NULL)
     {
-        // Error check
-        if (!stackBasicCheck(stack) || result == NULL)
-        {
-            *result = false;
+        *result = false;
 
-            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        // Stack structure canary check
-        if (stack->canaryLeft != CANARY_VALUE || stack->canaryRight != CANARY_VALUE)
-        {
-            *result = false;
+    // Stack structure canary check
+    if (stack->canaryLeft != CANARY_VALUE || stack->canaryRight != CANARY_VALUE)
+    {
+        *result = false;
 
-            PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::STACK_STRUCTURE_CANARY_IS_DAMAGED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::STACK_STRUCTURE_CANARY_IS_DAMAGED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        // Stack data canary check
-        int *canaryLeft  = (int *) ( ((char *) stack->data) - sizeof(stack->canaryLeft));
-        int *canaryRight = (int *) ( ((char *) stack->data) + stack->capacity * sizeof(stackElem_t));
-        if ( *canaryLeft != CANARY_VALUE || *canaryRight != CANARY_VALUE)
-        {
-            *result = false;
+    // Stack data canary check
+    int *canaryLeft  = (int *) ( ((char *) stack->data) - sizeof(stack->canaryLeft));
+    int *canaryRight = (int *) ( ((char *) stack->data) + stack->capacity * sizeof(stackElem_t));
+    if ( *canaryLeft != CANARY_VALUE || *canaryRight != CANARY_VALUE)
+    {
+        *result = false;
 
-            PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::STACK_DATA_CANARY_IS_DAMAGED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::STACK_DATA_CANARY_IS_DAMAGED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        *result = true;
-        return EXIT_CODES::NO_ERRORS;
+    *result = true;
+    return EXIT_CODES::NO_ERRORS;
+}
+
+template <STACK_CHECKS checks>
+EXIT_CODES calculateStackHashSum(checked_stack_t<checks> *stack, long long int *hashSum)
+{
+    // Error check
+    if (!stackBasicCheck(stack))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
     }
+
+    // Calculation of hash of stack structure
+    long long int stack_hash_sum = 0;
+    unsigned long long stack_total_bytes = offsetof(checked_stack_t<checks>, hashSum);
+    IS_OK_WO_EXIT(calculateHashSum(stack, stack_total_bytes, &stack_hash_sum));
+
+    // Calculation of data hash of the stack structure 
+    long long int stack_data_hash_sum = 0;
+
+    long long int data_total_bytes = stack->capacity * sizeof(stackElem_t);
+    data_total_bytes += ( sizeof(stack->canaryLeft) + sizeof(stack->canaryRight) );
+
+    char *data_p = ((char *) stack->data) - sizeof(stack->canaryLeft);
+
+    IS_OK_WO_EXIT(calculateHashSum(data_p, data_total_bytes, &stack_data_hash_sum));
     
-#endif
+    // Get entire stack + stack->data hash sum
+    *hashSum = stack_hash_sum + stack_data_hash_sum;
 
-#if defined(STACK_HASH) && STACK_HASH == 1
+    return EXIT_CODES::NO_ERRORS;
+}
 
-    EXIT_CODES calculateStackHashSum(stack_t *stack, long long int *hashSum)
+template <STACK_CHECKS checks>
+EXIT_CODES updateStackHashSum(checked_stack_t<checks> *stack, int index, stackElem_t oldValue, int oldSize)
+{
+    // Error check
+    if (!stackBasicCheck(stack) || index < 0 || index >= stack->capacity)
     {
-        // Error check
-        if (!stackBasicCheck(stack))
-        {
-            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        // Calculation of hash of stack structure
-        long long int stack_hash_sum = 0;
-        unsigned long long stack_total_bytes = sizeof(stack_t) - sizeof(stack->hashSum);
-        IS_OK_WO_EXIT(calculateHashSum(stack, stack_total_bytes, &stack_hash_sum));
+    // Changed element (position is counted the same way as in `calculateStackHashSum`)
+    unsigned long long element_position = sizeof(stack->canaryLeft) + index * sizeof(stackElem_t);
 
-        // Calculation of data hash of the stack structure 
-        long long int stack_data_hash_sum = 0;
+    IS_OK_WO_EXIT(updateHashSum(&oldValue, &stack->data[index], sizeof(stackElem_t), element_position, &stack->hashSum));
 
-        long long int data_total_bytes = stack->capacity * sizeof(stackElem_t);
-        #if defined(STACK_CANARY) && STACK_CANARY == 1
-            data_total_bytes += ( sizeof(stack->canaryLeft) + sizeof(stack->canaryRight) );
+    // Changed size field
+    IS_OK_WO_EXIT(updateHashSum(&oldSize, &stack->size, sizeof(stack->size), offsetof(checked_stack_t<checks>, size), &stack->hashSum));
 
-            char *data_p = ((char *) stack->data) - sizeof(stack->canaryLeft);
-        #else
-            char *data_p = (char *) stack->data;
-        #endif
+    return EXIT_CODES::NO_ERRORS;
+}
 
-        IS_OK_WO_EXIT(calculateHashSum(data_p, data_total_bytes, &stack_data_hash_sum));
-        
-        // Get entire stack + stack->data hash sum
-        *hashSum = stack_hash_sum + stack_data_hash_sum;
+template <STACK_CHECKS checks>
+EXIT_CODES stackHashCheck(checked_stack_t<checks> *stack, bool *result)
+{
+    // Error check
+    if (!stackBasicCheck(stack) || result == NULL)
+    {
+        *result = false;
 
-        return EXIT_CODES::NO_ERRORS;
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
     }
 
-    EXIT_CODES stackHashCheck(stack_t *stack, bool *result)
-    {
-        // Error check
-        if (!stackBasicCheck(stack) || result == NULL)
+    // Full recalculation is done once per `capacity` checks (checksum itself is kept up to date by every operation)
+    #if STACK_HASH_FULL_CHECK == 0
+        if constexpr (!CHECKS_INCLUDE(FULL_HASH))
         {
-            *result = false;
+            if (stack->checksUntilRehash > 0)
+            {
+                --stack->checksUntilRehash;
 
-            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
+                *result = true;
+                return EXIT_CODES::NO_ERRORS;
+            }
+            stack->checksUntilRehash = stack->capacity;
         }
+    #endif
 
-        // Hash sum check
-        long long int currentHashSum = 0;
-        IS_OK_WO_EXIT(calculateStackHashSum(stack, &currentHashSum));
-
-        if (stack->hashSum != currentHashSum)
-        {
-            *result = false;
+    // Hash sum check
+    long long int currentHashSum = 0;
+    IS_OK_WO_EXIT(calculateStackHashSum(stack, &currentHashSum));
 
-            PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::STACK_HASH_SUM_IS_DAMAGED);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+    if (stack->hashSum != currentHashSum)
+    {
+        *result = false;
 
-        *result = true;
-        return EXIT_CODES::NO_ERRORS;
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::STACK_HASH_SUM_IS_DAMAGED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
     }
 
-#endif
+    *result = true;
+    return EXIT_CODES::NO_ERRORS;
+}
 
-bool stackBasicCheck(stack_t *stack)
+template <STACK_CHECKS checks>
+bool stackBasicCheck(checked_stack_t<checks> *stack)
 {
     return  stack != NULL && stack->data != NULL &&
             stack->size >= 0 && stack->size <= stack->capacity;
 }
 
-bool stackOk(stack_t *stack)
+template <STACK_CHECKS checks>
+bool stackOk(checked_stack_t<checks> *stack)
 {
     bool result = stackBasicCheck(stack);
 
-    #if defined(STACK_CANARY) && STACK_CANARY == 1  
+    if constexpr (CHECKS_INCLUDE(CANARY))
+    {
         bool canary_is_ok = true;
         IS_OK_WO_EXIT(canaryCheck(stack, &canary_is_ok));
 
         result = result && canary_is_ok;
-    #endif 
+    }
 
-    #if defined(STACK_HASH) && STACK_HASH == 1  
+    if constexpr (CHECKS_INCLUDE(CANARY_HASH))
+    {
         bool hash_is_ok = true;
         IS_OK_WO_EXIT(stackHashCheck(stack, &hash_is_ok));
 
         result = result && hash_is_ok;
-    #endif
+    }
 
     return result;
 }
 
-EXIT_CODES sprayPoisonOnData(stack_t *stack)
+template <STACK_CHECKS checks>
+EXIT_CODES sprayPoisonOnData(checked_stack_t<checks> *stack)
 {
     // Error check
     if (!stackBasicCheck(stack))
@@ -207,34 +239,28 @@ EXIT_CODES sprayPoisonOnData(stack_t *stack)
     return EXIT_CODES::NO_ERRORS;
 }
 
-#if STACK_CANARY == 1 || STACK_HASH == 1
-
-    EXIT_CODES stackCapacityIncrease(stack_t *stack, int *add_bytes)
+template <STACK_CHECKS checks>
+EXIT_CODES stackCapacityIncrease(checked_stack_t<checks> *stack, int *add_bytes)
+{
+    // Error check
+    if (stack == NULL || add_bytes == NULL)
     {
-        // Error check
-        if (stack == NULL || add_bytes == NULL)
-        {
-            PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::PASSED_STACK_IS_NULLPTR);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::PASSED_STACK_IS_NULLPTR);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
 
-        // Protection bytes for hashSum field
-        #if defined(STACK_HASH) && STACK_HASH == 1
-            (*add_bytes) += sizeof(stack->hashSum);
-        #endif
-        
-        // Protection bytes for canary fields
-        #if defined(STACK_CANARY) && STACK_CANARY == 1
-            (*add_bytes) += ( sizeof(stack->canaryLeft) + sizeof(stack->canaryRight) );
-        #endif
+    // Protection bytes for hashSum field
+    (*add_bytes) += sizeof(stack->hashSum);
 
-        return EXIT_CODES::NO_ERRORS;
-    }
+    // Protection bytes for canary fields (data layout is the same for all policies)
+    (*add_bytes) += ( sizeof(stack->canaryLeft) + sizeof(stack->canaryRight) );
 
-#endif
+    return EXIT_CODES::NO_ERRORS;
+}
 
 // TODO: change struct default values to macroses
-EXIT_CODES stackCtor(stack_t *stack, int stack_capacity)
+template <STACK_CHECKS checks>
+EXIT_CODES stackCtor(checked_stack_t<checks> *stack, int stack_capacity)
 {
     // Error check
     if (stack == NULL)
@@ -262,29 +288,32 @@ EXIT_CODES stackCtor(stack_t *stack, int stack_capacity)
     }
 
     // Construct canary fields
-    #if defined(STACK_CANARY) && STACK_CANARY == 1
-        IS_OK_W_EXIT(canaryCtor(stack, stack_capacity));
-    #endif
+    IS_OK_W_EXIT(canaryCtor(stack, stack_capacity));
 
     // Fill stack structure
     stack->capacity = stack_capacity;
     stack->size = 0;
 
     // Poison allocated data fields
-    IS_OK_W_EXIT(sprayPoisonOnData(stack));
+    if constexpr (CHECKS_INCLUDE(CANARY))
+    {
+        IS_OK_W_EXIT(sprayPoisonOnData(stack));
+    }
 
     // Construct hasSum field
-    #if defined(STACK_HASH) && STACK_HASH == 1
+    if constexpr (CHECKS_INCLUDE(CANARY_HASH))
+    {
         IS_OK_W_EXIT(calculateStackHashSum(stack, &stack->hashSum));
-    #endif
+    }
 
     return EXIT_CODES::NO_ERRORS;
 }
 
-EXIT_CODES getNewReallocationCapacity(stack_t *stack, REALLOC_MODES mode, int *new_capacity)
+template <STACK_CHECKS checks>
+EXIT_CODES getNewReallocationCapacity(checked_stack_t<checks> *stack, REALLOC_MODES mode, int *new_capacity)
 {
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     if (new_capacity == NULL)
     {
@@ -305,94 +334,93 @@ EXIT_CODES getNewReallocationCapacity(stack_t *stack, REALLOC_MODES mode, int *n
     }
 
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     return EXIT_CODES::NO_ERRORS;
 }
 
-EXIT_CODES stackReallocation(stack_t *stack, REALLOC_MODES mode)
+template <STACK_CHECKS checks>
+EXIT_CODES stackReallocation(checked_stack_t<checks> *stack, REALLOC_MODES mode)
 {
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     // Get new reallocation capacity
     int new_capacity = 0;
     IS_OK_W_EXIT(getNewReallocationCapacity(stack, mode, &new_capacity));
 
-    int stack_capacity_increase = 0;
-    #if defined(STACK_CANARY) && STACK_CANARY == 1
-        stack_capacity_increase += ( sizeof(stack->canaryLeft) + sizeof(stack->canaryRight) );
-    #endif
+    stackElem_t *temp = (stackElem_t *) realloc( ((char *) stack->data) - sizeof(stack->canaryLeft),  // because we want to free canaries (left and right)
+                                                sizeof(stack->canaryLeft) + new_capacity * sizeof(stackElem_t) + sizeof(stack->canaryRight));
 
-    #if defined(STACK_CANARY) && STACK_CANARY == 1
-        stackElem_t *temp = (stackElem_t *) realloc( ((char *) stack->data) - sizeof(stack->canaryLeft),  // because we want to free canaries (left and right)
-                                                    sizeof(stack->canaryLeft) + new_capacity * sizeof(stackElem_t) + sizeof(stack->canaryRight));
-    #else
-        stackElem_t *temp = (stackElem_t *) realloc(stack->data, new_capacity * sizeof(stackElem_t));
-    #endif
-    
     if (temp == NULL)
     {
         PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_STD_FUNC_RESULT);
         return EXIT_CODES::BAD_STD_FUNC_RESULT;
     }
 
-    #if defined(STACK_CANARY) && STACK_CANARY == 1
-        // Set canaries
-        int *canaryLeft = (int *) temp;
-        *canaryLeft = CANARY_VALUE;
+    // Set canaries
+    int *canaryLeft = (int *) temp;
+    *canaryLeft = CANARY_VALUE;
 
-        int *canaryRight = (int *) (((char *) temp) + sizeof(stack->canaryLeft) + new_capacity * sizeof(stackElem_t));
-        *canaryRight = CANARY_VALUE;
+    int *canaryRight = (int *) (((char *) temp) + sizeof(stack->canaryLeft) + new_capacity * sizeof(stackElem_t));
+    *canaryRight = CANARY_VALUE;
 
-        temp = (stackElem_t *) (((char *) temp) + sizeof(stack->canaryLeft));
-    #endif
+    temp = (stackElem_t *) (((char *) temp) + sizeof(stack->canaryLeft));
 
     // Update structure variables
     stack->data = temp;
     stack->capacity = new_capacity;
 
     // Poison new fields
-    IS_OK_W_EXIT(sprayPoisonOnData(stack));
+    if constexpr (CHECKS_INCLUDE(CANARY))
+    {
+        IS_OK_W_EXIT(sprayPoisonOnData(stack));
+    }
 
     // Update hash sum
-    #if defined(STACK_HASH) && STACK_HASH == 1
+    if constexpr (CHECKS_INCLUDE(CANARY_HASH))
+    {
         IS_OK_W_EXIT(calculateStackHashSum(stack, &stack->hashSum));
-    #endif
+    }
 
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     return EXIT_CODES::NO_ERRORS;
 }
 
-EXIT_CODES stackPush(stack_t *stack, stackElem_t value)
+template <STACK_CHECKS checks>
+EXIT_CODES stackPush(checked_stack_t<checks> *stack, stackElem_t value)
 {
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     if (stack->size == stack->capacity)
     {
         IS_OK_W_EXIT(stackReallocation(stack, REALLOC_MODES::INCREASE));
     }
 
+    stackElem_t oldValue = stack->data[stack->size];
     stack->data[stack->size++] = value;
 
     // Update hash sum
-    #if defined(STACK_HASH) && STACK_HASH == 1
-        IS_OK_W_EXIT(calculateStackHashSum(stack, &stack->hashSum));
-    #endif
+    if constexpr (CHECKS_INCLUDE(CANARY_HASH))
+    {
+        IS_OK_W_EXIT(updateStackHashSum(stack, stack->size - 1, oldValue, stack->size - 1));
+    }
+    (void) oldValue;
 
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     return EXIT_CODES::NO_ERRORS;
 }
 
-EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
+template <STACK_CHECKS checks>
+EXIT_CODES stackPop(checked_stack_t<checks> *stack, stackElem_t *popTo)
 {
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     if (stack->size < 1)
     {
@@ -408,11 +436,13 @@ EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
 
     // printf("stackReallocCoefficient * stack->size: %d\n", stackReallocCoefficient * stack->size);
     // printf("stack->capacity: %d\n", stack->capacity);
-    if (stack->size > 8 && stackReallocCoefficient * stack->size < stack->capacity)
+    // Decrease is delayed until the stack is `stackReallocCoefficient` times emptier than the increase point (no reallocation on every push/pop at the boundary)
+    if (stack->size > 8 && stackReallocCoefficient * stackReallocCoefficient * stack->size < stack->capacity)
     {
         IS_OK_W_EXIT(stackReallocation(stack, REALLOC_MODES::DECREASE));
     }
 
+    stackElem_t oldValue = stack->data[stack->size - 1];
     if (popTo == DEFAULT_POPTO_VALUE)
     {
         --stack->size; 
@@ -422,22 +452,28 @@ EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
         *popTo = stack->data[--stack->size];
     }
 
-    stack->data[stack->size] = POISON;
+    if constexpr (CHECKS_INCLUDE(CANARY))
+    {
+        stack->data[stack->size] = POISON;
+    }
 
     // Update hash sum
-    #if defined(STACK_HASH) && STACK_HASH == 1
-        IS_OK_W_EXIT(calculateStackHashSum(stack, &stack->hashSum));
-    #endif
+    if constexpr (CHECKS_INCLUDE(CANARY_HASH))
+    {
+        IS_OK_W_EXIT(updateStackHashSum(stack, stack->size, oldValue, stack->size + 1));
+    }
+    (void) oldValue;
 
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
     return EXIT_CODES::NO_ERRORS;
 }
 
 #if defined(DEBUG_LEVEL) && DEBUG_LEVEL == 2
     
-    EXIT_CODES stackDump(stack_t *stack)
+    template <STACK_CHECKS checks>
+    EXIT_CODES stackDump(checked_stack_t<checks> *stack)
     {
         if (stack == NULL)
         {
@@ -451,9 +487,10 @@ EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
 
         fprintf(DEFAULT_ERROR_TRACING_STREAM, "{\n");
 
-        #if defined(STACK_CANARY) && STACK_CANARY == 1
+        if constexpr (CHECKS_INCLUDE(CANARY))
+        {
             fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\tCANARY = %d\n", stack->canaryLeft);
-        #endif
+        }
 
         fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\tcapacity = %d (%s)\n", stack->capacity, VALUE_CODE_TO_STR(stack->capacity >= 0));
         fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\tsize = %d (%s)\n",
@@ -464,9 +501,10 @@ EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
         {
             fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\t{\n");
 
-            #if defined(STACK_CANARY) && STACK_CANARY == 1   
+            if constexpr (CHECKS_INCLUDE(CANARY))
+            {
                 fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\t\t [-1] = %d (CANARY)\n", *((int * ) (((char *) stack->data) - sizeof(stack->canaryLeft))));
-            #endif
+            }
 
             for (int element = 0; element < 12; ++element)
             {
@@ -481,20 +519,23 @@ EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
             }
             fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\t\t ...\n");
 
-            #if defined(STACK_CANARY) && STACK_CANARY == 1
+            if constexpr (CHECKS_INCLUDE(CANARY))
+            {
                 fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\t\t [%d] = %d (CANARY)\n", stack->capacity, *((int *) (((char *) stack->data) + stack->capacity * sizeof(stackElem_t))));//stack->data[stack->capacity]);
-            #endif
+            }
 
             fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\t}\n");
         }
 
-        #if defined(STACK_CANARY) && STACK_CANARY == 1
+        if constexpr (CHECKS_INCLUDE(CANARY))
+        {
             fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\tCANARY = %d \n", stack->canaryRight);
-        #endif
+        }
 
-        #if defined(STACK_HASH) && STACK_HASH == 1
+        if constexpr (CHECKS_INCLUDE(CANARY_HASH))
+        {
             fprintf(DEFAULT_ERROR_TRACING_STREAM, "\t\tHASH_SUM = %lld \n", stack->hashSum);
-        #endif
+        }
 
         fprintf(DEFAULT_ERROR_TRACING_STREAM, "}\n");
 
@@ -503,16 +544,19 @@ EXIT_CODES stackPop(stack_t *stack, stackElem_t *popTo)
     
 #endif
 
-EXIT_CODES stackDtor(stack_t *stack)
+template <STACK_CHECKS checks>
+EXIT_CODES stackDtor(checked_stack_t<checks> *stack)
 {
     // Error check
-    OBJECT_VERIFY(stack, stack);
+    STACK_VERIFY(stack);
 
-    #if defined(STACK_CANARY) && STACK_CANARY == 1
-        free( (((char *) stack->data) - sizeof(stack->canaryLeft)) );
-    #else
-        free(stack->data);
-    #endif
+    if (stack == NULL || stack->data == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::PASSED_STACK_IS_NULLPTR);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    free( (((char *) stack->data) - sizeof(stack->canaryLeft)) );
 
     stack->data = NULL;
     stack->capacity = -1;
@@ -520,3 +564,39 @@ EXIT_CODES stackDtor(stack_t *stack)
 
     return EXIT_CODES::NO_ERRORS;
 }
+
+// Explicit instantiation of all the checking policies
+#define INSTANTIATE_CHECKED_STACK(checks)                                                                               \
+    template EXIT_CODES canaryCtor(checked_stack_t<checks> *stack, int stack_capacity);                                 \
+    template EXIT_CODES canaryCheck(checked_stack_t<checks> *stack, bool *result);                                      \
+    template EXIT_CODES calculateStackHashSum(checked_stack_t<checks> *stack, long long int *hashSum);                   \
+    template EXIT_CODES updateStackHashSum(checked_stack_t<checks> *stack, int index, stackElem_t oldValue, int oldSize);\
+    template EXIT_CODES stackHashCheck(checked_stack_t<checks> *stack, bool *result);                                   \
+    template bool stackBasicCheck(checked_stack_t<checks> *stack);                                                      \
+    template bool stackOk(checked_stack_t<checks> *stack);                                                              \
+    template EXIT_CODES sprayPoisonOnData(checked_stack_t<checks> *stack);                                              \
+    template EXIT_CODES stackCapacityIncrease(checked_stack_t<checks> *stack, int *add_bytes);                          \
+    template EXIT_CODES stackCtor(checked_stack_t<checks> *stack, int stack_capacity);                                  \
+    template EXIT_CODES getNewReallocationCapacity(checked_stack_t<checks> *stack, REALLOC_MODES mode, int *new_capacity); \
+    template EXIT_CODES stackReallocation(checked_stack_t<checks> *stack, REALLOC_MODES mode);                          \
+    template EXIT_CODES stackPush(checked_stack_t<checks> *stack, stackElem_t value);                                   \
+    template EXIT_CODES stackPop(checked_stack_t<checks> *stack, stackElem_t *popTo);                                   \
+    template EXIT_CODES stackDtor(checked_stack_t<checks> *stack);                                                      \
+    INSTANTIATE_STACK_DUMP(checks)
+
+#if defined(DEBUG_LEVEL) && DEBUG_LEVEL == 2
+    #define INSTANTIATE_STACK_DUMP(checks)  template EXIT_CODES stackDump(checked_stack_t<checks> *stack);
+#else
+    #define INSTANTIATE_STACK_DUMP(checks)
+#endif
+
+INSTANTIATE_CHECKED_STACK(STACK_CHECKS::NONE)
+INSTANTIATE_CHECKED_STACK(STACK_CHECKS::BOUNDS)
+INSTANTIATE_CHECKED_STACK(STACK_CHECKS::CANARY)
+INSTANTIATE_CHECKED_STACK(STACK_CHECKS::CANARY_HASH)
+INSTANTIATE_CHECKED_STACK(STACK_CHECKS::FULL_HASH)
+
+#undef INSTANTIATE_STACK_DUMP
+#undef INSTANTIATE_CHECKED_STACK
+#undef STACK_VERIFY
+#undef CHECKS_INCLUDE
@@ -53,6 +53,18 @@ void textCtor(text_t *text, const char *file_path, const FILE_MODE mode)
     assert(ferror(fs) == 0 && "[!] There was an error during reading the file stream!");
     data[size] = '\0';
 
+    // Binary data is kept as it is (newline bytes are not line separators there)
+    if (mode == FILE_MODE::RB)
+    {
+        text->data = data;
+        text->size = size;
+        text->lines_count = 0;
+        text->lines = NULL;
+
+        fclose(fs);
+        return;
+    }
+
     // Get rid of empty lines
     deleteEmptyLines(data);
 
@@ -8,16 +8,19 @@
 
 #include "include/asm/settings.h"
 #include "include/constants.h"
+#include "include/regdefs.h"
 
 static EXIT_CODES parseCommand(text_line_t *line, command_t *command, labels_t *unprocCommandArgLabels, const int globalOffset);
 static EXIT_CODES normalizeCodeLine(text_line_t *line);
 static EXIT_CODES hasArguments(char *mnemonics, bool *hasArgs);
 static EXIT_CODES isSpecialInstruction(command_t *command, bool *isSpecInstr);
+static EXIT_CODES isIntegerInstruction(command_t *command, bool *isIntInstr);
 static EXIT_CODES checkMnemonics(char *mnemonics);
 static EXIT_CODES setCommandMnemonics(command_t *command, char *mnemonics);
 static EXIT_CODES setCommandOpcode(command_t *command);
 static EXIT_CODES parseCommandArguments(command_t *command, text_line_t *line, int argsStart, int argsEnd, labels_t *unprocCommandArgLabels, const int globalOffset);
 static EXIT_CODES parseArgument(command_t *command, int *argNumber, text_line_t *line, int *argStart);
+static EXIT_CODES parseIntegerArguments(command_t *command, text_line_t *line, int argsStart);
 static EXIT_CODES checkRegisterForCorrectness(char *reg);
 static EXIT_CODES getArgumentsMathOperation(text_line_t *line, int *argStart, char *mathOP);
 
@@ -251,42 +254,45 @@ static EXIT_CODES isSpecialInstruction(command_t *command, bool *isSpecInstr)
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
-    // Check
-    // if (command->mnemonics[0] != 'j' && command->mnemonics[0] != 'c')
-    // {
-    //     *isSpecInstr = false;
-    //     return EXIT_CODES::NO_ERRORS;
-    // }
-    // else
-    // {
-    // }
-    if (!strcmp(command->mnemonics, "jmp"))
-    {
-        *isSpecInstr = true;
-    }
-    else if (!strcmp(command->mnemonics, "je"))
-    {
-        *isSpecInstr = true;
-    }
-    else if (!strcmp(command->mnemonics, "jne"))
-    {
-        *isSpecInstr = true;
-    }
-    else if (!strcmp(command->mnemonics, "jl"))
-    {
-        *isSpecInstr = true;
-    }
-    else if (!strcmp(command->mnemonics, "jg"))
+    // Check (commands with label operand, see `argType` column of `opdefs.h`)
+    *isSpecInstr = false;
+    for (size_t instrIndx = 0; instrIndx < MNEMONICS_TABLE_LENGTH; ++instrIndx)
     {
-        *isSpecInstr = true;
+        if (!strcmp(command->mnemonics, MNEMONICS_TABLE[instrIndx]))
+        {
+            *isSpecInstr = OPERATION_ARG_TYPES_TABLE[instrIndx] == OPERAND_TYPES::LABEL;
+            break;
+        }
     }
-    else if (!strcmp(command->mnemonics, "call"))
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that determines whether the current command is an integer one (see `INTEGER` operand type of `opdefs.h`)
+ * 
+ * @param command 
+ * @param isIntInstr 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES isIntegerInstruction(command_t *command, bool *isIntInstr)
+{
+    // Error check
+    if (command == NULL || isIntInstr == NULL)
     {
-        *isSpecInstr = true;
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
-    else
+
+    // Check
+    *isIntInstr = false;
+    for (size_t instrIndx = 0; instrIndx < MNEMONICS_TABLE_LENGTH; ++instrIndx)
     {
-        *isSpecInstr = false;
+        if (!strcmp(command->mnemonics, MNEMONICS_TABLE[instrIndx]))
+        {
+            *isIntInstr = OPERATION_ARG_TYPES_TABLE[instrIndx] == OPERAND_TYPES::INTEGER;
+            break;
+        }
     }
 
     return EXIT_CODES::NO_ERRORS;
@@ -391,6 +397,14 @@ static EXIT_CODES parseCommandArguments(command_t *command, text_line_t *line, i
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
+    // Integer instructions have their own syntax (`rN, rM` or `rN, immediate`)
+    bool isIntInstr = false;
+    IS_OK_W_EXIT(isIntegerInstruction(command, &isIntInstr));
+    if (isIntInstr)
+    {
+        return parseIntegerArguments(command, line, argsStart);
+    }
+
     // Check for special instructions (instructions that use labels as command args or it is label itself)
     bool isSpecInstr = true;
     IS_OK_W_EXIT(isSpecialInstruction(command, &isSpecInstr));
@@ -465,11 +479,16 @@ static EXIT_CODES parseArgument(command_t *command, int *argNumber, text_line_t
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
-    // Parse one argument
+    // Parse one argument (integer register `rN` or common one)
     int newArgStart = 0;
     char reg[MAX_REGISTER_STR_LENGTH] = {};
-    if (sscanf(&line->beginning[*argStart], REGISTER_FORMAT, reg, &newArgStart) == 1)
+    if (sscanf(&line->beginning[*argStart], INT_REGISTER_FORMAT, &reg[1], &newArgStart) == 1 ||
+        sscanf(&line->beginning[*argStart], REGISTER_FORMAT, reg, &newArgStart) == 1)
     {
+        if (reg[0] == '\0')
+        {
+            reg[0] = 'r';
+        }
         IS_OK_W_EXIT(checkRegisterForCorrectness(reg));
         strcpy(command->arguments[*argNumber], reg);
 
@@ -497,6 +516,73 @@ static EXIT_CODES parseArgument(command_t *command, int *argNumber, text_line_t
     return EXIT_CODES::NO_ERRORS;
 }
 
+/**
+ * @brief Function that parses the arguments of an integer command (`rN, rM` or `rN, immediate`)
+ * 
+ * @param command 
+ * @param line 
+ * @param argsStart 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES parseIntegerArguments(command_t *command, text_line_t *line, int argsStart)
+{
+    // Error check
+    if (command == NULL || line == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Destination register
+    char *args = &line->beginning[argsStart];
+    int argEnd = 0;
+    char reg[MAX_REGISTER_STR_LENGTH] = {'r'};
+    if (sscanf(args, INT_REGISTER_FORMAT, &reg[1], &argEnd) != 1)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(ASM_EXIT_CODES::BAD_COMMAND_ARGUMENTS);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    IS_OK_W_EXIT(checkRegisterForCorrectness(reg));
+    strcpy(command->arguments[0], reg);
+    SET_MRI_REGISTER(command->argsMRI[0]);
+    args += argEnd;
+
+    argEnd = 0;
+    sscanf(args, ARGUMENTS_SEPARATOR_FORMAT, &argEnd);
+    if (argEnd == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(ASM_EXIT_CODES::BAD_COMMAND_FORMAT);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    args += argEnd;
+
+    // Source register or immediate (nothing is allowed after it)
+    argEnd = 0;
+    long long imm = 0;
+    if (sscanf(args, INT_REGISTER_FORMAT, &reg[1], &argEnd) == 1)
+    {
+        IS_OK_W_EXIT(checkRegisterForCorrectness(reg));
+        strcpy(command->arguments[1], reg);
+        SET_MRI_REGISTER(command->argsMRI[1]);
+    }
+    else if (sscanf(args, INT_IMMEDIATE_VALUE_FORMAT, &imm, &argEnd) == 1)
+    {
+        memcpy(command->arguments[1], &imm, sizeof(long long));
+        SET_MRI_IMMEDIATE(command->argsMRI[1]);
+    }
+
+    if (argEnd == 0 || args[argEnd] != '\0')
+    {
+        PRINT_ERROR_TRACING_MESSAGE(ASM_EXIT_CODES::BAD_COMMAND_ARGUMENTS);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    command->isIntegerCommand   = true;
+    command->argumentsCount     = 2;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
 /**
  * @brief Function that check whether the register mentioned in a command argument exists
  * 
@@ -512,7 +598,12 @@ static EXIT_CODES checkRegisterForCorrectness(char *reg)
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
-    // Check
+    // Check (`ax`..`dx` or `r0`..`r7`)
+    if (reg[0] == 'r' && reg[1] >= '0' && reg[1] < '0' + MAX_INT_REGS_COUNT && reg[2] == '\0')
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
     if (reg[1] != 'x' || reg[0] > 'd')
     {
         PRINT_ERROR_TRACING_MESSAGE(ASM_EXIT_CODES::UNKNOWN_COMMAND_REGISTER);
@@ -574,6 +665,24 @@ static EXIT_CODES encodeCommand(command_t *command)
     {
         command->encoded.bytes += sizeof(offset);
     }
+    // Integer instructions encoding (destination register, source MRI, source register or immediate)
+    else if (command->isIntegerCommand)
+    {
+        IS_OK_W_EXIT(encodeRegisterArgument(command, command->arguments[0]));
+        command->encoded.bytes += sizeof(byte);
+
+        command->encoded.byteData[command->encoded.bytes++] = (byte) command->argsMRI[1];
+        if (ARG_IS_REGISTER(command->argsMRI[1]))
+        {
+            IS_OK_W_EXIT(encodeRegisterArgument(command, command->arguments[1]));
+            command->encoded.bytes += sizeof(byte);
+        }
+        else
+        {
+            memcpy(&command->encoded.byteData[command->encoded.bytes], command->arguments[1], sizeof(long long));
+            command->encoded.bytes += sizeof(long long);
+        }
+    }
     // Common (not zero arg) instructions encoding
     else if (command->argumentsCount != NO_ARGUMENTS)
     {
@@ -621,13 +730,16 @@ static EXIT_CODES encodeRegisterArgument(command_t *command, char *regStr)
     }
 
     // Encode
-    if (regStr[1] != 'x' || regStr[0] > 'd')
+    IS_OK_W_EXIT(checkRegisterForCorrectness(regStr));
+
+    if (regStr[0] == 'r')
     {
-        PRINT_ERROR_TRACING_MESSAGE(ASM_EXIT_CODES::UNKNOWN_COMMAND_REGISTER);
-        return EXIT_CODES::BAD_OBJECT_PASSED;
+        command->encoded.byteData[command->encoded.bytes] = (byte) (INT_REGS_BASE + regStr[1] - '0');  // r0 opcode + N
+    }
+    else
+    {
+        command->encoded.byteData[command->encoded.bytes] = (byte) (regStr[0] - 'a');  // ax opcode
     }
-
-    command->encoded.byteData[command->encoded.bytes] = (byte) (regStr[0] - 'a');  // ax opcode
 
     return EXIT_CODES::NO_ERRORS;
 }
@@ -735,6 +847,7 @@ static EXIT_CODES resetCommand(command_t *command)
     command->argumentsCount     = 0;
     command->MRI                = 0;
     command->isSpecialCommand   = 0;
+    command->isIntegerCommand   = 0;
     command->encoded.bytes      = 0;
 
     return EXIT_CODES::NO_ERRORS;
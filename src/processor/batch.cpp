@@ -0,0 +1,605 @@
+#include <stdio.h>      // for snprintf
+#include <stdlib.h>     // for calloc, free
+#include <stdint.h>     // for UINT32_MAX
+#include <time.h>       // for clock
+#include <chrono>       // for std::chrono::steady_clock
+#include <thread>       // for std::thread
+#include <system_error> // for std::system_error
+
+#include "libs/colors/colors.h"
+
+#include "include/processor/batch.h"
+#include "include/processor/lockstep.h"
+#include "include/processor/settings.h"
+
+/**
+ * @brief Function that returns the seconds elapsed since `startTime` (wall clock, the workers run in parallel)
+ * 
+ * @param startTime 
+ * @return double 
+ */
+static double batchSeconds(std::chrono::steady_clock::time_point startTime)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * @brief Function that packs the records [front, back) into the range of the deque
+ * 
+ * @param front 
+ * @param back 
+ * @return unsigned long long
+ */
+static unsigned long long batchRange(int front, int back)
+{
+    return (unsigned long long) (unsigned int) front | (unsigned long long) (unsigned int) back << 32;
+}
+
+/**
+ * @brief Function that takes the record from the front of the deque (it is done by the owner only)
+ * 
+ * @param deque 
+ * @param record 
+ * @return bool the deque was not empty
+ */
+static bool batchTakeRecord(batch_deque_t *deque, int *record)
+{
+    unsigned long long range = deque->range.load();
+    while ((int) (range & UINT32_MAX) < (int) (range >> 32))
+    {
+        int front = (int) (range & UINT32_MAX);
+        if (deque->range.compare_exchange_weak(range, batchRange(front + 1, (int) (range >> 32))))
+        {
+            *record = front;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Function that moves the back half of the records of the first non-empty deque (after the thief's one) into the thief's deque
+ * 
+ * The thief's deque is empty, so nobody else changes it until the stolen records are stored
+ * 
+ * @param batch 
+ * @param thief 
+ * @return int amount of stolen records (0 if every deque is empty)
+ */
+static int batchStealRecords(batch_t *batch, batch_worker_t *thief)
+{
+    for (int victimIndex = 1; victimIndex < batch->workersCount; ++victimIndex)
+    {
+        batch_deque_t *victim = &batch->workers[(thief->index + victimIndex) % batch->workersCount].deque;
+
+        unsigned long long range = victim->range.load();
+        while ((int) (range & UINT32_MAX) < (int) (range >> 32))
+        {
+            int front   = (int) (range & UINT32_MAX);
+            int back    = (int) (range >> 32);
+            int count   = (back - front + 1) / 2;
+            if (victim->range.compare_exchange_weak(range, batchRange(front, back - count)))
+            {
+                thief->deque.range.store(batchRange(back - count, back));
+                thief->stealsCount          += 1;
+                thief->stolenRecordsCount   += count;
+
+                return count;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Function that ends the output of the run of the record with its delimiter line (it starts on a new line)
+ * 
+ * @param output 
+ * @param index index of the record
+ * @param exitCode exit code of the run
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchWriteDelimiter(cpu_output_t *output, int index, int exitCode)
+{
+    char delimiter[BATCH_DELIMITER_LENGTH] = "";
+    int length = snprintf(delimiter, sizeof(delimiter), BATCH_DELIMITER_FORMAT, index + 1, exitCode);
+    IS_OK_WO_EXIT(outputEndLine(output));
+    IS_OK_WO_EXIT(outputText(output, delimiter, (size_t) length));
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that executes the bytecode with the record as the input, the output of the run is followed by its delimiter line
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param record 
+ * @param index index of the record
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchRunRecord(text_t *byteCode, cpu_t *CPU, const text_line_t *record, int index)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL || record == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Run
+    IS_ERROR(cpuReset(CPU))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    IS_OK_WO_EXIT(inputRecord(&CPU->input, record->beginning, record->length));
+    IS_OK_WO_EXIT(cpuExecuteBytecode(byteCode, CPU));
+
+    return batchWriteDelimiter(&CPU->output, index, cpuGetExitCode(CPU));
+}
+
+/**
+ * @brief Function that publishes the result of the record (or the end of the worker if `result` is NULL) to the writer
+ * 
+ * @param batch 
+ * @param result 
+ */
+static void batchPublish(batch_t *batch, batch_result_t *result)
+{
+    {
+        std::lock_guard<std::mutex> guard(batch->resultsLock);
+        if (result != NULL)
+        {
+            result->isDone = true;
+        }
+        else
+        {
+            --batch->runningWorkersCount;
+        }
+    }
+
+    batch->resultIsDone.notify_all();
+}
+
+/**
+ * @brief Function that constructs the new virtual CPU of the worker: settings and the decoded program are taken from `CPU`
+ * 
+ * The TRACING engine records and compiles the traces while it runs, so every worker decodes the program for itself
+ * 
+ * @param worker 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchWorkerCpuCtor(cpu_t *worker, const cpu_t *CPU)
+{
+    // Error check
+    if (worker == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Settings
+    worker->RAMSize         = CPU->RAMSize;
+    worker->RAMBackend      = CPU->RAMBackend;
+    worker->hugePages       = CPU->hugePages;
+    worker->outputFormat    = CPU->outputFormat;
+    worker->inputFormat     = CPU->inputFormat;
+    worker->maxCallDepth    = CPU->maxCallDepth;
+    worker->budget          = CPU->budget;
+    worker->engine          = CPU->engine;
+    worker->paranoid        = CPU->paranoid;
+    worker->verify          = CPU->verify;
+    worker->verified        = CPU->verified;
+    worker->fusion          = CPU->fusion;
+    worker->tosCaching      = CPU->tosCaching;
+    worker->stats.enabled   = CPU->stats.enabled;
+    worker->captureOutput   = true;
+
+    // Decoded program and native code
+    worker->ownsProgram = CPU->engine == CPU_ENGINES::TRACING;
+    if (!worker->ownsProgram)
+    {
+        worker->program = CPU->program;
+        worker->jit     = CPU->jit;
+    }
+
+    return cpuCtor(worker);
+}
+
+/**
+ * @brief Function of the worker thread: runs the records of its deque, then steals the records of the others until all are empty
+ * 
+ * @param batch 
+ * @param worker 
+ */
+static void batchWorker(batch_t *batch, batch_worker_t *worker)
+{
+    cpu_t CPU = {};
+    IS_ERROR(batchWorkerCpuCtor(&CPU, batch->CPU))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(BATCH_EXIT_CODES::ERROR_CONSTRUCTING_WORKER_CPU);
+        worker->exitCode = EXIT_CODES::CONSTRUCTOR_ERROR;
+        batchPublish(batch, NULL);
+        return;
+    }
+
+    // Runs
+    for (;;)
+    {
+        int record = 0;
+        if (!batchTakeRecord(&worker->deque, &record))
+        {
+            if (batchStealRecords(batch, worker) == 0)
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        batch_result_t *result = &batch->results[record];
+        IS_ERROR(batchRunRecord(batch->byteCode, &CPU, &batch->records->lines[record], record))
+        {
+            worker->exitCode = EXIT_CODES::BAD_OBJECT_PASSED;
+            break;
+        }
+        IS_ERROR(outputTake(&CPU.output, &result->text, &result->length))
+        {
+            worker->exitCode = EXIT_CODES::BAD_STD_FUNC_RESULT;
+            break;
+        }
+        result->exitCode = cpuGetExitCode(&CPU);
+        worker->seconds += batchSeconds(startTime);
+
+        worker->runsCount       += 1;
+        worker->failedRunsCount += cpuGetExitCode(&CPU) != EXIT_SUCCESS;
+        batchPublish(batch, result);
+    }
+
+    // Statistics
+    worker->stats.commands          = CPU.stats.commands;
+    worker->stats.fusedCommands     = CPU.stats.fusedCommands;
+    worker->stats.nativeCommands    = CPU.stats.nativeCommands;
+
+    IS_ERROR(cpuDtor(&CPU))
+    {
+        worker->exitCode = EXIT_CODES::DESTRUCTOR_ERROR;
+    }
+    batchPublish(batch, NULL);
+}
+
+/**
+ * @brief Function that executes the records on the calling thread (the output goes straight to the output of `CPU`)
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param records 
+ * @param failedRunsCount 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchExecuteSequential(text_t *byteCode, cpu_t *CPU, const text_t *records, int *failedRunsCount)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for (int record = 0; record < records->lines_count; ++record)
+    {
+        IS_ERROR(batchRunRecord(byteCode, CPU, &records->lines[record], record))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+        *failedRunsCount += cpuGetExitCode(CPU) != EXIT_SUCCESS;
+    }
+    IS_OK_WO_EXIT(outputFlush(&CPU->output));
+
+    // Throughput
+    double seconds = batchSeconds(startTime);
+    if (CPU->stats.enabled)
+    {
+        fprintf(stderr, YELLOW "[BATCH]" RESET " runs: %d, failed: %d, threads: 1, time: %.3lf s, %.1lf runs/s\n",
+                records->lines_count, *failedRunsCount, seconds, seconds > 0 ? records->lines_count / seconds : 0);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that writes the output of the lane of the group and its delimiter line, the handed off lane is finished by `CPU` first
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param lockstep 
+ * @param lane 
+ * @param index index of the record of the lane
+ * @param exitCode exit code of the run
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchFinishLane(text_t *byteCode, cpu_t *CPU, lockstep_t *lockstep, int lane, int index, int *exitCode)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL || lockstep == NULL || exitCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // The rest of the run is scalar
+    if (lockstep->lanes[lane].state == LOCKSTEP_LANE_STATES::HANDED_OFF)
+    {
+        IS_ERROR(cpuReset(CPU))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+        IS_ERROR(lockstepHandOff(lockstep, lane, CPU))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+        IS_OK_WO_EXIT(cpuExecuteBytecode(byteCode, CPU));
+
+        *exitCode = cpuGetExitCode(CPU);
+        return batchWriteDelimiter(&CPU->output, index, *exitCode);
+    }
+
+    // `halt` of the lane
+    char *text = NULL;
+    size_t length = 0;
+    IS_ERROR(outputTake(&lockstep->lanes[lane].output, &text, &length))
+    {
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    EXIT_CODES outputExitCode = outputText(&CPU->output, text, length);
+    free(text);
+    IS_ERROR(outputExitCode)
+    {
+        return outputExitCode;
+    }
+
+    *exitCode = EXIT_SUCCESS;
+    return batchWriteDelimiter(&CPU->output, index, *exitCode);
+}
+
+/**
+ * @brief Function that executes the records by groups of `lanesCount` in lockstep on the calling thread (see `lockstepExecuteGroup`)
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param records 
+ * @param lanesCount 
+ * @param failedRunsCount 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchExecuteLockstep(text_t *byteCode, cpu_t *CPU, const text_t *records, int lanesCount, int *failedRunsCount)
+{
+    lockstep_t lockstep = {};
+    IS_ERROR(lockstepCtor(&lockstep, byteCode, CPU, lanesCount))
+    {
+        IS_OK_WO_EXIT(lockstepDtor(&lockstep));
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::CONSTRUCTOR_ERROR);
+        return EXIT_CODES::CONSTRUCTOR_ERROR;
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+    for (int first = 0; first < records->lines_count && exitCode == EXIT_CODES::NO_ERRORS; first += lanesCount)
+    {
+        int count = records->lines_count - first < lanesCount ? records->lines_count - first : lanesCount;
+        IS_ERROR(lockstepExecuteGroup(&lockstep, &records->lines[first], count))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+            exitCode = EXIT_CODES::BAD_OBJECT_PASSED;
+            break;
+        }
+
+        for (int lane = 0; lane < count; ++lane)
+        {
+            int runExitCode = EXIT_SUCCESS;
+            IS_ERROR(batchFinishLane(byteCode, CPU, &lockstep, lane, first + lane, &runExitCode))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+                exitCode = EXIT_CODES::BAD_OBJECT_PASSED;
+                break;
+            }
+            *failedRunsCount += runExitCode != EXIT_SUCCESS;
+        }
+    }
+    IS_OK_WO_EXIT(outputFlush(&CPU->output));
+    double seconds = batchSeconds(startTime);
+
+    // Lanes report
+    const lockstep_stats_t *stats = &lockstep.stats;
+    CPU->stats.commands += stats->laneCommands;
+    if (CPU->stats.enabled)
+    {
+        fprintf(stderr, YELLOW "[LOCKSTEP]" RESET " lanes: %d (%s), groups: %d, steps: %llu, lanes busy: %.1lf%%, divergent steps: %llu, handed off: %d\n",
+                lanesCount, lockstep.avx2 ? "AVX2" : "generic", stats->groupsCount, stats->steps,
+                stats->steps > 0 ? 100.0 * (double) stats->laneCommands / (double) (stats->steps * (unsigned long long) lanesCount) : 0,
+                stats->divergentSteps, stats->handOffsCount);
+        fprintf(stderr, YELLOW "[BATCH]" RESET " runs: %d, failed: %d, lanes: %d, time: %.3lf s, %.1lf runs/s\n",
+                records->lines_count, *failedRunsCount, lanesCount, seconds, seconds > 0 ? records->lines_count / seconds : 0);
+    }
+
+    IS_OK_WO_EXIT(lockstepDtor(&lockstep));
+
+    return exitCode;
+}
+
+/**
+ * @brief Function that executes the records on the worker threads and writes their outputs in the order of the records
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param records 
+ * @param threadsCount 
+ * @param failedRunsCount 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES batchExecuteParallel(text_t *byteCode, cpu_t *CPU, const text_t *records, int threadsCount, int *failedRunsCount)
+{
+    // Decoding (and translation) is shared by the workers
+    IS_ERROR(cpuLoadProgram(byteCode, CPU))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DECODING_BYTECODE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    batch_t batch = {};
+    batch.byteCode              = byteCode;
+    batch.CPU                   = CPU;
+    batch.records               = records;
+    batch.workersCount          = threadsCount;
+    batch.runningWorkersCount   = threadsCount;
+
+    batch.results = (batch_result_t *) calloc((size_t) records->lines_count + 1, sizeof(batch_result_t));
+    batch.workers = new (std::nothrow) batch_worker_t[threadsCount];
+    std::thread *threads = new (std::nothrow) std::thread[threadsCount];
+    if (batch.results == NULL || batch.workers == NULL || threads == NULL)
+    {
+        free(batch.results);
+        delete[] batch.workers;
+        delete[] threads;
+        PRINT_ERROR_TRACING_MESSAGE(BATCH_EXIT_CODES::ERROR_ALLOCATING_WORKERS);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    // Every worker starts with the contiguous part of the records
+    for (int worker = 0; worker < threadsCount; ++worker)
+    {
+        batch.workers[worker].index = worker;
+        batch.workers[worker].deque.range.store(batchRange((int) ((long long) records->lines_count * worker / threadsCount),
+                                                           (int) ((long long) records->lines_count * (worker + 1) / threadsCount)));
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+    int startedCount = 0;
+    for (; startedCount < threadsCount; ++startedCount)
+    {
+        try
+        {
+            threads[startedCount] = std::thread(batchWorker, &batch, &batch.workers[startedCount]);
+        }
+        catch (const std::system_error &)
+        {
+            // Records of the worker that is not started are stolen by the others
+            PRINT_ERROR_TRACING_MESSAGE(BATCH_EXIT_CODES::ERROR_STARTING_WORKER);
+            batchPublish(&batch, NULL);
+        }
+    }
+
+    // Outputs are written in the order of the records as soon as they are done
+    for (int record = 0; record < records->lines_count; ++record)
+    {
+        batch_result_t *result = &batch.results[record];
+        {
+            std::unique_lock<std::mutex> lock(batch.resultsLock);
+            batch.resultIsDone.wait(lock, [&batch, result] { return result->isDone || batch.runningWorkersCount == 0; });
+        }
+
+        if (!result->isDone)
+        {
+            exitCode = EXIT_CODES::BAD_OBJECT_PASSED;
+            break;
+        }
+        IS_OK_WO_EXIT(outputText(&CPU->output, result->text, result->length));
+        *failedRunsCount += result->exitCode != EXIT_SUCCESS;
+    }
+    IS_OK_WO_EXIT(outputFlush(&CPU->output));
+
+    for (int worker = 0; worker < startedCount; ++worker)
+    {
+        if (threads[worker].joinable())
+        {
+            threads[worker].join();
+        }
+    }
+    double seconds = batchSeconds(startTime);
+
+    // Scaling report
+    for (int worker = 0; worker < threadsCount; ++worker)
+    {
+        const batch_worker_t *statistics = &batch.workers[worker];
+        if (CPU->stats.enabled)
+        {
+            fprintf(stderr, YELLOW "[BATCH]" RESET " thread %d: runs: %d, steals: %d (%d records), time: %.3lf s, %.1lf runs/s\n",
+                    worker, statistics->runsCount, statistics->stealsCount, statistics->stolenRecordsCount, statistics->seconds,
+                    statistics->seconds > 0 ? statistics->runsCount / statistics->seconds : 0);
+        }
+
+        CPU->stats.commands         += statistics->stats.commands;
+        CPU->stats.fusedCommands    += statistics->stats.fusedCommands;
+        CPU->stats.nativeCommands   += statistics->stats.nativeCommands;
+        if (statistics->exitCode != EXIT_CODES::NO_ERRORS)
+        {
+            exitCode = statistics->exitCode;
+        }
+    }
+    if (CPU->stats.enabled)
+    {
+        fprintf(stderr, YELLOW "[BATCH]" RESET " runs: %d, failed: %d, threads: %d, time: %.3lf s, %.1lf runs/s\n",
+                records->lines_count, *failedRunsCount, threadsCount, seconds, seconds > 0 ? records->lines_count / seconds : 0);
+    }
+
+    for (int record = 0; record < records->lines_count; ++record)
+    {
+        free(batch.results[record].text);
+    }
+    free(batch.results);
+    delete[] batch.workers;
+    delete[] threads;
+
+    return exitCode;
+}
+
+/**
+ * @brief Function that executes the bytecode once per record (non-empty line of `records`, it is the input of the run)
+ * 
+ * The program is loaded and decoded (or compiled) once, every worker thread resets its own virtual CPU in place between the runs.
+ * Records are split between the workers, the worker that is out of records steals half of the records of another one.
+ * With `lanesCount` lanes the records are run by groups in lockstep instead (on the calling thread).
+ * The output of every run ends with the line of BATCH_DELIMITER_FORMAT (in the order of the records), the throughput is printed to stderr
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param records 
+ * @param threadsCount amount of worker threads (1 for the runs on the calling thread)
+ * @param lanesCount amount of records run in lockstep (1 for the scalar runs)
+ * @param failedRunsCount amount of runs that did not exit with EXIT_SUCCESS
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteBatch(text_t *byteCode, cpu_t *CPU, const text_t *records, int threadsCount, int lanesCount, int *failedRunsCount)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL || records == NULL || failedRunsCount == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (threadsCount <= 0 || lanesCount <= 0 || (threadsCount != 1 && lanesCount != 1))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Runs (`--stats` counts the CPU time of all of them)
+    clock_t startTime = clock();
+    *failedRunsCount = 0;
+    EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+    if (lanesCount != 1)
+    {
+        exitCode = batchExecuteLockstep(byteCode, CPU, records, lanesCount, failedRunsCount);
+    }
+    else
+    {
+        exitCode = threadsCount == 1 ? batchExecuteSequential(byteCode, CPU, records, failedRunsCount)
+                                     : batchExecuteParallel(byteCode, CPU, records, threadsCount, failedRunsCount);
+    }
+    CPU->stats.startTime = startTime;
+
+    return exitCode;
+}
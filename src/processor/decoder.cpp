@@ -0,0 +1,620 @@
+#include <string.h>  // for memcpy
+
+#include "include/opcodes.h"
+#include "include/processor/decoder.h"
+#include "include/processor/settings.h"
+
+static_assert(MAX_OPERAND_ARGS >= (GET_TOTAL_ARGS(0xFF)), "Every operand the bytecode can encode is decoded");
+
+/**
+ * @brief Get the operand type of the command (based on its opcode)
+ * 
+ * @param opcode 
+ * @param type 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES getOperandType(byte opcode, OPERAND_TYPES *type)
+{
+    // Error check
+    if (type == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Get operand type
+    #define OPDEF(unused1, opcode, unused2, argType, ...)  \
+        case ((byte) opcode): *type = OPERAND_TYPES::argType; return EXIT_CODES::NO_ERRORS;
+
+    switch (opcode)
+    {
+        #include "include/opdefs.h"
+
+        default:
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    #undef OPDEF
+}
+
+/**
+ * @brief Function that decodes MRI-encoded operand (registers and immediates) of one command
+ * 
+ * @param byteCode 
+ * @param ip 
+ * @param command 
+ * @param extra all the arguments of the operand (used if the command can not keep them, see `decoded_extra_regs_t`)
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES decodeValueOperand(text_t *byteCode, size_t *ip, decoded_command_t *command, decoded_extra_regs_t *extra)
+{
+    // Error check
+    if (byteCode == NULL || ip == NULL || command == NULL || extra == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    if (*ip >= byteCode->size)
+    {
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Get metainfo
+    size_t argc     = (size_t) GET_TOTAL_ARGS(byteCode->data[*ip]);
+    command->MRI    = (byte)   GET_GLOBAL_MRI(byteCode->data[*ip]);
+    ++(*ip);
+
+    // Decode arguments (registers are summed at runtime, immediates right now)
+    int regsCount       = 0;
+    int intRegsCount    = 0;
+    int termsCount      = 0;        // Immediates and common registers (summed in the order of the arguments by `switch` engine)
+    bool isReordered    = false;    // Immediate follows the common register, so the sum of the immediates is not the first term
+    for (size_t arg = 0; arg < argc; ++arg)
+    {
+        if (*ip >= byteCode->size)
+        {
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        if (MRI_IS_REGISTER(byteCode->data[*ip]))
+        {
+            ++(*ip);
+            if (*ip + sizeof(byte) > byteCode->size)
+            {
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            byte regCode = (byte) byteCode->data[*ip];
+            if (IS_INT_REGISTER_CODE(regCode))
+            {
+                if (arg == 0)
+                {
+                    command->intDestination = (byte) (regCode - INT_REGS_BASE);
+                }
+                if (intRegsCount < MAX_DECODED_REGS)
+                {
+                    command->intRegs[intRegsCount] = (byte) (regCode - INT_REGS_BASE);
+                }
+                ++intRegsCount;
+            }
+            else if (regCode < MAX_REGS_COUNT)
+            {
+                if (arg == 0)
+                {
+                    command->destination = regCode;
+                }
+                if (regsCount < MAX_DECODED_REGS)
+                {
+                    command->regs[regsCount] = regCode;
+                }
+                ++regsCount;
+                ++termsCount;
+            }
+            else
+            {
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+            extra->codes[extra->count++] = regCode;
+
+            *ip += sizeof(byte);
+        }
+        else if (MRI_IS_IMMEDIATE(byteCode->data[*ip]))
+        {
+            ++(*ip);
+            if (*ip + sizeof(double) > byteCode->size)
+            {
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            double immediate = 0;
+            memcpy(&immediate, &byteCode->data[*ip], sizeof(double));
+            command->immediate += immediate;
+
+            isReordered = isReordered || regsCount != 0;
+            ++termsCount;
+            extra->immediates[extra->count] = immediate;
+            extra->codes[extra->count++]    = EXTRA_IMMEDIATE_CODE;
+
+            *ip += sizeof(double);
+        }
+        else
+        {
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+
+    // Operand the command can not keep is evaluated from `extraRegs` of the program (behind the integer registers check),
+    // two terms are added in any order
+    if (regsCount > MAX_DECODED_REGS || intRegsCount > MAX_DECODED_REGS || (isReordered && termsCount > 2))
+    {
+        for (int reg = 0; reg < MAX_DECODED_REGS; ++reg)
+        {
+            command->regs[reg]      = ZERO_REGISTER;
+            command->intRegs[reg]   = ZERO_INT_REGISTER;
+        }
+        command->intRegs[0] = EXTRA_INT_REGISTER;
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+    extra->count = 0;
+
+    // RAM address of integer registers only is computed without double arithmetic (if the displacement is integral)
+    command->intAddress = MRI_IS_MEMORY(command->MRI) && regsCount == 0 && intRegsCount != 0 && IS_INTEGRAL(command->immediate);
+    if (command->intAddress)
+    {
+        command->intImmediate = (long long) command->immediate;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that decodes the operand of INTEGER command (destination register, source register or immediate)
+ * 
+ * @param byteCode 
+ * @param ip 
+ * @param command 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES decodeIntegerOperand(text_t *byteCode, size_t *ip, decoded_command_t *command)
+{
+    // Error check
+    if (byteCode == NULL || ip == NULL || command == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    if (*ip + 2 * sizeof(byte) > byteCode->size || !IS_INT_REGISTER_CODE((byte) byteCode->data[*ip]))
+    {
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Destination
+    command->intDestination = (byte) ((byte) byteCode->data[(*ip)++] - INT_REGS_BASE);
+
+    // Source (the other one of register and immediate is zero)
+    byte sourceMRI = (byte) byteCode->data[(*ip)++];
+    if (MRI_IS_REGISTER(sourceMRI))
+    {
+        if (*ip + sizeof(byte) > byteCode->size || !IS_INT_REGISTER_CODE((byte) byteCode->data[*ip]))
+        {
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        command->intRegs[0] = (byte) ((byte) byteCode->data[*ip] - INT_REGS_BASE);
+        *ip += sizeof(byte);
+    }
+    else if (MRI_IS_IMMEDIATE(sourceMRI))
+    {
+        if (*ip + sizeof(long long) > byteCode->size)
+        {
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        memcpy(&command->intImmediate, &byteCode->data[*ip], sizeof(long long));
+        *ip += sizeof(long long);
+    }
+    else
+    {
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that decodes one command of the bytecode (`ip` is moved to the next command)
+ * 
+ * @param byteCode 
+ * @param ip 
+ * @param command 
+ * @param extra registers of the operand that has more of them than the command keeps (`count` is 0 otherwise)
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES decodeCommand(text_t *byteCode, size_t *ip, decoded_command_t *command, decoded_extra_regs_t *extra)
+{
+    // Error check
+    if (byteCode == NULL || ip == NULL || command == NULL || extra == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Decode opcode
+    command->address        = (offset) *ip;
+    command->opcode         = (byte) byteCode->data[(*ip)++];
+    command->destination    = ZERO_REGISTER;
+    command->intDestination = ZERO_INT_REGISTER;
+    for (int reg = 0; reg < MAX_DECODED_REGS; ++reg)
+    {
+        command->regs[reg]      = ZERO_REGISTER;
+        command->intRegs[reg]   = ZERO_INT_REGISTER;
+    }
+
+    OPERAND_TYPES type = OPERAND_TYPES::NONE;
+    IS_ERROR(getOperandType((byte) command->opcode, &type))
+    {
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Decode operand
+    switch (type)
+    {
+        case OPERAND_TYPES::VALUE:
+            IS_ERROR(decodeValueOperand(byteCode, ip, command, extra))
+            {
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+            break;
+        case OPERAND_TYPES::LABEL:
+        {
+            if (*ip + sizeof(offset) > byteCode->size)
+            {
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            // Raw offset is kept in `target` field until all commands are decoded (see `resolveTargets`)
+            offset displacement = 0;
+            memcpy(&displacement, &byteCode->data[*ip], sizeof(offset));
+            command->target = (int) displacement;
+
+            *ip += sizeof(offset);
+            break;
+        }
+        case OPERAND_TYPES::INTEGER:
+            IS_ERROR(decodeIntegerOperand(byteCode, ip, command))
+            {
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+            break;
+        case OPERAND_TYPES::NONE:
+            break;
+        default:
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    command->nextAddress = (offset) *ip;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that translates all label offsets into indices of decoded commands
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES resolveTargets(decoded_program_t *program)
+{
+    // Error check
+    if (program == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Resolve
+    for (int cmd = 0; cmd < program->commandsCount; ++cmd)
+    {
+        decoded_command_t *command = &program->commands[cmd];
+        if (command->opcode >= DECODED_END_OPCODE)
+        {
+            continue;
+        }
+
+        OPERAND_TYPES type = OPERAND_TYPES::NONE;
+        IS_OK_WO_EXIT(getOperandType((byte) command->opcode, &type));
+        if (type == OPERAND_TYPES::LABEL)
+        {
+            size_t displacement = (size_t) (offset) command->target;
+            command->target = displacement <= program->bytesCount ? program->commandIndex[displacement] : BAD_TARGET;
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that decodes the raw bytecode into the flat array of fixed-size commands
+ * 
+ * @param program 
+ * @param byteCode 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES decodedProgramCtor(decoded_program_t *program, text_t *byteCode)
+{
+    // Error check
+    if (program == NULL || byteCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation (every command is at least one byte long)
+    program->bytesCount = byteCode->size;
+
+    program->commands = (decoded_command_t *) calloc(byteCode->size + 1, sizeof(decoded_command_t));
+    CHECK_CALLOC_RESULT(program->commands);
+
+    program->commandIndex = (int *) calloc(byteCode->size + 1, sizeof(int));
+    CHECK_CALLOC_RESULT(program->commandIndex);
+
+    for (size_t byteIndex = 0; byteIndex <= byteCode->size; ++byteIndex)
+    {
+        program->commandIndex[byteIndex] = BAD_TARGET;
+    }
+
+    // Decode commands (stop at the first one that can not be decoded: its length is unknown)
+    size_t ip = 0;
+    program->commandsCount = 0;
+    while (ip < byteCode->size)
+    {
+        decoded_command_t *command = &program->commands[program->commandsCount];
+        program->commandIndex[ip] = program->commandsCount++;
+
+        decoded_extra_regs_t extra = {};
+        IS_ERROR(decodeCommand(byteCode, &ip, command, &extra))
+        {
+            command->opcode = DECODED_INVALID_OPCODE;
+            break;
+        }
+
+        // Operand the command can not keep (rare, the table is allocated for the first one)
+        if (extra.count != 0)
+        {
+            if (program->extraRegs == NULL)
+            {
+                program->extraRegs = (decoded_extra_regs_t *) calloc(byteCode->size + 1, sizeof(decoded_extra_regs_t));
+                CHECK_CALLOC_RESULT(program->extraRegs);
+            }
+            program->extraRegs[program->commandsCount - 1] = extra;
+        }
+    }
+
+    // End of program sentinel
+    decoded_command_t *end = &program->commands[program->commandsCount];
+    end->opcode     = DECODED_END_OPCODE;
+    end->address    = (offset) byteCode->size;
+    if (ip >= byteCode->size)
+    {
+        program->commandIndex[byteCode->size] = program->commandsCount;
+    }
+
+    for (int cmd = 0; cmd <= program->commandsCount; ++cmd)
+    {
+        program->commands[cmd].handler = program->commands[cmd].opcode;
+    }
+
+    IS_OK_WO_EXIT(resolveTargets(program));
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that replaces sequences of decoded commands with superinstructions (see `include/fusedefs.h`)
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES fuseDecodedCommands(decoded_program_t *program)
+{
+    // Error check
+    if (program == NULL || program->commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Patterns are matched against original opcodes, so sequences may overlap (only the first command's handler is replaced)
+    #define IS(index, opMnemonics)  (commands[index].opcode == OPCODE_##opMnemonics)
+    #define IS_MOVABLE(index)       (MRI_IS_MEMORY(commands[index].MRI) || commands[index].destination != ZERO_REGISTER)
+
+    #define FUSEDEF(fusedName, sequenceLength, pattern, ...)                    \
+        if (cmd + sequenceLength <= program->commandsCount && (pattern))        \
+        {                                                                       \
+            program->commands[cmd].handler = FUSED_OPCODE_##fusedName;          \
+            ++program->fusedCount;                                              \
+            continue;                                                           \
+        }
+
+    program->fusedCount = 0;
+    for (int cmd = 0; cmd < program->commandsCount; ++cmd)
+    {
+        const decoded_command_t *commands = &program->commands[cmd];
+
+        #include "include/fusedefs.h"
+    }
+
+    #undef FUSEDEF
+    #undef IS_MOVABLE
+    #undef IS
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that determines whether the command always transfers the control (the command after it is not run next)
+ * 
+ * @param opcode 
+ * @return bool 
+ */
+static bool isBlockEnd(int opcode)
+{
+    switch (opcode)
+    {
+        case OPCODE_jmp:
+        case OPCODE_call:
+        case OPCODE_ret:
+        case OPCODE_vcall:
+        case OPCODE_vret:
+        case OPCODE_halt:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Function that determines whether the command is the conditional jump (the command after it is run if it is not taken)
+ * 
+ * @param opcode 
+ * @return bool 
+ */
+static bool isBranch(int opcode)
+{
+    switch (opcode)
+    {
+        case OPCODE_je:
+        case OPCODE_jl:
+        case OPCODE_jg:
+        case OPCODE_jne:
+        case OPCODE_fje:
+        case OPCODE_fjne:
+        case OPCODE_fjl:
+        case OPCODE_fjle:
+        case OPCODE_fjg:
+        case OPCODE_fjge:
+        case OPCODE_fjeof:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Get the amount of commands the handler executes (the length of the superinstruction or 1)
+ * 
+ * @param handler 
+ * @return int 
+ */
+static int getHandlerLength(int handler)
+{
+    #define FUSEDEF(fusedName, sequenceLength, ...)     \
+        case FUSED_OPCODE_##fusedName: return sequenceLength;
+
+    switch (handler)
+    {
+        #include "include/fusedefs.h"
+
+        default:
+            return 1;
+    }
+
+    #undef FUSEDEF
+}
+
+/**
+ * @brief Function that precomputes the costs of the blocks and of the jumps between them (metered runs)
+ * 
+ * The block goes on through the branches that are not taken up to the next jump, call, return or halt, so it is charged once
+ * when the control comes to it. The taken branch is charged the cost of its target minus the cost of the rest of its block
+ * (the commands that are not run are given back). The handlers are followed as they are dispatched (after `fuseDecodedCommands`):
+ * the jump into the middle of a superinstruction runs its commands one by one, so both paths have their own costs
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES meterDecodedCommands(decoded_program_t *program)
+{
+    // Error check
+    if (program == NULL || program->commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation (the sentinel costs nothing)
+    free(program->blockCosts);
+    free(program->jumpCosts);
+
+    program->blockCosts = (int *) calloc((size_t) program->commandsCount + 1, sizeof(int));
+    CHECK_CALLOC_RESULT(program->blockCosts);
+
+    program->jumpCosts = (int *) calloc((size_t) program->commandsCount + 1, sizeof(int));
+    CHECK_CALLOC_RESULT(program->jumpCosts);
+
+    // Blocks (the block of every handler goes on with the block of the next one unless the control is transferred)
+    for (int cmd = program->commandsCount - 1; cmd >= 0; --cmd)
+    {
+        int length  = getHandlerLength(program->commands[cmd].handler);
+        int last    = cmd + length - 1;
+
+        program->blockCosts[cmd] = length + (isBlockEnd(program->commands[last].opcode) ? 0 : program->blockCosts[cmd + length]);
+    }
+
+    // Jumps (`ret` is charged the block it returns to, `spawn` does not jump)
+    for (int cmd = 0; cmd < program->commandsCount; ++cmd)
+    {
+        int length  = getHandlerLength(program->commands[cmd].handler);
+        int last    = cmd + length - 1;
+
+        const decoded_command_t *command = &program->commands[last];
+        bool isJump = command->opcode == OPCODE_jmp || command->opcode == OPCODE_call || command->opcode == OPCODE_vcall ||
+                      isBranch(command->opcode);
+        if (!isJump || command->target == BAD_TARGET)
+        {
+            continue;
+        }
+
+        int restCost = isBranch(command->opcode) ? program->blockCosts[cmd + length] : 0;
+        program->jumpCosts[cmd] = program->blockCosts[command->target] - restCost;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that frees all the memory allocated for the decoded program
+ * 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES decodedProgramDtor(decoded_program_t *program)
+{
+    // Error check
+    if (program == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Destruction
+    free(program->commands);
+    free(program->commandIndex);
+    free(program->blockCosts);
+    free(program->jumpCosts);
+    free(program->extraRegs);
+
+    program->commands       = NULL;
+    program->commandIndex   = NULL;
+    program->blockCosts     = NULL;
+    program->jumpCosts      = NULL;
+    program->extraRegs      = NULL;
+    program->commandsCount  = 0;
+    program->bytesCount     = 0;
+    program->fusedCount     = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
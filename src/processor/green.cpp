@@ -0,0 +1,484 @@
+#include <stdio.h>      // for fprintf, fgets
+#include <stdlib.h>     // for malloc, realloc, free
+#include <string.h>     // for memchr, memmove, strlen
+#include <time.h>       // for clock
+#include <chrono>       // for std::chrono::steady_clock
+#include <new>          // for std::nothrow
+
+#include "libs/colors/colors.h"
+
+#include "include/processor/green.h"
+#include "include/processor/settings.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define GREEN_POSIX 1
+
+    #include <errno.h>      // for errno
+    #include <poll.h>       // for poll
+    #include <unistd.h>     // for read
+#else
+    #define GREEN_POSIX 0
+#endif
+
+/**
+ * @brief Function that constructs the processor of the green thread with the settings of `CPU` (nothing is left allocated on failure)
+ * 
+ * @param thread 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES greenThreadCtor(green_thread_t *thread, const cpu_t *CPU)
+{
+    // Error check
+    if (thread == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Settings
+    cpu_t *threadCPU = &thread->CPU;
+    threadCPU->RAMSize          = CPU->RAMSize;
+    threadCPU->RAMBackend       = CPU->RAMBackend;
+    threadCPU->outputFormat     = CPU->outputFormat;
+    threadCPU->inputFormat      = CPU->inputFormat;
+    threadCPU->maxCallDepth     = CPU->maxCallDepth;
+    threadCPU->engine           = CPU->engine;
+    threadCPU->paranoid         = CPU->paranoid;
+    threadCPU->verify           = CPU->verify;
+    threadCPU->verified         = CPU->verified;
+    threadCPU->stats.enabled    = CPU->stats.enabled;
+    threadCPU->isGreen          = true;
+
+    IS_ERROR(cpuCtor(threadCPU))
+    {
+        IS_OK_WO_EXIT(cpuDtor(threadCPU));
+        return EXIT_CODES::CONSTRUCTOR_ERROR;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that puts the thread at the back of the ready queue
+ * 
+ * @param scheduler 
+ * @param index index of the thread
+ */
+static void greenPushReady(green_scheduler_t *scheduler, int index)
+{
+    green_thread_t *thread = &scheduler->threads[index];
+    thread->state   = GREEN_STATES::READY;
+    thread->next    = GREEN_NO_THREAD;
+
+    if (scheduler->readyTail != GREEN_NO_THREAD)
+    {
+        scheduler->threads[scheduler->readyTail].next = index;
+    }
+    else
+    {
+        scheduler->readyHead = index;
+    }
+    scheduler->readyTail = index;
+}
+
+/**
+ * @brief Function that takes the thread from the front of the ready queue
+ * 
+ * @param scheduler 
+ * @return int index of the thread, GREEN_NO_THREAD if the queue is empty
+ */
+static int greenPopReady(green_scheduler_t *scheduler)
+{
+    int index = scheduler->readyHead;
+    if (index != GREEN_NO_THREAD)
+    {
+        scheduler->readyHead = scheduler->threads[index].next;
+        if (scheduler->readyHead == GREEN_NO_THREAD)
+        {
+            scheduler->readyTail = GREEN_NO_THREAD;
+        }
+    }
+
+    return index;
+}
+
+/**
+ * @brief Function that writes the output of the halted thread with its delimiter line and frees its processor
+ * 
+ * @param scheduler 
+ * @param index index of the thread
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES greenFinishThread(green_scheduler_t *scheduler, int index)
+{
+    green_thread_t *thread  = &scheduler->threads[index];
+    cpu_t *CPU              = scheduler->CPU;
+
+    int exitCode = cpuGetExitCode(&thread->CPU);
+    char delimiter[GREEN_DELIMITER_LENGTH] = "";
+    int length = snprintf(delimiter, sizeof(delimiter), GREEN_DELIMITER_FORMAT, index, exitCode);
+    IS_OK_WO_EXIT(outputEndLine(&thread->CPU.output));
+    IS_OK_WO_EXIT(outputText(&thread->CPU.output, delimiter, (size_t) length));
+    IS_OK_WO_EXIT(outputText(&CPU->output, thread->CPU.output.buffer, thread->CPU.output.size));
+
+    thread->state = GREEN_STATES::HALTED;
+    scheduler->haltedCount += 1;
+    scheduler->failedCount += exitCode != EXIT_SUCCESS;
+    CPU->stats.commands    += thread->CPU.stats.commands;
+
+    IS_ERROR(cpuDtor(&thread->CPU))
+    {
+        return EXIT_CODES::DESTRUCTOR_ERROR;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that appends the line `index values...` of stdin to the input of the thread `index` and makes the waiting thread ready
+ * 
+ * @param scheduler 
+ * @param line 
+ * @param length 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES greenDispatchLine(green_scheduler_t *scheduler, const char *line, size_t length)
+{
+    // Index of the thread
+    size_t position = 0;
+    while (position < length && (line[position] == ' ' || line[position] == '\t' || line[position] == '\r'))
+    {
+        ++position;
+    }
+    if (position == length || line[position] == '\n')
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    long long index = 0;
+    size_t digitsEnd = position;
+    while (digitsEnd < length && line[digitsEnd] >= '0' && line[digitsEnd] <= '9' && index < scheduler->threadsCount)
+    {
+        index = index * 10 + (line[digitsEnd] - '0');
+        ++digitsEnd;
+    }
+
+    bool isIndex = digitsEnd > position && index < scheduler->threadsCount &&
+                   (digitsEnd == length || line[digitsEnd] == ' ' || line[digitsEnd] == '\t' || line[digitsEnd] == '\r' ||
+                    line[digitsEnd] == '\n');
+    if (!isIndex || scheduler->threads[index].state == GREEN_STATES::HALTED)
+    {
+        scheduler->droppedLinesCount += 1;
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Values
+    green_thread_t *thread = &scheduler->threads[index];
+    IS_ERROR(inputAppend(&thread->CPU.input, line + digitsEnd, length - digitsEnd))
+    {
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    if (thread->state == GREEN_STATES::WAITING)
+    {
+        scheduler->waitingCount -= 1;
+        greenPushReady(scheduler, (int) index);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that closes the inputs of the threads (the rest is read, then `in` is the end of the input) and makes the waiting ones ready
+ * 
+ * @param scheduler 
+ */
+static void greenCloseInputs(green_scheduler_t *scheduler)
+{
+    scheduler->isInputEnd = true;
+    for (int index = 0; index < scheduler->threadsCount; ++index)
+    {
+        green_thread_t *thread = &scheduler->threads[index];
+        if (thread->state == GREEN_STATES::HALTED)
+        {
+            continue;
+        }
+
+        IS_OK_WO_EXIT(inputClose(&thread->CPU.input));
+        if (thread->state == GREEN_STATES::WAITING)
+        {
+            greenPushReady(scheduler, index);
+        }
+    }
+    scheduler->waitingCount = 0;
+}
+
+/**
+ * @brief Function that reads the next block of stdin (if it has one when `isBlocking` is false) and dispatches its whole lines
+ * 
+ * The end of stdin (or an error reading it) closes the inputs of the threads
+ * 
+ * @param scheduler 
+ * @param isBlocking wait for the block
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES greenReadInput(green_scheduler_t *scheduler, bool isBlocking)
+{
+    // Room for the block (the line that does not fit is kept whole)
+    if (scheduler->inputCapacity - scheduler->inputSize < GREEN_READ_SIZE)
+    {
+        size_t capacity = scheduler->inputCapacity == 0 ? GREEN_READ_SIZE : 2 * scheduler->inputCapacity;
+        char *input = (char *) realloc(scheduler->input, capacity);
+        if (input == NULL)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(GREEN_EXIT_CODES::ERROR_READING_INPUT);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+
+        scheduler->input            = input;
+        scheduler->inputCapacity    = capacity;
+    }
+
+    char *freeSpace = scheduler->input + scheduler->inputSize;
+    size_t freeSize = scheduler->inputCapacity - scheduler->inputSize;
+    bool isError    = false;
+#if GREEN_POSIX
+    // The block that has not come yet is not waited for while some threads are ready
+    struct pollfd descriptor = { fileno(stdin), POLLIN, 0 };
+    if (!isBlocking && poll(&descriptor, 1, 0) <= 0)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    ssize_t bytesRead = -1;
+    do
+    {
+        bytesRead = read(fileno(stdin), freeSpace, freeSize);
+    } while (bytesRead < 0 && errno == EINTR);
+
+    isError = bytesRead < 0;
+    size_t size = isError ? 0 : (size_t) bytesRead;
+#else
+    // The console gives one line at once, it is read only when every thread waits for the input
+    if (!isBlocking)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    size_t size = 0;
+    if (fgets(freeSpace, (int) freeSize, stdin) != NULL)
+    {
+        size = strlen(freeSpace);
+    }
+    isError = ferror(stdin) != 0;
+#endif
+    if (isError)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(GREEN_EXIT_CODES::ERROR_READING_INPUT);
+    }
+    scheduler->inputSize += size;
+
+    // Whole lines (the cut one waits for the next block, the last one is whole at the end of stdin)
+    size_t lineBegin = 0;
+    for (;;)
+    {
+        const char *lineEnd = (const char *) memchr(scheduler->input + lineBegin, '\n', scheduler->inputSize - lineBegin);
+        size_t lineLength   = lineEnd != NULL ? (size_t) (lineEnd - (scheduler->input + lineBegin)) + 1
+                                              : (size == 0 ? scheduler->inputSize - lineBegin : 0);
+        if (lineLength == 0)
+        {
+            break;
+        }
+
+        IS_OK_WO_EXIT(greenDispatchLine(scheduler, scheduler->input + lineBegin, lineLength));
+        lineBegin += lineLength;
+    }
+
+    memmove(scheduler->input, scheduler->input + lineBegin, scheduler->inputSize - lineBegin);
+    scheduler->inputSize -= lineBegin;
+
+    if (size == 0)
+    {
+        greenCloseInputs(scheduler);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that frees the processors of the threads that are not halted (the first `constructedCount` are constructed) and the scheduler
+ * 
+ * @param scheduler 
+ * @param constructedCount 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES greenDtor(green_scheduler_t *scheduler, int constructedCount)
+{
+    // Error check
+    if (scheduler == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+    for (int index = 0; scheduler->threads != NULL && index < constructedCount; ++index)
+    {
+        if (scheduler->threads[index].state != GREEN_STATES::HALTED)
+        {
+            IS_ERROR(cpuDtor(&scheduler->threads[index].CPU))
+            {
+                exitCode = EXIT_CODES::DESTRUCTOR_ERROR;
+            }
+        }
+    }
+
+    delete[] scheduler->threads;
+    free(scheduler->input);
+    *scheduler = {};
+
+    return exitCode;
+}
+
+/**
+ * @brief Function that executes `threadsCount` instances of the bytecode as green threads on the calling host thread
+ * 
+ * Every thread is a processor of its own (small buffers that grow, RAM on the heap). The scheduler runs the ready ones in turn
+ * for `quantum` commands at most. `in` that finds no value leaves the thread waiting at that command, so the thread is resumed
+ * by the next slice without saving anything. The line `index values...` of stdin is appended to the input of the thread
+ * `index` and makes it ready, the end of stdin is the end of every input. Stdin is polled once per round of the ready queue
+ * and waited for when no thread is ready. The output of the thread is written when it halts, followed by its delimiter line
+ * 
+ * @param byteCode 
+ * @param CPU processor of `main` (its settings are used for all the threads)
+ * @param threadsCount 
+ * @param quantum commands of one slice
+ * @param exitCode EXIT_SUCCESS if every thread halted without a runtime error
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteGreen(text_t *byteCode, cpu_t *CPU, int threadsCount, unsigned long long quantum, int *exitCode)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL || exitCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (threadsCount <= 0 || threadsCount > MAX_GREEN_THREADS || quantum == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(GREEN_EXIT_CODES::BAD_THREADS_COUNT);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    if (CPU->engine != CPU_ENGINES::SWITCH || CPU->inputFormat != INPUT_FORMATS::TEXT)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(GREEN_EXIT_CODES::UNSUPPORTED_ENGINE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Threads (all of them are ready to start)
+    green_scheduler_t scheduler = {};
+    scheduler.byteCode      = byteCode;
+    scheduler.CPU           = CPU;
+    scheduler.threadsCount  = threadsCount;
+    scheduler.quantum       = quantum;
+    scheduler.threads       = new (std::nothrow) green_thread_t[threadsCount];
+    if (scheduler.threads == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(GREEN_EXIT_CODES::ERROR_ALLOCATING_THREADS);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    for (int index = 0; index < threadsCount; ++index)
+    {
+        IS_ERROR(greenThreadCtor(&scheduler.threads[index], CPU))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(GREEN_EXIT_CODES::ERROR_CONSTRUCTING_THREAD_CPU);
+            IS_OK_WO_EXIT(greenDtor(&scheduler, index));
+            return EXIT_CODES::CONSTRUCTOR_ERROR;
+        }
+        greenPushReady(&scheduler, index);
+    }
+
+    // Run
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    CPU->stats.startTime = clock();
+
+    EXIT_CODES executionCode = EXIT_CODES::NO_ERRORS;
+    int slicesUntilPoll = 0;
+    while (scheduler.haltedCount < threadsCount && executionCode == EXIT_CODES::NO_ERRORS)
+    {
+        // Input (the finished outputs are written before the scheduler waits for it)
+        bool isBlocking = scheduler.readyHead == GREEN_NO_THREAD;
+        if (!scheduler.isInputEnd && scheduler.waitingCount > 0 && (isBlocking || slicesUntilPoll <= 0))
+        {
+            if (isBlocking)
+            {
+                IS_OK_WO_EXIT(outputFlush(&CPU->output));
+            }
+
+            IS_ERROR(greenReadInput(&scheduler, isBlocking))
+            {
+                executionCode = EXIT_CODES::BAD_STD_FUNC_RESULT;
+                break;
+            }
+            slicesUntilPoll = threadsCount - scheduler.waitingCount - scheduler.haltedCount;
+        }
+
+        int index = greenPopReady(&scheduler);
+        if (index == GREEN_NO_THREAD)
+        {
+            continue;
+        }
+
+        // Slice
+        green_thread_t *thread = &scheduler.threads[index];
+        IS_ERROR(cpuExecuteSlice(byteCode, &thread->CPU, scheduler.quantum))
+        {
+            executionCode = EXIT_CODES::BAD_OBJECT_PASSED;
+            break;
+        }
+        scheduler.slicesCount   += 1;
+        slicesUntilPoll         -= 1;
+
+        switch (thread->CPU.status.state)
+        {
+            case CPU_STATES::BUDGET_IS_EXHAUSTED:
+                greenPushReady(&scheduler, index);
+                break;
+
+            case CPU_STATES::WAITING_FOR_INPUT:
+                thread->state = GREEN_STATES::WAITING;
+                scheduler.waitingCount  += 1;
+                scheduler.waitsCount    += 1;
+                break;
+
+            case CPU_STATES::HALTED:
+            case CPU_STATES::TRAPPED:
+            default:
+                IS_ERROR(greenFinishThread(&scheduler, index))
+                {
+                    executionCode = EXIT_CODES::DESTRUCTOR_ERROR;
+                }
+                break;
+        }
+    }
+    IS_OK_WO_EXIT(outputFlush(&CPU->output));
+
+    if (CPU->stats.enabled)
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        fprintf(stderr, YELLOW "[GREEN]" RESET " instances: %d, failed: %d, slices: %llu, waits for input: %llu, "
+                        "dropped lines: %llu, time: %.3lf s\n",
+                threadsCount, scheduler.failedCount, scheduler.slicesCount, scheduler.waitsCount,
+                scheduler.droppedLinesCount, seconds);
+    }
+
+    *exitCode = scheduler.failedCount == 0 && scheduler.haltedCount == threadsCount ? EXIT_SUCCESS : EXIT_FAILURE;
+    IS_ERROR(greenDtor(&scheduler, threadsCount))
+    {
+        return EXIT_CODES::DESTRUCTOR_ERROR;
+    }
+
+    return executionCode;
+}
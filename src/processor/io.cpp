@@ -0,0 +1,1063 @@
+#include <stdlib.h>   // for calloc, strtod
+#include <string.h>   // for memcpy, memmove
+#include <math.h>     // for NAN
+#include <limits.h>   // for ULLONG_MAX
+#include <charconv>   // for std::to_chars
+
+#include "include/processor/io.h"
+#include "include/processor/settings.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define IO_POSIX 1
+
+    #include <errno.h>      // for errno
+    #include <unistd.h>     // for isatty, read, lseek
+    #include <sys/mman.h>   // for mmap, munmap
+    #include <sys/stat.h>   // for fstat
+#else
+    #define IO_POSIX 0
+#endif
+
+static const double EXACT_POWERS_OF_10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+static const int MAX_EXACT_POWER_OF_10    = 22;
+static const unsigned long long MAX_EXACT_MANTISSA = 1ULL << 53;
+static const int MAX_PARSED_EXPONENT      = 100000;     // Larger exponents are left to `strtod` (infinity or zero)
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Terminal output is line buffered (see `cpu_output_t::interactive`)
+static bool isTerminal(FILE *stream)
+{
+#if IO_POSIX
+    return isatty(fileno(stream)) != 0;
+#else
+    (void) stream;
+    return true;    // Unknown host: flushed before the input as a terminal
+#endif
+}
+
+/**
+ * @brief Function that writes decimal digits of the value (two per step)
+ * 
+ * @param buffer 
+ * @param value 
+ * @return size_t amount of digits
+ */
+static size_t formatUnsigned(char *buffer, unsigned long long value)
+{
+    char digits[24] = {};
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+    while (value >= 100)
+    {
+        unsigned long long pair = value % 100;
+        value /= 100;
+        begin -= 2;
+        memcpy(begin, &DIGIT_PAIRS[pair * 2], 2);
+    }
+    if (value >= 10)
+    {
+        begin -= 2;
+        memcpy(begin, &DIGIT_PAIRS[value * 2], 2);
+    }
+    else
+    {
+        *--begin = (char) ('0' + value);
+    }
+
+    size_t length = (size_t) (end - begin);
+    memcpy(buffer, begin, length);
+
+    return length;
+}
+
+/**
+ * @brief Function that writes the double as `printf("%lf")` does: the exact binary value is rounded to OUTPUT_LF_DIGITS digits
+ * after the point (ties to even)
+ * 
+ * The value is split into the integer part and the binary fraction, the fraction is scaled in 128-bit integers,
+ * so there is no rounding error. NaN, infinities and values not less than 2^64 are left to `snprintf`
+ * 
+ * @param buffer 
+ * @param value 
+ * @return size_t length of the text
+ */
+static size_t formatLf(char *buffer, double value)
+{
+    unsigned long long bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    bool negative           = (bits >> 63) != 0;
+    int biasedExponent      = (int) ((bits >> 52) & 0x7FF);
+    unsigned long long mantissa = bits & ((1ULL << 52) - 1);
+    int exponent            = 1 - 1075;    // Subnormals
+    if (biasedExponent != 0)
+    {
+        mantissa |= 1ULL << 52;
+        exponent = biasedExponent - 1075;
+    }
+
+    // value = mantissa * 2^exponent
+    if (biasedExponent == 0x7FF || exponent > 11)
+    {
+        return (size_t) snprintf(buffer, OUTPUT_MAX_DOUBLE_LENGTH, "%lf", value);
+    }
+
+    unsigned long long integerPart  = 0;
+    unsigned long long fraction     = 0;    // Scaled by OUTPUT_LF_SCALE
+    if (exponent >= 0)
+    {
+        integerPart = mantissa << exponent;
+    }
+    else if (-exponent < 74)    // Smaller values are less than 2^-21 < 0.5 / OUTPUT_LF_SCALE
+    {
+        int shift = -exponent;
+        unsigned __int128 fractionBits = mantissa;
+        if (shift < 64)
+        {
+            integerPart  = mantissa >> shift;
+            fractionBits = mantissa & ((1ULL << shift) - 1);
+        }
+
+        unsigned __int128 scaled    = fractionBits * OUTPUT_LF_SCALE;
+        unsigned __int128 rest      = scaled & (((unsigned __int128) 1 << shift) - 1);
+        unsigned __int128 half      = (unsigned __int128) 1 << (shift - 1);
+        fraction = (unsigned long long) (scaled >> shift);
+        if (rest > half || (rest == half && (fraction & 1) != 0))
+        {
+            ++fraction;
+        }
+        if (fraction == OUTPUT_LF_SCALE)
+        {
+            fraction = 0;
+            ++integerPart;
+        }
+    }
+
+    size_t length = 0;
+    if (negative)
+    {
+        buffer[length++] = '-';
+    }
+    length += formatUnsigned(buffer + length, integerPart);
+    buffer[length++] = '.';
+    for (int digit = OUTPUT_LF_DIGITS - 1; digit >= 0; --digit)
+    {
+        buffer[length + (size_t) digit] = (char) ('0' + fraction % 10);
+        fraction /= 10;
+    }
+
+    return length + OUTPUT_LF_DIGITS;
+}
+
+/**
+ * @brief Function that writes the text of the double into `buffer` of at least OUTPUT_MAX_DOUBLE_LENGTH bytes (not terminated)
+ * 
+ * @param buffer 
+ * @param value 
+ * @param format 
+ * @return size_t length of the text
+ */
+size_t formatDouble(char *buffer, double value, OUTPUT_FORMATS format)
+{
+    switch (format)
+    {
+        case OUTPUT_FORMATS::SHORTEST:
+            return (size_t) (std::to_chars(buffer, buffer + OUTPUT_MAX_DOUBLE_LENGTH, value).ptr - buffer);
+        case OUTPUT_FORMATS::LF:
+        default:
+            return formatLf(buffer, value);
+    }
+}
+
+/**
+ * @brief Function that constructs the output buffer of `capacity` bytes (at least OUTPUT_MAX_DOUBLE_LENGTH)
+ * 
+ * The output without `stream` keeps the whole text in memory (the buffer grows instead of the write) until `outputTake`
+ * 
+ * @param output 
+ * @param stream NULL for the text in memory
+ * @param capacity 
+ * @param format 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputCtor(cpu_output_t *output, FILE *stream, size_t capacity, OUTPUT_FORMATS format)
+{
+    // Error check
+    if (output == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (capacity < OUTPUT_MAX_DOUBLE_LENGTH)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Buffer
+    output->buffer = (char *) calloc(capacity, sizeof(char));
+    if (output->buffer == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_OUTPUT_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    output->stream      = stream;
+    output->size        = 0;
+    output->capacity    = capacity;
+    output->format      = format;
+    output->interactive = stream != NULL && isTerminal(stream);
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that flushes the output and frees its buffer
+ * 
+ * @param output 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputDtor(cpu_output_t *output)
+{
+    // Error check
+    if (output == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Flush (the buffer is freed anyway)
+    EXIT_CODES flushed = EXIT_CODES::NO_ERRORS;
+    if (output->buffer != NULL)
+    {
+        flushed = outputFlush(output);
+    }
+
+    free(output->buffer);
+    *output = {};
+
+    return flushed;
+}
+
+/**
+ * @brief Function that writes the buffered output to the stream (the buffer is emptied even if the write fails)
+ * 
+ * The output without the stream makes room for one more double instead (the text stays in the buffer)
+ * 
+ * @param output 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputFlush(cpu_output_t *output)
+{
+    // Error check
+    if (output == NULL || output->buffer == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Values are in the ring already
+    if (output->ring != NULL)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Text in memory
+    if (output->stream == NULL)
+    {
+        if (output->capacity - output->size < OUTPUT_MAX_DOUBLE_LENGTH)
+        {
+            char *newBuffer = (char *) realloc(output->buffer, 2 * output->capacity);
+            if (newBuffer == NULL)
+            {
+                PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_OUTPUT_BUFFER);
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+
+            output->buffer      = newBuffer;
+            output->capacity    = 2 * output->capacity;
+        }
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Write (stdio buffer is flushed too, so the text is ordered with the other output of the stream)
+    size_t written = fwrite(output->buffer, sizeof(char), output->size, output->stream);
+    bool isWritten = written == output->size && fflush(output->stream) == 0;
+    if (output->size > 0)
+    {
+        output->lastWritten = output->buffer[output->size - 1];
+    }
+    output->size = 0;
+    if (!isWritten)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_WRITING_OUTPUT);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that appends the text of the double in the format of the output (it is flushed first if the text may not fit)
+ * 
+ * @param output 
+ * @param value 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputDouble(cpu_output_t *output, double value)
+{
+    // Error check
+    if (output == NULL || output->buffer == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Next stage of the pipeline gets the value as it is (it is dropped if the stage halted)
+    ++output->valuesCount;
+    if (output->ring != NULL)
+    {
+        ringPush(output->ring, value);
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Append
+    if (output->capacity - output->size < OUTPUT_MAX_DOUBLE_LENGTH)
+    {
+        IS_ERROR(outputFlush(output))
+        {
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+    output->size += formatDouble(output->buffer + output->size, value, output->format);
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that appends a single character (it is flushed first if the buffer is full)
+ * 
+ * @param output 
+ * @param character 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputChar(cpu_output_t *output, char character)
+{
+    // Error check
+    if (output == NULL || output->buffer == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Characters only separate the text of the values
+    if (output->ring != NULL)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Append
+    if (output->size == output->capacity)
+    {
+        IS_ERROR(outputFlush(output))
+        {
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+    output->buffer[output->size++] = character;
+
+    // Terminals see every line as soon as it is finished (the same as line buffered stdout)
+    if (output->interactive && character == '\n')
+    {
+        return outputFlush(output);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+static bool isSpace(char character)
+{
+    return character == ' ' || character == '\n' || character == '\t' || character == '\r' || character == '\v' || character == '\f';
+}
+
+static bool isDigit(char character)
+{
+    return character >= '0' && character <= '9';
+}
+
+/**
+ * @brief Function that parses the whole word by `strtod` (infinities, NaN, hexadecimal and long numbers)
+ * 
+ * @param text 
+ * @param length 
+ * @param value 
+ * @return bool the word is a number
+ */
+static bool parseDoubleSlow(const char *text, size_t length, double *value)
+{
+    if (length == 0 || length > INPUT_MAX_WORD_LENGTH)
+    {
+        return false;
+    }
+
+    char word[INPUT_MAX_WORD_LENGTH + 1] = {};
+    memcpy(word, text, length);
+
+    char *end = NULL;
+    *value = strtod(word, &end);
+
+    return end == word + length;
+}
+
+/**
+ * @brief Function that parses the whole text of the double (the same syntax as `strtod`, the fast path is exact)
+ * 
+ * Decimal numbers of up to 19 significant digits with the mantissa up to 2^53 and the exponent up to 10^22 are
+ * the exact mantissa multiplied or divided by the exact power of 10 (one rounding, so the result is the same as `strtod` gives),
+ * the rest is left to `strtod`
+ * 
+ * @param text 
+ * @param length 
+ * @param value 
+ * @return bool the text is a number
+ */
+bool parseDouble(const char *text, size_t length, double *value)
+{
+    // Error check
+    if (text == NULL || value == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return false;
+    }
+
+    const char *current = text;
+    const char *end     = text + length;
+
+    bool negative = false;
+    if (current < end && (*current == '-' || *current == '+'))
+    {
+        negative = *current == '-';
+        ++current;
+    }
+
+    // Mantissa: digits that do not fit are left to `strtod`
+    unsigned long long mantissa = 0;
+    int exponent        = 0;
+    bool hasDigits      = false;
+    bool isTooLong      = false;
+    for (; current < end && isDigit(*current); ++current)
+    {
+        isTooLong |= mantissa > (ULLONG_MAX - 9) / 10;
+        mantissa = mantissa * 10 + (unsigned long long) (*current - '0');
+        hasDigits = true;
+    }
+    if (current < end && *current == '.')
+    {
+        for (++current; current < end && isDigit(*current); ++current)
+        {
+            isTooLong |= mantissa > (ULLONG_MAX - 9) / 10;
+            mantissa = mantissa * 10 + (unsigned long long) (*current - '0');
+            --exponent;
+            hasDigits = true;
+        }
+    }
+
+    // Exponent
+    if (hasDigits && current < end && (*current == 'e' || *current == 'E'))
+    {
+        const char *exponentBegin = current++;
+        bool negativeExponent = false;
+        if (current < end && (*current == '-' || *current == '+'))
+        {
+            negativeExponent = *current == '-';
+            ++current;
+        }
+
+        int explicitExponent = 0;
+        bool hasExponentDigits = false;
+        for (; current < end && isDigit(*current); ++current)
+        {
+            explicitExponent = explicitExponent < MAX_PARSED_EXPONENT ? explicitExponent * 10 + (*current - '0') : explicitExponent;
+            hasExponentDigits = true;
+        }
+
+        if (!hasExponentDigits)
+        {
+            current = exponentBegin;    // Not a number as a whole (`strtod` stops before `e`)
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    // Fast path
+    if (hasDigits && !isTooLong && current == end && mantissa <= MAX_EXACT_MANTISSA &&
+        exponent >= -MAX_EXACT_POWER_OF_10 && exponent <= MAX_EXACT_POWER_OF_10)
+    {
+        double result = (double) mantissa;
+        result = exponent < 0 ? result / EXACT_POWERS_OF_10[-exponent] : result * EXACT_POWERS_OF_10[exponent];
+        *value = negative ? -result : result;
+
+        return true;
+    }
+
+    return parseDoubleSlow(text, length, value);
+}
+
+/**
+ * @brief Function that appends the text of `length` bytes (it is flushed by parts if it does not fit)
+ * 
+ * @param output 
+ * @param text 
+ * @param length 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputText(cpu_output_t *output, const char *text, size_t length)
+{
+    // Error check
+    if (output == NULL || output->buffer == NULL || (text == NULL && length > 0))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Characters only separate the text of the values
+    if (output->ring != NULL)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Append
+    while (length > 0)
+    {
+        if (output->size == output->capacity)
+        {
+            IS_ERROR(outputFlush(output))
+            {
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+        }
+
+        size_t part = output->capacity - output->size < length ? output->capacity - output->size : length;
+        memcpy(output->buffer + output->size, text, part);
+        output->size    += part;
+        text            += part;
+        length          -= part;
+    }
+
+    if (output->interactive)
+    {
+        return outputFlush(output);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that appends a new line if the text does not end with one (the empty text does not need it)
+ * 
+ * @param output 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputEndLine(cpu_output_t *output)
+{
+    // Error check
+    if (output == NULL || output->buffer == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Last character is either buffered or written already
+    char last = output->size > 0 ? output->buffer[output->size - 1] : output->lastWritten;
+    if (last != '\n')
+    {
+        return outputChar(output, '\n');
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that gives the text of the output without the stream away and empties the output
+ * 
+ * @param output 
+ * @param text allocated copy of the text (it is freed by the caller)
+ * @param length 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES outputTake(cpu_output_t *output, char **text, size_t *length)
+{
+    // Error check
+    if (output == NULL || output->buffer == NULL || text == NULL || length == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (output->stream != NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Copy
+    *text = (char *) malloc(output->size + 1);
+    if (*text == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_OUTPUT_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    memcpy(*text, output->buffer, output->size);
+    *length = output->size;
+
+    if (output->size > 0)
+    {
+        output->lastWritten = output->buffer[output->size - 1];
+    }
+    output->size = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that constructs the input of the stream (it is mapped if it is a regular file, otherwise it is read by blocks of `capacity` bytes)
+ * 
+ * @param input 
+ * @param stream NULL for the text that is appended (the buffer of `capacity` bytes is allocated by the first `inputAppend`)
+ * @param capacity 
+ * @param format 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputCtor(cpu_input_t *input, FILE *stream, size_t capacity, INPUT_FORMATS format)
+{
+    // Error check
+    if (input == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (capacity == 0 || (stream != NULL && capacity <= INPUT_MAX_WORD_LENGTH))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    *input = {};
+    input->stream   = stream;
+    input->format   = format;
+
+    // Appended text (the words are whole, so the buffer may be shorter than the longest one)
+    if (stream == NULL)
+    {
+        input->capacity = capacity;
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+#if IO_POSIX
+    // Regular file is mapped from the current offset of the stream to its end
+    int descriptor = fileno(stream);
+    struct stat info = {};
+    if (fstat(descriptor, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        off_t offset = lseek(descriptor, 0, SEEK_CUR);
+        void *mapping = MAP_FAILED;
+        if (offset >= 0 && offset < info.st_size)
+        {
+            mapping = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        }
+
+        if (mapping != MAP_FAILED)
+        {
+            madvise(mapping, (size_t) info.st_size, MADV_SEQUENTIAL);
+            input->mapping      = mapping;
+            input->mappingSize  = (size_t) info.st_size;
+            input->data         = (const char *) mapping + offset;
+            input->size         = (size_t) (info.st_size - offset);
+            input->isStreamEnd  = true;
+
+            return EXIT_CODES::NO_ERRORS;
+        }
+    }
+#endif
+
+    // Buffer
+    input->buffer = (char *) calloc(capacity, sizeof(char));
+    if (input->buffer == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_INPUT_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    input->data     = input->buffer;
+    input->capacity = capacity;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that frees the input buffer (or unmaps the file)
+ * 
+ * @param input 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputDtor(cpu_input_t *input)
+{
+    // Error check
+    if (input == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+#if IO_POSIX
+    if (input->mapping != NULL)
+    {
+        munmap(input->mapping, input->mappingSize);
+    }
+#endif
+    free(input->buffer);
+    *input = {};
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that makes the input read `size` bytes of `data` (the stream is not read anymore, `data` is not copied)
+ * 
+ * The buffer (or the mapping) of the stream stays allocated until `inputDtor`
+ * 
+ * @param input 
+ * @param data 
+ * @param size 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputRecord(cpu_input_t *input, const char *data, size_t size)
+{
+    // Error check
+    if (input == NULL || (data == NULL && size > 0))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    input->data         = data;
+    input->position     = 0;
+    input->size         = size;
+    input->isStreamEnd  = true;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that appends `size` bytes of `data` to the input without the stream (the read bytes are dropped, the buffer grows twice)
+ * 
+ * @param input 
+ * @param data 
+ * @param size 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputAppend(cpu_input_t *input, const char *data, size_t size)
+{
+    // Error check
+    if (input == NULL || (data == NULL && size > 0))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (input->stream != NULL || input->isStreamEnd)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Buffer (`data` of the input is the buffer, so the unread bytes stay in it)
+    size_t unreadSize = input->size - input->position;
+    if (input->buffer == NULL || unreadSize + size > input->capacity)
+    {
+        size_t capacity = input->buffer == NULL ? input->capacity : 2 * input->capacity;
+        while (capacity < unreadSize + size)
+        {
+            capacity *= 2;
+        }
+
+        char *newBuffer = (char *) realloc(input->buffer, capacity);
+        if (newBuffer == NULL)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_INPUT_BUFFER);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+
+        input->buffer   = newBuffer;
+        input->capacity = capacity;
+    }
+
+    if (unreadSize > 0)
+    {
+        memmove(input->buffer, input->buffer + input->position, unreadSize);
+    }
+    memcpy(input->buffer + unreadSize, data, size);
+    input->data     = input->buffer;
+    input->position = 0;
+    input->size     = unreadSize + size;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that ends the input without the stream: the rest of it is read, then it is the end of the input
+ * 
+ * @param input 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputClose(cpu_input_t *input)
+{
+    // Error check
+    if (input == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    input->isStreamEnd = true;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that moves the unread bytes to the beginning of the buffer and reads more of the stream after them
+ * 
+ * Terminals and pipes give what they have (the rest of the block is not waited for), so the prompt is answered line by line
+ * 
+ * @param input 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES inputFill(cpu_input_t *input)
+{
+    if (input->isStreamEnd || input->stream == NULL)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    memmove(input->buffer, input->buffer + input->position, input->size - input->position);
+    input->size     -= input->position;
+    input->position = 0;
+
+    char *freeSpace = input->buffer + input->size;
+    size_t freeSize = input->capacity - input->size;
+#if IO_POSIX
+    ssize_t bytesRead = -1;
+    do
+    {
+        bytesRead = read(fileno(input->stream), freeSpace, freeSize);
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead < 0)
+    {
+        input->isStreamEnd = true;
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_READING_INPUT);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    input->size         += (size_t) bytesRead;
+    input->isStreamEnd  = bytesRead == 0;
+#else
+    // Text is read by lines (a console gives one line at once), binary values by blocks
+    size_t bytesRead = 0;
+    if (input->format == INPUT_FORMATS::TEXT)
+    {
+        if (fgets(freeSpace, (int) freeSize, input->stream) != NULL)
+        {
+            bytesRead = strlen(freeSpace);
+        }
+    }
+    else
+    {
+        bytesRead = fread(freeSpace, sizeof(char), freeSize, input->stream);
+    }
+    input->size         += bytesRead;
+    input->isStreamEnd  = bytesRead == 0;
+    if (ferror(input->stream))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_READING_INPUT);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+#endif
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that reads the next word of the text (whitespace separated), words longer than INPUT_MAX_WORD_LENGTH are skipped
+ * 
+ * @param input 
+ * @param value 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES inputTextDouble(cpu_input_t *input, double *value, INPUT_RESULTS *result)
+{
+    // Whitespace
+    for (;;)
+    {
+        while (input->position < input->size && isSpace(input->data[input->position]))
+        {
+            ++input->position;
+        }
+        if (input->position < input->size || input->isStreamEnd || input->stream == NULL)
+        {
+            break;
+        }
+        IS_ERROR(inputFill(input))
+        {
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+
+    if (input->position == input->size)
+    {
+        *result = input->isStreamEnd ? INPUT_RESULTS::END_OF_INPUT : INPUT_RESULTS::NOT_READY;
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Word (the buffer is longer than any word that is parsed, so it is read until its end, the appended words are whole)
+    size_t length = 0;
+    for (;;)
+    {
+        while (input->position + length < input->size && !isSpace(input->data[input->position + length]))
+        {
+            ++length;
+        }
+        if (input->position + length < input->size || input->isStreamEnd || input->stream == NULL || length > INPUT_MAX_WORD_LENGTH)
+        {
+            break;
+        }
+        IS_ERROR(inputFill(input))
+        {
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+
+    if (length > INPUT_MAX_WORD_LENGTH)
+    {
+        // Rest of the long word
+        for (;;)
+        {
+            while (input->position < input->size && !isSpace(input->data[input->position]))
+            {
+                ++input->position;
+            }
+            if (input->position < input->size || input->isStreamEnd || input->stream == NULL)
+            {
+                break;
+            }
+            IS_ERROR(inputFill(input))
+            {
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+        }
+
+        *result = INPUT_RESULTS::BAD_VALUE;
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    double parsed = 0;
+    if (parseDouble(input->data + input->position, length, &parsed))
+    {
+        *value  = parsed;
+        *result = INPUT_RESULTS::VALUE;
+    }
+    else
+    {
+        *result = INPUT_RESULTS::BAD_VALUE;
+    }
+    input->position += length;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that reads the next raw double (the host is little-endian, as the JIT requires)
+ * 
+ * @param input 
+ * @param value 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES inputBinaryDouble(cpu_input_t *input, double *value, INPUT_RESULTS *result)
+{
+    while (input->size - input->position < sizeof(double) && !input->isStreamEnd && input->stream != NULL)
+    {
+        IS_ERROR(inputFill(input))
+        {
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+
+    size_t available = input->size - input->position;
+    if (available < sizeof(double) && !input->isStreamEnd)
+    {
+        *result = INPUT_RESULTS::NOT_READY;
+    }
+    else if (available == 0)
+    {
+        *result = INPUT_RESULTS::END_OF_INPUT;
+    }
+    else if (available < sizeof(double))
+    {
+        input->position = input->size;
+        *result = INPUT_RESULTS::BAD_VALUE;
+    }
+    else
+    {
+        memcpy(value, input->data + input->position, sizeof(double));
+        input->position += sizeof(double);
+        *result = INPUT_RESULTS::VALUE;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that reads the next value in the format of the input (`value` is NaN unless the result is INPUT_RESULTS::VALUE)
+ * 
+ * @param input 
+ * @param value 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES inputDouble(cpu_input_t *input, double *value, INPUT_RESULTS *result)
+{
+    // Error check
+    if (input == NULL || (input->data == NULL && input->size > 0) || value == NULL || result == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Previous stage of the pipeline
+    *value  = NAN;
+    *result = INPUT_RESULTS::END_OF_INPUT;
+    if (input->ring != NULL)
+    {
+        if (ringPop(input->ring, value))
+        {
+            ++input->valuesCount;
+            *result = INPUT_RESULTS::VALUE;
+        }
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Read (failed read is the end of the input)
+    IS_ERROR((input->format == INPUT_FORMATS::BINARY ? inputBinaryDouble(input, value, result)
+                                                     : inputTextDouble(input, value, result)))
+    {
+        *result = INPUT_RESULTS::END_OF_INPUT;
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    input->valuesCount += *result == INPUT_RESULTS::VALUE;
+
+    return EXIT_CODES::NO_ERRORS;
+}
@@ -0,0 +1,2313 @@
+#include <string.h>  // for memcpy
+
+#include "include/opcodes.h"
+#include "include/processor/jit.h"
+#include "include/processor/settings.h"
+
+#if JIT_SUPPORTED
+
+#include <stddef.h>     // for offsetof
+#include <sys/mman.h>   // for mmap, mprotect, munmap
+
+// ------------------------------------------X86-64 ENCODING------------------------------------------
+enum X86_REGISTERS
+{
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8,  R9,  R10, R11, R12, R13, R14, R15,
+};
+
+enum X86_CONDITIONS
+{
+    CONDITION_ALWAYS        = -1,   // Unconditional `jmp`
+    CONDITION_BELOW         = 0x2,
+    CONDITION_ABOVE_EQUAL   = 0x3,
+    CONDITION_ZERO          = 0x4,
+    CONDITION_NOT_ZERO      = 0x5,
+    CONDITION_BELOW_EQUAL   = 0x6,
+    CONDITION_ABOVE         = 0x7,
+    CONDITION_PARITY        = 0xA,
+    CONDITION_LESS          = 0xC,
+};
+
+// Opcodes of `op r/m64, r64` integer instructions
+enum ALU_INSTRUCTIONS
+{
+    ALU_ADD                 = 0x01,
+    ALU_OR                  = 0x09,
+    ALU_AND                 = 0x21,
+    ALU_SUB                 = 0x29,
+    ALU_XOR                 = 0x31,
+};
+
+// SSE2 scalar double instructions (second opcode byte after 0x0F)
+enum SSE_INSTRUCTIONS
+{
+    SSE_MOVSD_LOAD          = 0x10,
+    SSE_MOVSD_STORE         = 0x11,
+    SSE_CVTSI2SD            = 0x2A,
+    SSE_CVTTSD2SI           = 0x2C,
+    SSE_UCOMISD             = 0x2E,
+    SSE_SQRTSD              = 0x51,
+    SSE_ADDSD               = 0x58,
+    SSE_MULSD               = 0x59,
+    SSE_SUBSD               = 0x5C,
+    SSE_DIVSD               = 0x5E,
+};
+
+const int SSE_PREFIX_DOUBLE     = 0xF2;     // Prefix of scalar double instructions
+const int SSE_PREFIX_PACKED     = 0x66;     // Prefix of `ucomisd` and `movq`
+
+// Extensions of 0x81 (ALU with imm32), 0xD1 and 0xC1 (shifts), 0xF7 and 0xFF opcodes
+const int EXT_ADD               = 0;
+const int EXT_AND               = 4;
+const int EXT_SUB               = 5;
+const int EXT_CMP               = 7;
+const int EXT_SHL               = 4;
+const int EXT_SHR               = 5;
+const int EXT_SAR               = 7;
+const int EXT_NEG               = 3;
+const int EXT_IDIV              = 7;
+const int EXT_CALL              = 2;
+const int EXT_JMP               = 4;
+
+// Registers that hold the virtual CPU state inside of the native code (callee-saved)
+const int STATE_REG             = RBX;      // jit_state_t *
+const int SP_REG                = R12;      // Next free slot of the operand stack
+const int REGS_REG              = R13;      // Common registers
+const int RAM_REG               = R14;      // RAM (TLB of the paged RAM)
+const int BASE_REG              = R15;      // Bottom of the operand stack
+const int INT_REGS_REG          = RBP;      // Integer registers
+
+const int ELEMENT_SIZE          = (int) sizeof(double);
+const int TLB_ENTRY_BITS        = 4;        // sizeof(ram_tlb_entry_t) as a power of 2
+static_assert(sizeof(ram_tlb_entry_t) == 1 << TLB_ENTRY_BITS, "TLB entry is indexed by shift");
+const size_t MAX_COMMAND_CODE   = 384;      // Upper bound of native code size of one command (with its side exits)
+const size_t JIT_PROLOGUE_SIZE  = 4096;
+// ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Structure that represents the buffer the native code is emitted into
+ * 
+ */
+struct code_buffer_t
+{
+    byte *data                          = NULL;
+    size_t size                         = 0;
+    size_t capacity                     = 0;
+    bool overflow                       = false;    // Set if the code did not fit into the buffer
+};
+
+/**
+ * @brief Structure that represents an exit from the middle of a block back to the interpreter
+ * 
+ */
+struct jit_side_exit_t
+{
+    size_t position                     = 0;        // Position of rel32 field of the jump
+    int command                         = 0;        // Command to continue with in the interpreter
+    int notExecuted                     = 0;        // Amount of commands of the block that were counted but not executed
+    bool linkable                       = true;     // Can be linked to the native code of `command` (not the stack checks)
+    bool fault                          = false;    // Exit of the RAM access that faults (`position` is the access)
+};
+
+/**
+ * @brief Structure that contains everything needed during the translation
+ * 
+ */
+struct jit_compiler_t
+{
+    code_buffer_t buffer                = {};
+    const decoded_program_t *program    = NULL;
+
+    jit_link_t *links                   = NULL;
+    int linksCount                      = 0;
+
+    jit_side_exit_t *exits              = NULL;     // Side exits of the current block
+    int exitsCount                      = 0;
+
+    size_t exitStub                     = 0;        // Position of the common exit code (returns to the processor)
+    int traceNext                       = 0;        // Command that is executed after the end of the trace
+    jit_t *traces                       = NULL;     // JIT that collects exits to the interpreter for linking (traces only)
+    jit_t *jit                          = NULL;     // JIT that collects the fault exits
+    bool *isLeader                      = NULL;     // Command starts a basic block
+    bool ramGuarded                     = false;    // See `jit_t`
+    bool ramPaged                       = false;
+};
+
+static void emitByte(code_buffer_t *buffer, int value)
+{
+    if (buffer->size < buffer->capacity)
+    {
+        buffer->data[buffer->size++] = (byte) value;
+    }
+    else
+    {
+        buffer->overflow = true;
+    }
+}
+
+static void emitU32(code_buffer_t *buffer, unsigned int value)
+{
+    for (size_t byteIndex = 0; byteIndex < sizeof(unsigned int); ++byteIndex)
+    {
+        emitByte(buffer, (int) ((value >> (8 * byteIndex)) & 0xFF));
+    }
+}
+
+static void emitU64(code_buffer_t *buffer, unsigned long long value)
+{
+    for (size_t byteIndex = 0; byteIndex < sizeof(unsigned long long); ++byteIndex)
+    {
+        emitByte(buffer, (int) ((value >> (8 * byteIndex)) & 0xFF));
+    }
+}
+
+/**
+ * @brief Emit REX prefix (only if it is needed)
+ * 
+ * @param buffer 
+ * @param wide 64-bit operand size
+ * @param reg ModRM.reg register
+ * @param index SIB.index register
+ * @param base ModRM.rm (or SIB.base) register
+ */
+static void emitRex(code_buffer_t *buffer, bool wide, int reg, int index, int base)
+{
+    int rex = 0x40 | (wide << 3) | (((reg >> 3) & 1) << 2) | (((index >> 3) & 1) << 1) | ((base >> 3) & 1);
+    if (rex != 0x40)
+    {
+        emitByte(buffer, rex);
+    }
+}
+
+// [base + disp32]
+static void emitMem(code_buffer_t *buffer, int reg, int base, int displacement)
+{
+    emitByte(buffer, 0x80 | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == RSP)
+    {
+        emitByte(buffer, 0x24);
+    }
+    emitU32(buffer, (unsigned int) displacement);
+}
+
+// [base + index * 8 + disp32]
+static void emitMemIndex(code_buffer_t *buffer, int reg, int base, int index, int displacement)
+{
+    emitByte(buffer, 0x80 | ((reg & 7) << 3) | RSP);
+    emitByte(buffer, 0xC0 | ((index & 7) << 3) | (base & 7));
+    emitU32(buffer, (unsigned int) displacement);
+}
+
+// reg, rm (both are registers)
+static void emitRegs(code_buffer_t *buffer, int reg, int rm)
+{
+    emitByte(buffer, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+static void emitSseMem(code_buffer_t *buffer, int prefix, int instruction, int xmm, int base, int displacement)
+{
+    emitByte(buffer, prefix);
+    emitRex(buffer, false, xmm, 0, base);
+    emitByte(buffer, 0x0F);
+    emitByte(buffer, instruction);
+    emitMem(buffer, xmm, base, displacement);
+}
+
+static void emitSseMemIndex(code_buffer_t *buffer, int instruction, int xmm, int base, int index)
+{
+    emitByte(buffer, SSE_PREFIX_DOUBLE);
+    emitRex(buffer, false, xmm, index, base);
+    emitByte(buffer, 0x0F);
+    emitByte(buffer, instruction);
+    emitMemIndex(buffer, xmm, base, index, 0);
+}
+
+static void emitSseRegs(code_buffer_t *buffer, int prefix, int instruction, int reg, int rm)
+{
+    emitByte(buffer, prefix);
+    emitRex(buffer, false, reg, 0, rm);
+    emitByte(buffer, 0x0F);
+    emitByte(buffer, instruction);
+    emitRegs(buffer, reg, rm);
+}
+
+// cvttsd2si r, xmm / cvtsi2sd xmm, r (64-bit integer if `wide`)
+static void emitSseConvert(code_buffer_t *buffer, int instruction, int reg, int rm, bool wide)
+{
+    emitByte(buffer, SSE_PREFIX_DOUBLE);
+    emitRex(buffer, wide, reg, 0, rm);
+    emitByte(buffer, 0x0F);
+    emitByte(buffer, instruction);
+    emitRegs(buffer, reg, rm);
+}
+
+// movq xmm, r64 (toXmm) or movq r64, xmm
+static void emitMovq(code_buffer_t *buffer, int xmm, int reg, bool toXmm)
+{
+    emitByte(buffer, SSE_PREFIX_PACKED);
+    emitRex(buffer, true, xmm, 0, reg);
+    emitByte(buffer, 0x0F);
+    emitByte(buffer, toXmm ? 0x6E : 0x7E);
+    emitRegs(buffer, xmm, reg);
+}
+
+// add/sub/cmp r, imm32
+static void emitAluRegImm(code_buffer_t *buffer, bool wide, int extension, int reg, int immediate)
+{
+    emitRex(buffer, wide, 0, 0, reg);
+    emitByte(buffer, 0x81);
+    emitRegs(buffer, extension, reg);
+    emitU32(buffer, (unsigned int) immediate);
+}
+
+// add/sub qword [base + disp32], imm32
+static void emitAluMemImm(code_buffer_t *buffer, int extension, int base, int displacement, int immediate)
+{
+    emitRex(buffer, true, 0, 0, base);
+    emitByte(buffer, 0x81);
+    emitMem(buffer, extension, base, displacement);
+    emitU32(buffer, (unsigned int) immediate);
+}
+
+// mov r64, [base + disp32]
+static void emitLoad(code_buffer_t *buffer, int reg, int base, int displacement)
+{
+    emitRex(buffer, true, reg, 0, base);
+    emitByte(buffer, 0x8B);
+    emitMem(buffer, reg, base, displacement);
+}
+
+// [base + index * 4 + disp32]
+static void emitMemIndex4(code_buffer_t *buffer, int reg, int base, int index, int displacement)
+{
+    emitByte(buffer, 0x80 | ((reg & 7) << 3) | RSP);
+    emitByte(buffer, 0x80 | ((index & 7) << 3) | (base & 7));
+    emitU32(buffer, (unsigned int) displacement);
+}
+
+// mov r64, [base + index * 8]
+static void emitLoadIndex(code_buffer_t *buffer, int reg, int base, int index)
+{
+    emitRex(buffer, true, reg, index, base);
+    emitByte(buffer, 0x8B);
+    emitMemIndex(buffer, reg, base, index, 0);
+}
+
+// mov r32, [base + disp32]
+static void emitLoad32(code_buffer_t *buffer, int reg, int base, int displacement)
+{
+    emitRex(buffer, false, reg, 0, base);
+    emitByte(buffer, 0x8B);
+    emitMem(buffer, reg, base, displacement);
+}
+
+// mov r32, [base + index * 4]
+static void emitLoadIndex32(code_buffer_t *buffer, int reg, int base, int index)
+{
+    emitRex(buffer, false, reg, index, base);
+    emitByte(buffer, 0x8B);
+    emitMemIndex4(buffer, reg, base, index, 0);
+}
+
+// mov dword [base + index * 4], imm32
+static void emitStoreIndexImm32(code_buffer_t *buffer, int base, int index, int immediate)
+{
+    emitRex(buffer, false, 0, index, base);
+    emitByte(buffer, 0xC7);
+    emitMemIndex4(buffer, 0, base, index, 0);
+    emitU32(buffer, (unsigned int) immediate);
+}
+
+// mov [base + disp32], r64
+static void emitStore(code_buffer_t *buffer, int base, int displacement, int reg)
+{
+    emitRex(buffer, true, reg, 0, base);
+    emitByte(buffer, 0x89);
+    emitMem(buffer, reg, base, displacement);
+}
+
+// add/sub/and/or/xor r64, r64
+static void emitAluRegs(code_buffer_t *buffer, int instruction, int destination, int source)
+{
+    emitRex(buffer, true, source, 0, destination);
+    emitByte(buffer, instruction);
+    emitRegs(buffer, source, destination);
+}
+
+// imul r64, r64
+static void emitImulRegs(code_buffer_t *buffer, int destination, int source)
+{
+    emitRex(buffer, true, destination, 0, source);
+    emitByte(buffer, 0x0F);
+    emitByte(buffer, 0xAF);
+    emitRegs(buffer, destination, source);
+}
+
+// mov r64, r64
+static void emitMovRegs(code_buffer_t *buffer, int destination, int source)
+{
+    emitRex(buffer, true, source, 0, destination);
+    emitByte(buffer, 0x89);
+    emitRegs(buffer, source, destination);
+}
+
+// lea r64, [base + disp32]
+static void emitLea(code_buffer_t *buffer, int reg, int base, int displacement)
+{
+    emitRex(buffer, true, reg, 0, base);
+    emitByte(buffer, 0x8D);
+    emitMem(buffer, reg, base, displacement);
+}
+
+// cmp r, r
+static void emitCmpRegs(code_buffer_t *buffer, bool wide, int first, int second)
+{
+    emitRex(buffer, wide, first, 0, second);
+    emitByte(buffer, 0x3B);
+    emitRegs(buffer, first, second);
+}
+
+// cmp r, [base + disp32]
+static void emitCmpMem(code_buffer_t *buffer, bool wide, int reg, int base, int displacement)
+{
+    emitRex(buffer, wide, reg, 0, base);
+    emitByte(buffer, 0x3B);
+    emitMem(buffer, reg, base, displacement);
+}
+
+// mov dword [base + disp32], r32
+static void emitStore32(code_buffer_t *buffer, int base, int displacement, int reg)
+{
+    emitRex(buffer, false, reg, 0, base);
+    emitByte(buffer, 0x89);
+    emitMem(buffer, reg, base, displacement);
+}
+
+// test dword [base + disp32], imm32
+static void emitTestMemImm(code_buffer_t *buffer, int base, int displacement, int immediate)
+{
+    emitRex(buffer, false, 0, 0, base);
+    emitByte(buffer, 0xF7);
+    emitMem(buffer, 0, base, displacement);
+    emitU32(buffer, (unsigned int) immediate);
+}
+
+// test r64, r64
+static void emitTest(code_buffer_t *buffer, int first, int second)
+{
+    emitRex(buffer, true, second, 0, first);
+    emitByte(buffer, 0x85);
+    emitRegs(buffer, second, first);
+}
+
+// mov r64, imm64
+static void emitMovImm64(code_buffer_t *buffer, int reg, unsigned long long immediate)
+{
+    emitRex(buffer, true, 0, 0, reg);
+    emitByte(buffer, 0xB8 + (reg & 7));
+    emitU64(buffer, immediate);
+}
+
+// mov r32, imm32
+static void emitMovImm32(code_buffer_t *buffer, int reg, int immediate)
+{
+    emitRex(buffer, false, 0, 0, reg);
+    emitByte(buffer, 0xB8 + (reg & 7));
+    emitU32(buffer, (unsigned int) immediate);
+}
+
+// shl/shr/neg/idiv with one register operand
+static void emitUnary(code_buffer_t *buffer, bool wide, int opcode, int extension, int reg)
+{
+    emitRex(buffer, wide, 0, 0, reg);
+    emitByte(buffer, opcode);
+    emitRegs(buffer, extension, reg);
+}
+
+// shl/shr r, imm8
+static void emitShiftImm(code_buffer_t *buffer, bool wide, int extension, int reg, int count)
+{
+    emitRex(buffer, wide, 0, 0, reg);
+    emitByte(buffer, 0xC1);
+    emitRegs(buffer, extension, reg);
+    emitByte(buffer, count);
+}
+
+static void emitPush(code_buffer_t *buffer, int reg)
+{
+    emitRex(buffer, false, 0, 0, reg);
+    emitByte(buffer, 0x50 + (reg & 7));
+}
+
+static void emitPop(code_buffer_t *buffer, int reg)
+{
+    emitRex(buffer, false, 0, 0, reg);
+    emitByte(buffer, 0x58 + (reg & 7));
+}
+
+/**
+ * @brief Emit `jmp`/`jcc` with rel32 displacement to be patched later
+ * 
+ * @param buffer 
+ * @param condition 
+ * @return size_t position of rel32 field
+ */
+static size_t emitJump(code_buffer_t *buffer, int condition)
+{
+    if (condition == CONDITION_ALWAYS)
+    {
+        emitByte(buffer, 0xE9);
+    }
+    else
+    {
+        emitByte(buffer, 0x0F);
+        emitByte(buffer, 0x80 + condition);
+    }
+
+    size_t position = buffer->size;
+    emitU32(buffer, 0);
+
+    return position;
+}
+
+static void patchJump(code_buffer_t *buffer, size_t position, size_t target)
+{
+    if (position + sizeof(int) <= buffer->size)
+    {
+        int displacement = (int) ((long long) target - (long long) (position + sizeof(int)));
+        memcpy(&buffer->data[position], &displacement, sizeof(int));
+    }
+}
+
+static unsigned long long doubleBits(double value)
+{
+    unsigned long long bits = 0;
+    memcpy(&bits, &value, sizeof(double));
+
+    return bits;
+}
+
+/**
+ * @brief Get the amount of values the command pops and pushes (false if the command is not translated into native code)
+ * 
+ * @param command 
+ * @param pops 
+ * @param pushes 
+ * @return bool 
+ */
+static bool jitGetStackEffect(const decoded_command_t *command, int *pops, int *pushes)
+{
+    *pops   = 0;
+    *pushes = 0;
+
+    // Operand the command can not keep (see `decoded_extra_regs_t`) is left to the interpreter
+    if (command->intRegs[0] == EXTRA_INT_REGISTER)
+    {
+        return false;
+    }
+
+    switch (command->opcode)
+    {
+        case OPCODE_push:
+            *pushes = 1;
+            return true;
+        case OPCODE_pop:
+            *pops = 1;
+            return MRI_IS_MEMORY(command->MRI) || command->destination != ZERO_REGISTER ||
+                   command->intDestination != ZERO_INT_REGISTER;
+        case OPCODE_add:
+        case OPCODE_sub:
+        case OPCODE_mul:
+        case OPCODE_div:
+            *pops   = 2;
+            *pushes = 1;
+            return true;
+        case OPCODE_out:
+        case OPCODE_outc:
+            *pops = 1;
+            return true;
+        case OPCODE_in:
+            *pushes = 1;
+            return true;
+        case OPCODE_ret:
+            return true;
+        case OPCODE_jmp:
+        case OPCODE_call:
+            return command->target != BAD_TARGET;
+        case OPCODE_sqrt:
+            *pops   = 1;
+            *pushes = 1;
+            return true;
+        case OPCODE_je:
+        case OPCODE_jl:
+        case OPCODE_jg:
+        case OPCODE_jne:
+            *pops   = 1;
+            *pushes = 1;
+            return command->target != BAD_TARGET;
+        case OPCODE_cmp:
+            *pops   = 2;
+            *pushes = 3;
+            return true;
+        case OPCODE_fcmp:
+            *pops   = 2;
+            return true;
+        case OPCODE_fje:
+        case OPCODE_fjne:
+        case OPCODE_fjl:
+        case OPCODE_fjle:
+        case OPCODE_fjg:
+        case OPCODE_fjge:
+        case OPCODE_fjeof:
+            return command->target != BAD_TARGET;
+        case OPCODE_imov:
+        case OPCODE_iadd:
+        case OPCODE_isub:
+        case OPCODE_imul:
+        case OPCODE_idiv:
+        case OPCODE_imod:
+        case OPCODE_iand:
+        case OPCODE_ior:
+        case OPCODE_ixor:
+        case OPCODE_ishl:
+        case OPCODE_ishr:
+        case OPCODE_icmp:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Function that determines whether the command can be translated into native code
+ * 
+ * @param command 
+ * @return bool 
+ */
+bool jitCanCompile(const decoded_command_t *command)
+{
+    int pops    = 0;
+    int pushes  = 0;
+
+    return command != NULL && jitGetStackEffect(command, &pops, &pushes);
+}
+
+static bool isBlockTerminator(const decoded_command_t *command)
+{
+    switch (command->opcode)
+    {
+        case OPCODE_jmp:
+        case OPCODE_call:
+        case OPCODE_ret:
+        case OPCODE_je:
+        case OPCODE_jl:
+        case OPCODE_jg:
+        case OPCODE_jne:
+        case OPCODE_fje:
+        case OPCODE_fjne:
+        case OPCODE_fjl:
+        case OPCODE_fjle:
+        case OPCODE_fjg:
+        case OPCODE_fjge:
+        case OPCODE_fjeof:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void addLink(jit_compiler_t *compiler, size_t position, int command)
+{
+    compiler->links[compiler->linksCount].position  = position;
+    compiler->links[compiler->linksCount].command   = command;
+    ++compiler->linksCount;
+}
+
+static void addSideExit(jit_compiler_t *compiler, size_t position, int command, int notExecuted)
+{
+    compiler->exits[compiler->exitsCount].position      = position;
+    compiler->exits[compiler->exitsCount].command       = command;
+    compiler->exits[compiler->exitsCount].notExecuted   = notExecuted;
+    compiler->exits[compiler->exitsCount].linkable      = true;
+    compiler->exits[compiler->exitsCount].fault         = false;
+    ++compiler->exitsCount;
+}
+
+// The next instruction is the RAM access of guarded RAM (its fault continues with the side exit)
+static void addFaultExit(jit_compiler_t *compiler, int command, int notExecuted)
+{
+    if (compiler->ramGuarded)
+    {
+        addSideExit(compiler, compiler->buffer.size, command, notExecuted);
+        compiler->exits[compiler->exitsCount - 1].fault = true;
+    }
+}
+
+static void addFault(jit_compiler_t *compiler, size_t instruction, size_t exit)
+{
+    jit_t *jit = compiler->jit;
+    if (jit->faultsCount == jit->faultsCapacity)
+    {
+        int newCapacity = jit->faultsCapacity > 0 ? 2 * jit->faultsCapacity : 64;
+        jit_fault_t *newFaults = (jit_fault_t *) realloc(jit->faults, (size_t) newCapacity * sizeof(jit_fault_t));
+        if (newFaults == NULL)
+        {
+            compiler->buffer.overflow = true;   // Unresolved fault would crash, the code is not used
+            return;
+        }
+
+        jit->faults         = newFaults;
+        jit->faultsCapacity = newCapacity;
+    }
+
+    jit->faults[jit->faultsCount].instruction   = instruction;
+    jit->faults[jit->faultsCount].exit          = exit;
+    ++jit->faultsCount;
+}
+
+/**
+ * @brief Remember the jump to the common exit (it is linked to the trace of `command` once it is compiled)
+ * 
+ * @param compiler 
+ * @param position position of rel32 field of the jump
+ * @param command 
+ */
+static void addUnlinkedExit(jit_compiler_t *compiler, size_t position, int command)
+{
+    jit_t *jit = compiler->traces;
+    if (jit == NULL)
+    {
+        return;
+    }
+
+    if (jit->unlinkedExitsCount == jit->unlinkedExitsCapacity)
+    {
+        int newCapacity = jit->unlinkedExitsCapacity > 0 ? 2 * jit->unlinkedExitsCapacity : 64;
+        jit_link_t *newExits = (jit_link_t *) realloc(jit->unlinkedExits, (size_t) newCapacity * sizeof(jit_link_t));
+        if (newExits == NULL)
+        {
+            return;     // Exit stays unlinked (always returns to the processor)
+        }
+
+        jit->unlinkedExits          = newExits;
+        jit->unlinkedExitsCapacity  = newCapacity;
+    }
+
+    jit->unlinkedExits[jit->unlinkedExitsCount].position  = position;
+    jit->unlinkedExits[jit->unlinkedExitsCount].command   = command;
+    ++jit->unlinkedExitsCount;
+}
+
+// xmm = |xmm| (through general purpose register `temp`)
+static void emitAbs(code_buffer_t *buffer, int xmm, int temp)
+{
+    emitMovq(buffer, xmm, temp, false);
+    emitUnary(buffer, true, 0xD1, EXT_SHL, temp);
+    emitUnary(buffer, true, 0xD1, EXT_SHR, temp);
+    emitMovq(buffer, xmm, temp, true);
+}
+
+// rax = sum of the integer registers of the command (`intImmediate` is added if `withImmediate`)
+static void emitIntRegsSum(code_buffer_t *buffer, const decoded_command_t *command, bool withImmediate)
+{
+    emitMovImm64(buffer, RAX, withImmediate ? (unsigned long long) command->intImmediate : 0);
+    for (int reg = 0; reg < MAX_DECODED_REGS; ++reg)
+    {
+        if (command->intRegs[reg] != ZERO_INT_REGISTER)
+        {
+            emitLoad(buffer, RCX, INT_REGS_REG, command->intRegs[reg] * (int) sizeof(long long));
+            emitAluRegs(buffer, ALU_ADD, RAX, RCX);
+        }
+    }
+}
+
+// xmm0 = immediate + registers of the command
+static void emitOperandValue(code_buffer_t *buffer, const decoded_command_t *command)
+{
+    emitMovImm64(buffer, RAX, doubleBits(command->immediate));
+    emitMovq(buffer, 0, RAX, true);
+
+    for (int reg = 0; reg < MAX_DECODED_REGS; ++reg)
+    {
+        if (command->regs[reg] != ZERO_REGISTER)
+        {
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_ADDSD, 0, REGS_REG, command->regs[reg] * ELEMENT_SIZE);
+        }
+    }
+
+    // Integer registers are summed as integers first (the same as the interpreter does)
+    if (command->intRegs[0] != ZERO_INT_REGISTER)
+    {
+        emitIntRegsSum(buffer, command, false);
+        emitSseConvert(buffer, SSE_CVTSI2SD, 1, RAX, true);
+        emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_ADDSD, 0, 1);
+    }
+}
+
+/**
+ * @brief Emit RAM index of the command (same check as the interpreter does + bounds check), index is put into rax
+ * 
+ * Guarded RAM is indexed by 32-bit unsigned value without the bounds check: negative and too big indices fault
+ * in the guard region (see `ramCtor`). Integer address is always checked by the unsigned compare (it is 64-bit)
+ * 
+ * @param compiler 
+ * @param command index of the command (side exit target)
+ * @param notExecuted 
+ */
+static void emitRamIndex(jit_compiler_t *compiler, int command, int notExecuted)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+    bool wide = !compiler->ramGuarded;
+
+    const decoded_command_t *decoded = &compiler->program->commands[command];
+    if (decoded->intAddress)
+    {
+        emitIntRegsSum(buffer, decoded, true);
+        emitCmpMem(buffer, true, RAX, STATE_REG, offsetof(jit_state_t, RAMSize));
+        addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE_EQUAL), command, notExecuted);
+        return;
+    }
+
+    emitOperandValue(buffer, decoded);
+
+    // rax = (long long) value, xmm1 = (double) rax
+    emitSseConvert(buffer, SSE_CVTTSD2SI, RAX, 0, wide);
+    emitSseConvert(buffer, SSE_CVTSI2SD, 1, RAX, wide);
+
+    // fabs(value - (long long) value) < EPS
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 2, 0);
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_SUBSD, 2, 1);
+    emitAbs(buffer, 2, RDX);
+    emitSseMem(buffer, SSE_PREFIX_PACKED, SSE_UCOMISD, 2, STATE_REG, offsetof(jit_state_t, eps));
+    addSideExit(compiler, emitJump(buffer, CONDITION_PARITY), command, notExecuted);
+    addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE_EQUAL), command, notExecuted);
+
+    // 0 <= index < RAMSize (unsigned)
+    if (wide)
+    {
+        emitCmpMem(buffer, true, RAX, STATE_REG, offsetof(jit_state_t, RAMSize));
+        addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE_EQUAL), command, notExecuted);
+    }
+}
+
+/**
+ * @brief Emit TLB lookup of the paged RAM index in rax: rdx = cells of its page, rax = index in the page
+ * 
+ * The miss exits to the interpreter (it allocates the page and fills the TLB entry, so the next run hits)
+ * 
+ * @param compiler 
+ * @param command index of the command (side exit target)
+ * @param notExecuted 
+ */
+static void emitPageLookup(jit_compiler_t *compiler, int command, int notExecuted)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    // rcx = page, rdx = its TLB entry
+    emitMovRegs(buffer, RCX, RAX);
+    emitShiftImm(buffer, true, EXT_SHR, RCX, RAM_PAGE_BITS);
+    emitMovRegs(buffer, RDX, RCX);
+    emitAluRegImm(buffer, false, EXT_AND, RDX, RAM_TLB_SIZE - 1);
+    emitShiftImm(buffer, false, EXT_SHL, RDX, TLB_ENTRY_BITS);
+    emitAluRegs(buffer, ALU_ADD, RDX, RAM_REG);
+
+    emitCmpMem(buffer, true, RCX, RDX, offsetof(ram_tlb_entry_t, page));
+    addSideExit(compiler, emitJump(buffer, CONDITION_NOT_ZERO), command, notExecuted);
+    compiler->exits[compiler->exitsCount - 1].linkable = false;     // Only the interpreter fills the TLB
+
+    emitLoad(buffer, RDX, RDX, offsetof(ram_tlb_entry_t, cells));
+    emitAluRegImm(buffer, false, EXT_AND, RAX, (int) RAM_PAGE_SIZE - 1);
+}
+
+// RAM access of the command with the index in rax (see `emitRamIndex`), one aligned `movsd` is the relaxed atomic access
+// the interpreter does for the RAM shared by the cores (see `ramLoad`)
+static void emitRamAccess(jit_compiler_t *compiler, int instruction, int xmm, int command, int notExecuted)
+{
+    if (compiler->ramPaged)
+    {
+        emitPageLookup(compiler, command, notExecuted);
+        emitSseMemIndex(&compiler->buffer, instruction, xmm, RDX, RAX);
+    }
+    else
+    {
+        addFaultExit(compiler, command, notExecuted);
+        emitSseMemIndex(&compiler->buffer, instruction, xmm, RAM_REG, RAX);
+    }
+}
+
+// Call one of the I/O callbacks of the state
+static void emitCallback(code_buffer_t *buffer, int callbackOffset)
+{
+    emitStore(buffer, STATE_REG, offsetof(jit_state_t, sp), SP_REG);
+    emitMovRegs(buffer, RDI, STATE_REG);
+    emitRex(buffer, false, 0, 0, STATE_REG);
+    emitByte(buffer, 0xFF);
+    emitMem(buffer, EXT_CALL, STATE_REG, callbackOffset);
+    emitLoad(buffer, SP_REG, STATE_REG, offsetof(jit_state_t, sp));
+}
+
+// Jump to the block that starts with `command`
+static void emitLink(jit_compiler_t *compiler, int command)
+{
+    addLink(compiler, emitJump(&compiler->buffer, CONDITION_ALWAYS), command);
+}
+
+/**
+ * @brief Emit comparison of the top of the stack with the value the conditional jump expects (`ucomisd` flags)
+ * 
+ * @param buffer 
+ * @param command 
+ */
+static void emitBranchCondition(code_buffer_t *buffer, const decoded_command_t *command)
+{
+    // xmm0 = |top - expected|
+    double expected = DOUBLES_ARE_EQUAL;
+    if (command->opcode == OPCODE_jl)
+    {
+        expected = FIRST_DOUBLE_IS_LOWER;
+    }
+    else if (command->opcode == OPCODE_jg)
+    {
+        expected = FIRST_DOUBLE_IS_GREATER;
+    }
+
+    emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 0, SP_REG, -ELEMENT_SIZE);
+    emitMovImm64(buffer, RAX, doubleBits(expected));
+    emitMovq(buffer, 1, RAX, true);
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_SUBSD, 0, 1);
+    emitAbs(buffer, 0, RAX);
+    emitSseMem(buffer, SSE_PREFIX_PACKED, SSE_UCOMISD, 0, STATE_REG, offsetof(jit_state_t, eps));
+}
+
+/**
+ * @brief Emit native code of the conditional jump (`je`, `jl`, `jg`, `jne`)
+ * 
+ * @param compiler 
+ * @param command 
+ * @param next index of the command after the jump
+ */
+static void emitConditionalJump(jit_compiler_t *compiler, const decoded_command_t *command, int next)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    emitBranchCondition(buffer, command);
+
+    // Not taken: `jne` - |difference| <= EPS, others - |difference| >= EPS (or NaN)
+    if (command->opcode == OPCODE_jne)
+    {
+        addLink(compiler, emitJump(buffer, CONDITION_BELOW_EQUAL), next);
+    }
+    else
+    {
+        addLink(compiler, emitJump(buffer, CONDITION_PARITY), next);
+        addLink(compiler, emitJump(buffer, CONDITION_ABOVE_EQUAL), next);
+    }
+
+    // Taken: pop the compared value and jump
+    emitAluRegImm(buffer, true, EXT_SUB, SP_REG, ELEMENT_SIZE);
+    emitLink(compiler, command->target);
+}
+
+// Native code of `fcmp`: flags = FLAGS_OF(v2, v1), both values are popped
+static void emitFlagsCompare(code_buffer_t *buffer)
+{
+    emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 0, SP_REG, -2 * ELEMENT_SIZE);    // v2 (first)
+    emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 1, SP_REG, -ELEMENT_SIZE);        // v1 (second)
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 2, 0);
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_SUBSD, 2, 1);
+    emitAbs(buffer, 2, RAX);
+
+    // |first - second| < EPS (`mov` does not change the flags of `ucomisd`)
+    emitSseMem(buffer, SSE_PREFIX_PACKED, SSE_UCOMISD, 2, STATE_REG, offsetof(jit_state_t, eps));
+    emitMovImm32(buffer, RCX, EQUAL_FLAG);
+    size_t notEqual = emitJump(buffer, CONDITION_PARITY);
+    size_t equal    = emitJump(buffer, CONDITION_BELOW);
+
+    // first < second, first > second or unordered
+    patchJump(buffer, notEqual, buffer->size);
+    emitMovImm32(buffer, RCX, 0);
+    emitSseRegs(buffer, SSE_PREFIX_PACKED, SSE_UCOMISD, 0, 1);
+    size_t unordered = emitJump(buffer, CONDITION_PARITY);
+    emitMovImm32(buffer, RCX, LOWER_FLAG);
+    size_t lower = emitJump(buffer, CONDITION_BELOW);
+    emitMovImm32(buffer, RCX, GREATER_FLAG);
+
+    patchJump(buffer, equal, buffer->size);
+    patchJump(buffer, unordered, buffer->size);
+    patchJump(buffer, lower, buffer->size);
+    emitLoad(buffer, RAX, STATE_REG, offsetof(jit_state_t, flags));
+    emitStore32(buffer, RAX, 0, RCX);
+    emitAluRegImm(buffer, true, EXT_SUB, SP_REG, 2 * ELEMENT_SIZE);
+}
+
+/**
+ * @brief Get the flags the flags jump (`fje`, `fjne`, `fjl`, `fjle`, `fjg`, `fjge`, `fjeof`) tests (`fjne` is taken if none of them is set)
+ * 
+ * @param opcode 
+ * @return int mask of the flags
+ */
+static int getFlagsJumpMask(unsigned short opcode)
+{
+    switch (opcode)
+    {
+        case OPCODE_fjl:    return LOWER_FLAG;
+        case OPCODE_fjle:   return LOWER_FLAG | EQUAL_FLAG;
+        case OPCODE_fjg:    return GREATER_FLAG;
+        case OPCODE_fjge:   return GREATER_FLAG | EQUAL_FLAG;
+        case OPCODE_fjeof:  return END_OF_INPUT_FLAG | BAD_INPUT_FLAG;
+        default:            return EQUAL_FLAG;
+    }
+}
+
+/**
+ * @brief Emit the test of the flags register for the flags jump (`fje`, `fjne`, `fjl`, `fjle`, `fjg`, `fjge`, `fjeof`)
+ * 
+ * @param buffer 
+ * @param command 
+ * @return int condition the jump is taken on
+ */
+static int emitFlagsTest(code_buffer_t *buffer, const decoded_command_t *command)
+{
+    emitLoad(buffer, RAX, STATE_REG, offsetof(jit_state_t, flags));
+    emitTestMemImm(buffer, RAX, 0, getFlagsJumpMask(command->opcode));
+
+    return command->opcode == OPCODE_fjne ? CONDITION_ZERO : CONDITION_NOT_ZERO;
+}
+
+// Native code of `cmp`: push(v2), push(v1), push(result)
+static void emitCompare(code_buffer_t *buffer)
+{
+    emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 0, SP_REG, -ELEMENT_SIZE);        // v1
+    emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 1, SP_REG, -2 * ELEMENT_SIZE);    // v2
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 2, 0);
+    emitSseRegs(buffer, SSE_PREFIX_DOUBLE, SSE_SUBSD, 2, 1);
+    emitAbs(buffer, 2, RAX);
+    emitSseMem(buffer, SSE_PREFIX_PACKED, SSE_UCOMISD, 2, STATE_REG, offsetof(jit_state_t, eps));
+
+    size_t notEqualParity   = emitJump(buffer, CONDITION_PARITY);
+    size_t notEqual         = emitJump(buffer, CONDITION_ABOVE_EQUAL);
+    emitMovImm64(buffer, RAX, doubleBits(DOUBLES_ARE_EQUAL));
+    size_t equalDone        = emitJump(buffer, CONDITION_ALWAYS);
+
+    patchJump(buffer, notEqualParity, buffer->size);
+    patchJump(buffer, notEqual, buffer->size);
+    emitSseRegs(buffer, SSE_PREFIX_PACKED, SSE_UCOMISD, 0, 1);
+    emitMovImm64(buffer, RAX, doubleBits(FIRST_DOUBLE_IS_LOWER));
+    size_t lowerDone        = emitJump(buffer, CONDITION_BELOW_EQUAL);
+    emitMovImm64(buffer, RAX, doubleBits(FIRST_DOUBLE_IS_GREATER));
+
+    patchJump(buffer, equalDone, buffer->size);
+    patchJump(buffer, lowerDone, buffer->size);
+    emitStore(buffer, SP_REG, 0, RAX);
+    emitAluRegImm(buffer, true, EXT_ADD, SP_REG, ELEMENT_SIZE);
+}
+
+// Native code of `call` without the jump: callStack[callDepth++] = nextAddress (full call stack is handled by the interpreter)
+static void emitCallPush(jit_compiler_t *compiler, const decoded_command_t *command, int index, int notExecuted)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    emitLoad32(buffer, RAX, STATE_REG, offsetof(jit_state_t, callDepth));
+    emitCmpMem(buffer, false, RAX, STATE_REG, offsetof(jit_state_t, maxCallDepth));
+    addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE_EQUAL), index, notExecuted);
+    compiler->exits[compiler->exitsCount - 1].linkable = false;
+
+    emitLoad(buffer, RDX, STATE_REG, offsetof(jit_state_t, callStack));
+    emitStoreIndexImm32(buffer, RDX, RAX, (int) command->nextAddress);
+    emitAluRegImm(buffer, false, EXT_ADD, RAX, 1);
+    emitStore32(buffer, STATE_REG, offsetof(jit_state_t, callDepth), RAX);
+}
+
+// Native code of `ret` without the jump: ecx = callStack[callDepth - 1], eax = callDepth - 1 (not stored, the caller may still exit)
+static void emitCallPop(jit_compiler_t *compiler, int index, int notExecuted)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    emitLoad32(buffer, RAX, STATE_REG, offsetof(jit_state_t, callDepth));
+    emitAluRegImm(buffer, false, EXT_SUB, RAX, 1);
+    addSideExit(compiler, emitJump(buffer, CONDITION_BELOW), index, notExecuted);
+    compiler->exits[compiler->exitsCount - 1].linkable = false;
+
+    emitLoad(buffer, RDX, STATE_REG, offsetof(jit_state_t, callStack));
+    emitLoadIndex32(buffer, RCX, RDX, RAX);
+}
+
+// Native code of `pop rN`: the value is truncated (the one that does not fit is exited to the interpreter, it reports the error)
+static void emitIntRegisterMove(jit_compiler_t *compiler, const decoded_command_t *command, int index, int notExecuted)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    // cvttsd2si gives INT64_MIN for NaN and out of range values
+    emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 1, SP_REG, -ELEMENT_SIZE);
+    emitSseConvert(buffer, SSE_CVTTSD2SI, RAX, 1, true);
+    emitMovImm64(buffer, RCX, 1ULL << 63);
+    emitCmpRegs(buffer, true, RAX, RCX);
+    addSideExit(compiler, emitJump(buffer, CONDITION_ZERO), index, notExecuted);
+    compiler->exits[compiler->exitsCount - 1].linkable = false;
+
+    emitStore(buffer, INT_REGS_REG, command->intDestination * (int) sizeof(long long), RAX);
+}
+
+/**
+ * @brief Emit native code of INTEGER command (`rN` is in rax, source is in rcx)
+ * 
+ * Division by zero is exited to the interpreter (it reports the error), INT64_MIN / -1 is handled without `idiv` (it traps)
+ * 
+ * @param compiler 
+ * @param index index of the command
+ * @param notExecuted 
+ */
+static void emitIntegerCommand(jit_compiler_t *compiler, int index, int notExecuted)
+{
+    code_buffer_t *buffer               = &compiler->buffer;
+    const decoded_command_t *command    = &compiler->program->commands[index];
+    int destination                     = command->intDestination * (int) sizeof(long long);
+
+    emitIntRegsSum(buffer, command, true);
+    emitMovRegs(buffer, RCX, RAX);
+    emitLoad(buffer, RAX, INT_REGS_REG, destination);
+
+    switch (command->opcode)
+    {
+        case OPCODE_imov:   emitMovRegs(buffer, RAX, RCX);                      break;
+        case OPCODE_iadd:   emitAluRegs(buffer, ALU_ADD, RAX, RCX);             break;
+        case OPCODE_isub:   emitAluRegs(buffer, ALU_SUB, RAX, RCX);             break;
+        case OPCODE_iand:   emitAluRegs(buffer, ALU_AND, RAX, RCX);             break;
+        case OPCODE_ior:    emitAluRegs(buffer, ALU_OR,  RAX, RCX);             break;
+        case OPCODE_ixor:   emitAluRegs(buffer, ALU_XOR, RAX, RCX);             break;
+        case OPCODE_imul:   emitImulRegs(buffer, RAX, RCX);                     break;
+        case OPCODE_ishl:   emitUnary(buffer, true, 0xD3, EXT_SHL, RAX);        break;  // Count is cl & 63
+        case OPCODE_ishr:   emitUnary(buffer, true, 0xD3, EXT_SAR, RAX);        break;
+
+        case OPCODE_idiv:
+        case OPCODE_imod:
+        {
+            emitTest(buffer, RCX, RCX);
+            addSideExit(compiler, emitJump(buffer, CONDITION_ZERO), index, notExecuted);
+            compiler->exits[compiler->exitsCount - 1].linkable = false;
+
+            // rN / -1 = -rN, rN % -1 = 0
+            emitAluRegImm(buffer, true, EXT_CMP, RCX, -1);
+            size_t divide = emitJump(buffer, CONDITION_NOT_ZERO);
+            if (command->opcode == OPCODE_idiv)
+            {
+                emitUnary(buffer, true, 0xF7, EXT_NEG, RAX);
+            }
+            else
+            {
+                emitMovImm32(buffer, RAX, 0);
+            }
+            size_t done = emitJump(buffer, CONDITION_ALWAYS);
+
+            patchJump(buffer, divide, buffer->size);
+            emitByte(buffer, 0x48);     // cqo
+            emitByte(buffer, 0x99);
+            emitUnary(buffer, true, 0xF7, EXT_IDIV, RCX);
+            if (command->opcode == OPCODE_imod)
+            {
+                emitMovRegs(buffer, RAX, RDX);
+            }
+            patchJump(buffer, done, buffer->size);
+            break;
+        }
+
+        case OPCODE_icmp:
+        {
+            // flags = INT_FLAGS_OF(rN, source), `rN` is not changed
+            emitCmpRegs(buffer, true, RAX, RCX);
+            emitMovImm32(buffer, RCX, EQUAL_FLAG);
+            size_t equal = emitJump(buffer, CONDITION_ZERO);
+            emitMovImm32(buffer, RCX, LOWER_FLAG);
+            size_t lower = emitJump(buffer, CONDITION_LESS);
+            emitMovImm32(buffer, RCX, GREATER_FLAG);
+
+            patchJump(buffer, equal, buffer->size);
+            patchJump(buffer, lower, buffer->size);
+            emitLoad(buffer, RAX, STATE_REG, offsetof(jit_state_t, flags));
+            emitStore32(buffer, RAX, 0, RCX);
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    emitStore(buffer, INT_REGS_REG, destination, RAX);
+}
+
+/**
+ * @brief Emit native code of one command
+ * 
+ * @param compiler 
+ * @param index index of the command
+ * @param notExecuted amount of commands of the block (starting from this one) that are not executed if it exits
+ */
+static void emitCommand(jit_compiler_t *compiler, int index, int notExecuted)
+{
+    code_buffer_t *buffer               = &compiler->buffer;
+    const decoded_command_t *command    = &compiler->program->commands[index];
+
+    switch (command->opcode)
+    {
+        case OPCODE_push:
+            if (MRI_IS_MEMORY(command->MRI))
+            {
+                emitRamIndex(compiler, index, notExecuted);
+                emitRamAccess(compiler, SSE_MOVSD_LOAD, 0, index, notExecuted);
+            }
+            else
+            {
+                emitOperandValue(buffer, command);
+            }
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_STORE, 0, SP_REG, 0);
+            emitAluRegImm(buffer, true, EXT_ADD, SP_REG, ELEMENT_SIZE);
+            break;
+
+        case OPCODE_pop:
+            if (MRI_IS_MEMORY(command->MRI))
+            {
+                // Address is checked before the value is popped (side exit leaves the stack untouched)
+                emitRamIndex(compiler, index, notExecuted);
+                emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 1, SP_REG, -ELEMENT_SIZE);
+                emitRamAccess(compiler, SSE_MOVSD_STORE, 1, index, notExecuted);
+            }
+            else if (command->intDestination != ZERO_INT_REGISTER)
+            {
+                emitIntRegisterMove(compiler, command, index, notExecuted);
+            }
+            else
+            {
+                emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 1, SP_REG, -ELEMENT_SIZE);
+                emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_STORE, 1, REGS_REG, command->destination * ELEMENT_SIZE);
+            }
+            emitAluRegImm(buffer, true, EXT_SUB, SP_REG, ELEMENT_SIZE);
+            break;
+
+        case OPCODE_add:
+        case OPCODE_sub:
+        case OPCODE_mul:
+        case OPCODE_div:
+        {
+            int instruction = SSE_ADDSD;
+            if (command->opcode == OPCODE_sub)
+            {
+                instruction = SSE_SUBSD;
+            }
+            else if (command->opcode == OPCODE_mul)
+            {
+                instruction = SSE_MULSD;
+            }
+            else if (command->opcode == OPCODE_div)
+            {
+                instruction = SSE_DIVSD;
+            }
+
+            // v1 (top) `op` v2
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_LOAD, 0, SP_REG, -ELEMENT_SIZE);
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, instruction, 0, SP_REG, -2 * ELEMENT_SIZE);
+            emitAluRegImm(buffer, true, EXT_SUB, SP_REG, ELEMENT_SIZE);
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_STORE, 0, SP_REG, -ELEMENT_SIZE);
+            break;
+        }
+
+        case OPCODE_sqrt:
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_SQRTSD, 0, SP_REG, -ELEMENT_SIZE);
+            emitSseMem(buffer, SSE_PREFIX_DOUBLE, SSE_MOVSD_STORE, 0, SP_REG, -ELEMENT_SIZE);
+            break;
+
+        case OPCODE_in:
+            emitCallback(buffer, offsetof(jit_state_t, in));
+            break;
+
+        case OPCODE_out:
+            emitCallback(buffer, offsetof(jit_state_t, out));
+            break;
+
+        case OPCODE_outc:
+            emitCallback(buffer, offsetof(jit_state_t, outc));
+            break;
+
+        case OPCODE_cmp:
+            emitCompare(buffer);
+            break;
+
+        case OPCODE_fcmp:
+            emitFlagsCompare(buffer);
+            break;
+
+        case OPCODE_jmp:
+            emitLink(compiler, command->target);
+            break;
+
+        case OPCODE_call:
+            emitCallPush(compiler, command, index, notExecuted);
+            emitLink(compiler, command->target);
+            break;
+
+        case OPCODE_ret:
+            // rcx - return address, it must be the start of the compiled block
+            emitCallPop(compiler, index, notExecuted);
+            emitLoad(buffer, RDX, STATE_REG, offsetof(jit_state_t, entries));
+            emitLoadIndex(buffer, RDX, RDX, RCX);
+            emitTest(buffer, RDX, RDX);
+            addSideExit(compiler, emitJump(buffer, CONDITION_ZERO), index, notExecuted);
+
+            emitStore32(buffer, STATE_REG, offsetof(jit_state_t, callDepth), RAX);
+            emitRex(buffer, false, 0, 0, RDX);
+            emitByte(buffer, 0xFF);
+            emitRegs(buffer, EXT_JMP, RDX);
+            break;
+
+        case OPCODE_je:
+        case OPCODE_jl:
+        case OPCODE_jg:
+        case OPCODE_jne:
+            emitConditionalJump(compiler, command, index + 1);
+            break;
+
+        case OPCODE_fje:
+        case OPCODE_fjne:
+        case OPCODE_fjl:
+        case OPCODE_fjle:
+        case OPCODE_fjg:
+        case OPCODE_fjge:
+        case OPCODE_fjeof:
+            addLink(compiler, emitJump(buffer, emitFlagsTest(buffer, command)), command->target);
+            emitLink(compiler, index + 1);
+            break;
+
+        case OPCODE_imov:
+        case OPCODE_iadd:
+        case OPCODE_isub:
+        case OPCODE_imul:
+        case OPCODE_idiv:
+        case OPCODE_imod:
+        case OPCODE_iand:
+        case OPCODE_ior:
+        case OPCODE_ixor:
+        case OPCODE_ishl:
+        case OPCODE_ishr:
+        case OPCODE_icmp:
+            emitIntegerCommand(compiler, index, notExecuted);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Emit the prologue of a piece of native code: counting of its commands and the check of the operand stack
+ * 
+ * @param compiler 
+ * @param command index of the first command (side exit target)
+ * @param length amount of commands of the piece
+ * @param minDepth lowest stack depth relative to the entry
+ * @param maxDepth highest stack depth relative to the entry
+ */
+static void emitPrologue(jit_compiler_t *compiler, int command, int length, int minDepth, int maxDepth)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    // Commands are counted once per piece (side exits subtract the ones that were not executed)
+    emitAluMemImm(buffer, EXT_ADD, STATE_REG, offsetof(jit_state_t, commands), length);
+
+    // Stack underflow/overflow is handled by the interpreter
+    if (minDepth < 0)
+    {
+        emitLea(buffer, RAX, SP_REG, minDepth * ELEMENT_SIZE);
+        emitCmpRegs(buffer, true, RAX, BASE_REG);
+        addSideExit(compiler, emitJump(buffer, CONDITION_BELOW), command, length);
+        compiler->exits[compiler->exitsCount - 1].linkable = false;
+    }
+    if (maxDepth > 0)
+    {
+        emitLea(buffer, RAX, SP_REG, maxDepth * ELEMENT_SIZE);
+        emitCmpMem(buffer, true, RAX, STATE_REG, offsetof(jit_state_t, stackLimit));
+        addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE), command, length);
+        compiler->exits[compiler->exitsCount - 1].linkable = false;
+    }
+}
+
+/**
+ * @brief Emit the side exits collected since the last call (they return the index of the command to the processor)
+ * 
+ * @param compiler 
+ */
+static void emitSideExits(jit_compiler_t *compiler)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    for (int exit = 0; exit < compiler->exitsCount; ++exit)
+    {
+        if (compiler->exits[exit].fault)
+        {
+            addFault(compiler, compiler->exits[exit].position, buffer->size);
+        }
+        else
+        {
+            patchJump(buffer, compiler->exits[exit].position, buffer->size);
+        }
+        if (compiler->exits[exit].notExecuted > 0)
+        {
+            emitAluMemImm(buffer, EXT_SUB, STATE_REG, offsetof(jit_state_t, commands), compiler->exits[exit].notExecuted);
+        }
+        emitMovImm32(buffer, RAX, compiler->exits[exit].command);
+
+        size_t exitJump = emitJump(buffer, CONDITION_ALWAYS);
+        patchJump(buffer, exitJump, compiler->exitStub);
+        if (compiler->exits[exit].linkable)
+        {
+            addUnlinkedExit(compiler, exitJump, compiler->exits[exit].command);
+        }
+    }
+    compiler->exitsCount = 0;
+}
+
+/**
+ * @brief Emit native code of the basic block [first, last)
+ * 
+ * @param compiler 
+ * @param first 
+ * @param last 
+ */
+static void emitBlock(jit_compiler_t *compiler, int first, int last)
+{
+    const decoded_command_t *commands = compiler->program->commands;
+
+    // Stack depth the block needs and the maximum depth it reaches (relative to the entry)
+    int depth       = 0;
+    int minDepth    = 0;
+    int maxDepth    = 0;
+    for (int cmd = first; cmd < last; ++cmd)
+    {
+        int pops    = 0;
+        int pushes  = 0;
+        jitGetStackEffect(&commands[cmd], &pops, &pushes);
+
+        depth -= pops;
+        minDepth = depth < minDepth ? depth : minDepth;
+        depth += pushes;
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+    }
+
+    emitPrologue(compiler, first, last - first, minDepth, maxDepth);
+
+    // Commands
+    for (int cmd = first; cmd < last; ++cmd)
+    {
+        emitCommand(compiler, cmd, last - cmd);
+    }
+
+    if (!isBlockTerminator(&commands[last - 1]))
+    {
+        emitLink(compiler, last);
+    }
+
+    emitSideExits(compiler);
+}
+
+/**
+ * @brief Emit guard of the conditional jump of the trace (exits to the jump itself if the outcome differs from the recorded one)
+ * 
+ * @param compiler 
+ * @param entry 
+ * @param notExecuted 
+ */
+static void emitBranchGuard(jit_compiler_t *compiler, const jit_trace_entry_t *entry, int notExecuted)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+    const decoded_command_t *command = &compiler->program->commands[entry->command];
+
+    emitBranchCondition(buffer, command);
+
+    // Taken: `jne` - |difference| > EPS, others - |difference| < EPS
+    if (entry->taken)
+    {
+        if (command->opcode == OPCODE_jne)
+        {
+            addSideExit(compiler, emitJump(buffer, CONDITION_BELOW_EQUAL), entry->command, notExecuted);
+        }
+        else
+        {
+            addSideExit(compiler, emitJump(buffer, CONDITION_PARITY), entry->command, notExecuted);
+            addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE_EQUAL), entry->command, notExecuted);
+        }
+
+        emitAluRegImm(buffer, true, EXT_SUB, SP_REG, ELEMENT_SIZE);
+    }
+    else
+    {
+        if (command->opcode == OPCODE_jne)
+        {
+            addSideExit(compiler, emitJump(buffer, CONDITION_ABOVE), entry->command, notExecuted);
+        }
+        else
+        {
+            size_t unordered = emitJump(buffer, CONDITION_PARITY);
+            addSideExit(compiler, emitJump(buffer, CONDITION_BELOW), entry->command, notExecuted);
+            patchJump(buffer, unordered, buffer->size);
+        }
+    }
+}
+
+/**
+ * @brief Emit native code of the recorded trace (the path is fixed, branches and returns become guards)
+ * 
+ * @param compiler 
+ * @param trace 
+ * @param length 
+ */
+static void emitTrace(jit_compiler_t *compiler, const jit_trace_entry_t *trace, int length)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+    const decoded_command_t *commands = compiler->program->commands;
+
+    // Stack depth the trace needs and the maximum depth it reaches (the path is known, so taken jumps pop)
+    int depth       = 0;
+    int minDepth    = 0;
+    int maxDepth    = 0;
+    for (int entry = 0; entry < length; ++entry)
+    {
+        int pops    = 0;
+        int pushes  = 0;
+        jitGetStackEffect(&commands[trace[entry].command], &pops, &pushes);
+        if (trace[entry].taken)
+        {
+            pushes = 0;
+        }
+
+        depth -= pops;
+        minDepth = depth < minDepth ? depth : minDepth;
+        depth += pushes;
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+    }
+
+    emitPrologue(compiler, trace[0].command, length, minDepth, maxDepth);
+
+    for (int entry = 0; entry < length; ++entry)
+    {
+        const decoded_command_t *command = &commands[trace[entry].command];
+        int notExecuted = length - entry;
+
+        switch (command->opcode)
+        {
+            case OPCODE_jmp:
+                break;
+
+            case OPCODE_call:
+                emitCallPush(compiler, command, trace[entry].command, notExecuted);
+                break;
+
+            case OPCODE_ret:
+            {
+                // Return address must be the one of the recorded path
+                int next = entry + 1 < length ? trace[entry + 1].command : compiler->traceNext;
+                emitCallPop(compiler, trace[entry].command, notExecuted);
+                emitAluRegImm(buffer, false, EXT_CMP, RCX, (int) commands[next].address);
+                addSideExit(compiler, emitJump(buffer, CONDITION_NOT_ZERO), trace[entry].command, notExecuted);
+                emitStore32(buffer, STATE_REG, offsetof(jit_state_t, callDepth), RAX);
+                break;
+            }
+
+            case OPCODE_je:
+            case OPCODE_jl:
+            case OPCODE_jg:
+            case OPCODE_jne:
+                emitBranchGuard(compiler, &trace[entry], notExecuted);
+                break;
+
+            case OPCODE_fje:
+            case OPCODE_fjne:
+            case OPCODE_fjl:
+            case OPCODE_fjle:
+            case OPCODE_fjg:
+            case OPCODE_fjge:
+        case OPCODE_fjeof:
+            {
+                // Exit if the outcome differs from the recorded one (condition code ^ 1 is the opposite one)
+                int taken = emitFlagsTest(buffer, command);
+                addSideExit(compiler, emitJump(buffer, trace[entry].taken ? taken ^ 1 : taken), trace[entry].command, notExecuted);
+                break;
+            }
+
+            default:
+                emitCommand(compiler, trace[entry].command, notExecuted);
+                break;
+        }
+    }
+
+    emitLink(compiler, compiler->traceNext);
+    emitSideExits(compiler);
+}
+
+/**
+ * @brief Emit the entry (`jit_entry_t`) and the common exit of the native code
+ * 
+ * @param compiler 
+ */
+static void emitEntryAndExit(jit_compiler_t *compiler)
+{
+    code_buffer_t *buffer = &compiler->buffer;
+
+    // Entry: save callee-saved registers, load the state into registers, jump to the block
+    const int savedRegs[] = {RBX, RBP, R12, R13, R14, R15};
+    const int savedRegsCount = (int) (sizeof(savedRegs) / sizeof(savedRegs[0]));
+    for (int reg = 0; reg < savedRegsCount; ++reg)
+    {
+        emitPush(buffer, savedRegs[reg]);
+    }
+    emitAluRegImm(buffer, true, EXT_SUB, RSP, 8);  // Stack alignment for the callbacks
+
+    emitMovRegs(buffer, STATE_REG, RDI);
+    emitLoad(buffer, SP_REG,    STATE_REG, offsetof(jit_state_t, sp));
+    emitLoad(buffer, REGS_REG,  STATE_REG, offsetof(jit_state_t, regs));
+    emitLoad(buffer, RAM_REG,   STATE_REG, compiler->ramPaged ? offsetof(jit_state_t, tlb) : offsetof(jit_state_t, RAM));
+    emitLoad(buffer, BASE_REG,  STATE_REG, offsetof(jit_state_t, stackBase));
+    emitLoad(buffer, INT_REGS_REG, STATE_REG, offsetof(jit_state_t, intRegs));
+    emitRex(buffer, false, 0, 0, RSI);
+    emitByte(buffer, 0xFF);
+    emitRegs(buffer, EXT_JMP, RSI);
+
+    // Exit: eax - index of the command to continue with
+    compiler->exitStub = buffer->size;
+    emitStore(buffer, STATE_REG, offsetof(jit_state_t, sp), SP_REG);
+    emitAluRegImm(buffer, true, EXT_ADD, RSP, 8);
+    for (int reg = savedRegsCount - 1; reg >= 0; --reg)
+    {
+        emitPop(buffer, savedRegs[reg]);
+    }
+    emitByte(buffer, 0xC3);
+}
+
+/**
+ * @brief Function that determines the basic blocks of the program (commands that can not be translated are blocks of their own)
+ * 
+ * @param compiler 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES findLeaders(jit_compiler_t *compiler)
+{
+    // Error check
+    if (compiler == NULL || compiler->program == NULL || compiler->isLeader == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Find leaders
+    const decoded_program_t *program = compiler->program;
+    compiler->isLeader[0] = true;
+    for (int cmd = 0; cmd < program->commandsCount; ++cmd)
+    {
+        const decoded_command_t *command = &program->commands[cmd];
+
+        if (!jitCanCompile(command))
+        {
+            compiler->isLeader[cmd]     = true;
+            compiler->isLeader[cmd + 1] = true;
+        }
+        else if (isBlockTerminator(command))
+        {
+            compiler->isLeader[cmd + 1] = true;
+            if (command->opcode != OPCODE_ret)
+            {
+                compiler->isLeader[command->target] = true;
+            }
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that allocates the code buffer and the tables of the JIT, emits the entry and the exit of the native code
+ * 
+ * @param jit 
+ * @param program 
+ * @param capacity size of the code buffer
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES jitAllocate(jit_t *jit, const decoded_program_t *program, size_t capacity)
+{
+    // Error check
+    if (jit == NULL || program == NULL || program->commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation
+    void *code = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_ALLOCATING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    jit->code           = (byte *) code;
+    jit->codeCapacity   = capacity;
+
+    jit->blockEntries = (const void **) calloc((size_t) program->commandsCount + 1, sizeof(void *));
+    CHECK_CALLOC_RESULT(jit->blockEntries);
+
+    jit->entries = (const void **) calloc(program->bytesCount + 1, sizeof(void *));
+    CHECK_CALLOC_RESULT(jit->entries);
+
+    // Entry and exit
+    jit_compiler_t compiler = {};
+    compiler.program            = program;
+    compiler.buffer.data        = jit->code;
+    compiler.buffer.capacity    = jit->codeCapacity;
+    compiler.ramPaged           = jit->ramPaged;
+
+    emitEntryAndExit(&compiler);
+    memcpy(&jit->enter, &jit->code, sizeof(jit->enter));  // Object pointer -> function pointer
+
+    jit->exitStub = compiler.exitStub;
+    jit->codeSize = compiler.buffer.size;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that patches the jumps between pieces of native code (the ones to commands without native code exit to the interpreter)
+ * 
+ * @param jit 
+ * @param compiler 
+ */
+static void jitResolveLinks(jit_t *jit, jit_compiler_t *compiler)
+{
+    for (int link = 0; link < compiler->linksCount; ++link)
+    {
+        int target = compiler->links[link].command;
+        if (jit->blockEntries[target] != NULL)
+        {
+            patchJump(&compiler->buffer, compiler->links[link].position, (size_t) ((const byte *) jit->blockEntries[target] - jit->code));
+        }
+        else
+        {
+            patchJump(&compiler->buffer, compiler->links[link].position, compiler->buffer.size);
+            emitMovImm32(&compiler->buffer, RAX, target);
+
+            size_t exitJump = emitJump(&compiler->buffer, CONDITION_ALWAYS);
+            patchJump(&compiler->buffer, exitJump, compiler->exitStub);
+            addUnlinkedExit(compiler, exitJump, target);
+        }
+    }
+    compiler->linksCount = 0;
+}
+
+/**
+ * @brief Function that translates every basic block of the decoded program into native code
+ * 
+ * @param jit 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitCtor(jit_t *jit, const decoded_program_t *program)
+{
+    // Error check
+    if (jit == NULL || program == NULL || program->commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation
+    IS_ERROR(jitAllocate(jit, program, JIT_PROLOGUE_SIZE + MAX_COMMAND_CODE * (size_t) (program->commandsCount + 1)))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_ALLOCATING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    jit_compiler_t compiler = {};
+    compiler.program            = program;
+    compiler.buffer.data        = jit->code;
+    compiler.buffer.size        = jit->codeSize;
+    compiler.buffer.capacity    = jit->codeCapacity;
+    compiler.exitStub           = jit->exitStub;
+    compiler.ramGuarded         = jit->ramGuarded;
+    compiler.ramPaged           = jit->ramPaged;
+    compiler.jit                = jit;
+
+    compiler.isLeader   = (bool *)              calloc((size_t) program->commandsCount + 1, sizeof(bool));
+    compiler.links      = (jit_link_t *)        calloc(3 * (size_t) program->commandsCount + 1, sizeof(jit_link_t));
+    compiler.exits      = (jit_side_exit_t *)   calloc(5 * (size_t) program->commandsCount + 2, sizeof(jit_side_exit_t));
+    if (compiler.isLeader == NULL || compiler.links == NULL || compiler.exits == NULL)
+    {
+        free(compiler.isLeader);
+        free(compiler.links);
+        free(compiler.exits);
+
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_STD_FUNC_RESULT);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    // Translation
+    IS_OK_WO_EXIT(findLeaders(&compiler));
+    for (int first = 0; first < program->commandsCount; )
+    {
+        int last = first + 1;
+        while (last < program->commandsCount && !compiler.isLeader[last])
+        {
+            ++last;
+        }
+
+        ++jit->blocksCount;
+        if (jitCanCompile(&program->commands[first]))
+        {
+            jit->blockEntries[first] = jit->code + compiler.buffer.size;
+            jit->entries[program->commands[first].address] = jit->blockEntries[first];
+            ++jit->compiledBlocksCount;
+
+            emitBlock(&compiler, first, last);
+        }
+
+        first = last;
+    }
+
+    jitResolveLinks(jit, &compiler);
+
+    free(compiler.isLeader);
+    free(compiler.links);
+    free(compiler.exits);
+
+    jit->codeSize = compiler.buffer.size;
+    if (compiler.buffer.overflow)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::CODE_BUFFER_OVERFLOW);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // W^X: code is not writable anymore
+    if (mprotect(jit->code, jit->codeCapacity, PROT_READ | PROT_EXEC) != 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_PROTECTING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that prepares the JIT for the traces (they are compiled later by `jitCompileTrace`)
+ * 
+ * @param jit 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitTracesCtor(jit_t *jit, const decoded_program_t *program)
+{
+    // Error check
+    if (jit == NULL || program == NULL || program->commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation
+    IS_ERROR(jitAllocate(jit, program, (size_t) JIT_TRACE_BUFFER_SIZE))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_ALLOCATING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    if (mprotect(jit->code, jit->codeCapacity, PROT_READ | PROT_EXEC) != 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_PROTECTING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that translates the recorded trace into native code (it becomes the entry of its first command)
+ * 
+ * @param jit 
+ * @param program 
+ * @param trace 
+ * @param length 
+ * @param next index of the command executed after the last one of the trace (the first one for a loop)
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitCompileTrace(jit_t *jit, const decoded_program_t *program, const jit_trace_entry_t *trace, int length, int next)
+{
+    // Error check
+    if (jit == NULL || jit->code == NULL || program == NULL || trace == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    if (length <= 0 || next < 0 || next > program->commandsCount || jit->blockEntries[trace[0].command] != NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::TRACE_IS_NOT_COMPILABLE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    for (int entry = 0; entry < length; ++entry)
+    {
+        if (trace[entry].command < 0 || trace[entry].command >= program->commandsCount || !jitCanCompile(&program->commands[trace[entry].command]))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::TRACE_IS_NOT_COMPILABLE);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+
+    // Translation
+    jit_compiler_t compiler = {};
+    compiler.program            = program;
+    compiler.buffer.data        = jit->code;
+    compiler.buffer.size        = jit->codeSize;
+    compiler.buffer.capacity    = jit->codeCapacity;
+    compiler.exitStub           = jit->exitStub;
+    compiler.ramGuarded         = jit->ramGuarded;
+    compiler.ramPaged           = jit->ramPaged;
+    compiler.jit                = jit;
+    compiler.traceNext          = next;
+    compiler.traces             = jit;
+
+    jit_link_t link = {};
+    compiler.links = &link;
+    compiler.exits = (jit_side_exit_t *) calloc(5 * (size_t) length + 2, sizeof(jit_side_exit_t));
+    CHECK_CALLOC_RESULT(compiler.exits);
+
+    if (mprotect(jit->code, jit->codeCapacity, PROT_READ | PROT_WRITE) != 0)
+    {
+        free(compiler.exits);
+
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_PROTECTING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    size_t entry = compiler.buffer.size;
+    int unlinkedExitsCount = jit->unlinkedExitsCount;
+    int faultsCount = jit->faultsCount;
+    jit->blockEntries[trace[0].command] = jit->code + entry;   // Loop trace jumps to itself
+
+    emitTrace(&compiler, trace, length);
+    jitResolveLinks(jit, &compiler);
+
+    free(compiler.exits);
+
+    bool overflow = compiler.buffer.overflow;
+    if (overflow)
+    {
+        jit->blockEntries[trace[0].command] = NULL;
+        jit->unlinkedExitsCount = unlinkedExitsCount;
+        jit->faultsCount        = faultsCount;
+    }
+    else
+    {
+        jit->codeSize = compiler.buffer.size;
+        ++jit->compiledBlocksCount;
+
+        // Exits of the other traces to this command go straight to the new trace
+        for (int exit = 0; exit < jit->unlinkedExitsCount; )
+        {
+            if (jit->unlinkedExits[exit].command == trace[0].command)
+            {
+                patchJump(&compiler.buffer, jit->unlinkedExits[exit].position, entry);
+                jit->unlinkedExits[exit] = jit->unlinkedExits[--jit->unlinkedExitsCount];
+            }
+            else
+            {
+                ++exit;
+            }
+        }
+    }
+
+    if (mprotect(jit->code, jit->codeCapacity, PROT_READ | PROT_EXEC) != 0)
+    {
+        jit->blockEntries[trace[0].command] = NULL;
+
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::ERROR_PROTECTING_CODE_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    if (overflow)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(JIT_EXIT_CODES::CODE_BUFFER_OVERFLOW);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that finds the side exit of the faulting RAM access of the native code (NULL if it is not one of them)
+ * 
+ * Called from the signal handler: only reads the table (it is sorted, the code is appended only)
+ * 
+ * @param jit 
+ * @param instruction 
+ * @return const void* 
+ */
+const void *jitResolveFault(const jit_t *jit, const void *instruction)
+{
+    if (jit == NULL || jit->code == NULL || (const byte *) instruction < jit->code)
+    {
+        return NULL;
+    }
+
+    size_t position = (size_t) ((const byte *) instruction - jit->code);
+    int left  = 0;
+    int right = jit->faultsCount;
+    while (left < right)
+    {
+        int middle = left + (right - left) / 2;
+        if (jit->faults[middle].instruction < position)
+        {
+            left = middle + 1;
+        }
+        else
+        {
+            right = middle;
+        }
+    }
+
+    if (left < jit->faultsCount && jit->faults[left].instruction == position)
+    {
+        return jit->code + jit->faults[left].exit;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Function that frees the native code and all the tables of the JIT
+ * 
+ * @param jit 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitDtor(jit_t *jit)
+{
+    // Error check
+    if (jit == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Destruction
+    if (jit->code != NULL)
+    {
+        munmap(jit->code, jit->codeCapacity);
+    }
+    free(jit->blockEntries);
+    free(jit->entries);
+    free(jit->unlinkedExits);
+    free(jit->faults);
+
+    *jit = {};
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+#else
+
+/**
+ * @brief Function that translates every basic block of the decoded program into native code (not supported on this host)
+ * 
+ * @param jit 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitCtor(jit_t *jit, const decoded_program_t *program)
+{
+    (void) jit;
+    (void) program;
+
+    return EXIT_CODES::BAD_OBJECT_PASSED;
+}
+
+/**
+ * @brief Function that frees the native code and all the tables of the JIT
+ * 
+ * @param jit 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitDtor(jit_t *jit)
+{
+    // Error check
+    if (jit == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    *jit = {};
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that finds the side exit of the faulting RAM access of the native code (not supported on this host)
+ * 
+ * @param jit 
+ * @param instruction 
+ * @return const void* 
+ */
+const void *jitResolveFault(const jit_t *jit, const void *instruction)
+{
+    (void) jit;
+    (void) instruction;
+
+    return NULL;
+}
+
+/**
+ * @brief Function that prepares the JIT for the traces (not supported on this host)
+ * 
+ * @param jit 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitTracesCtor(jit_t *jit, const decoded_program_t *program)
+{
+    (void) jit;
+    (void) program;
+
+    return EXIT_CODES::BAD_OBJECT_PASSED;
+}
+
+/**
+ * @brief Function that translates the recorded trace into native code (not supported on this host)
+ * 
+ * @param jit 
+ * @param program 
+ * @param trace 
+ * @param length 
+ * @param next 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitCompileTrace(jit_t *jit, const decoded_program_t *program, const jit_trace_entry_t *trace, int length, int next)
+{
+    (void) jit;
+    (void) program;
+    (void) trace;
+    (void) length;
+    (void) next;
+
+    return EXIT_CODES::BAD_OBJECT_PASSED;
+}
+
+/**
+ * @brief Function that determines whether the command can be translated into native code (never on this host)
+ * 
+ * @param command 
+ * @return bool 
+ */
+bool jitCanCompile(const decoded_command_t *command)
+{
+    (void) command;
+
+    return false;
+}
+
+#endif
+
+/**
+ * @brief Function that constructs the trace recorder of the program
+ * 
+ * @param recorder 
+ * @param program 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecorderCtor(jit_recorder_t *recorder, const decoded_program_t *program)
+{
+    // Error check
+    if (recorder == NULL || program == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation
+    recorder->loopCounters = (int *) calloc((size_t) program->commandsCount + 1, sizeof(int));
+    CHECK_CALLOC_RESULT(recorder->loopCounters);
+
+    recorder->trace = (jit_trace_entry_t *) calloc(JIT_MAX_TRACE_LENGTH, sizeof(jit_trace_entry_t));
+    CHECK_CALLOC_RESULT(recorder->trace);
+
+    recorder->length    = 0;
+    recorder->head      = NOT_RECORDING;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that destructs the trace recorder
+ * 
+ * @param recorder 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecorderDtor(jit_recorder_t *recorder)
+{
+    // Error check
+    if (recorder == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Destruction
+    free(recorder->loopCounters);
+    free(recorder->trace);
+
+    *recorder = {};
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that stops the recording of the trace without compiling it (the loop is tried again after the backoff)
+ * 
+ * @param recorder 
+ */
+static void jitAbortTrace(jit_recorder_t *recorder)
+{
+    recorder->loopCounters[recorder->head] = -JIT_TRACE_BACKOFF;
+    recorder->head      = NOT_RECORDING;
+    recorder->length    = 0;
+}
+
+/**
+ * @brief Function that handles the command executed by the interpreter: counts backward jumps and records the trace of the hot loop
+ * 
+ * @param recorder 
+ * @param jit 
+ * @param program 
+ * @param command index of the executed command
+ * @param ip address of the next command
+ * @param popped the command decreased the stack (outcome of the conditional jump)
+ * @param flags flags register after the command (outcome of the flags jump)
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecordCommand(jit_recorder_t *recorder, const jit_t *jit, const decoded_program_t *program, int command, int ip, bool popped, int flags)
+{
+    // Error check
+    if (recorder == NULL || jit == NULL || program == NULL || recorder->loopCounters == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    if (command < 0 || command >= program->commandsCount)
+    {
+        if (recorder->head != NOT_RECORDING)
+        {
+            jitAbortTrace(recorder);
+        }
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    const decoded_command_t *executed = &program->commands[command];
+    bool isConditionalJump  = executed->opcode == OPCODE_je || executed->opcode == OPCODE_jl ||
+                              executed->opcode == OPCODE_jg || executed->opcode == OPCODE_jne;
+    bool isFlagsJump        = executed->opcode == OPCODE_fje || executed->opcode == OPCODE_fjne ||
+                              executed->opcode == OPCODE_fjl || executed->opcode == OPCODE_fjle ||
+                              executed->opcode == OPCODE_fjg || executed->opcode == OPCODE_fjge ||
+                              executed->opcode == OPCODE_fjeof;
+    bool isJump             = isConditionalJump || isFlagsJump || executed->opcode == OPCODE_jmp;
+
+    // Recording
+    if (recorder->head != NOT_RECORDING)
+    {
+        if (!jitCanCompile(executed) || recorder->length >= JIT_MAX_TRACE_LENGTH)
+        {
+            jitAbortTrace(recorder);
+            return EXIT_CODES::NO_ERRORS;
+        }
+
+        recorder->trace[recorder->length].command   = command;
+        // The outcome is not seen from `ip`: a jump to the next command leaves the same `ip` either way
+        bool flagsSet = (flags & getFlagsJumpMask(executed->opcode)) != 0;
+        recorder->trace[recorder->length].taken     = (isConditionalJump && popped) ||
+                                                      (isFlagsJump && (executed->opcode == OPCODE_fjne ? !flagsSet : flagsSet));
+        ++recorder->length;
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Backward jump: the target is a loop header (without native code yet)
+    if (isJump && ip >= 0 && (size_t) ip <= executed->address && (size_t) ip < program->bytesCount)
+    {
+        int header = program->commandIndex[ip];
+        if (header != BAD_TARGET && jit->blockEntries[header] == NULL && ++recorder->loopCounters[header] > JIT_HOT_LOOP_THRESHOLD)
+        {
+            recorder->loopCounters[header] = 0;
+            recorder->head      = header;
+            recorder->length    = 0;
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that handles the exit from the native code: the hot exit becomes the start of a new trace
+ * 
+ * @param recorder 
+ * @param jit 
+ * @param command index of the command the native code exited to
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitRecordSideExit(jit_recorder_t *recorder, const jit_t *jit, int command)
+{
+    // Error check
+    if (recorder == NULL || jit == NULL || recorder->loopCounters == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Counting
+    if (recorder->head == NOT_RECORDING && command >= 0 && jit->blockEntries[command] == NULL &&
+        ++recorder->loopCounters[command] > JIT_HOT_LOOP_THRESHOLD)
+    {
+        recorder->loopCounters[command] = 0;
+        recorder->head      = command;
+        recorder->length    = 0;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that finishes the recording: the trace is compiled if the loop is closed or the next command has native code
+ * 
+ * @param jit 
+ * @param recorder 
+ * @param program 
+ * @param next index of the command that is about to be executed
+ * @return EXIT_CODES 
+ */
+EXIT_CODES jitFinishTrace(jit_t *jit, jit_recorder_t *recorder, const decoded_program_t *program, int next)
+{
+    // Error check
+    if (jit == NULL || recorder == NULL || program == NULL || recorder->head == NOT_RECORDING)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Compilation
+    if (recorder->length == 0)
+    {
+        jitAbortTrace(recorder);
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    IS_ERROR(jitCompileTrace(jit, program, recorder->trace, recorder->length, next))
+    {
+        jitAbortTrace(recorder);
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    recorder->head      = NOT_RECORDING;
+    recorder->length    = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
@@ -0,0 +1,1376 @@
+#include <stdlib.h>     // for calloc, realloc, free
+#include <string.h>     // for memcpy, memset
+#include <math.h>       // for sqrt
+#include <limits.h>     // for INT_MAX
+
+#include "include/opcodes.h"
+#include "include/processor/lockstep.h"
+#include "include/processor/settings.h"
+
+#if LOCKSTEP_AVX2_SUPPORTED
+    #include <immintrin.h>  // for _mm256_sqrt_pd
+#endif
+
+#define LOCKSTEP_INLINE inline __attribute__((always_inline))  // Vector code is compiled for the target of the engine it is inlined into
+
+/**
+ * @brief Vectors of one row of the lanes (GCC vector extensions, they are AVX2 registers in the functions of "avx2" target)
+ * 
+ */
+template <int LANES>
+struct lockstep_vectors_t
+{
+    typedef double              value_t     __attribute__((vector_size(LANES * sizeof(double))));
+    typedef long long           integer_t   __attribute__((vector_size(LANES * sizeof(long long))));   // Also the masks of the lanes (-1 is set)
+    typedef unsigned long long  unsigned_t  __attribute__((vector_size(LANES * sizeof(long long))));   // Two's complement arithmetic
+};
+
+/**
+ * @brief Structure that represents the group of lanes executed at once: the running lanes at the same command with the same stack and call depth
+ * 
+ */
+struct lockstep_group_t
+{
+    int lanes                           = 0;        // Bit of every lane of the group
+    int size                            = 0;
+    int ip                              = 0;
+    int stackSize                       = 0;
+    int callDepth                       = 0;
+    int nextIp                          = INT_MAX;  // The group is rescheduled when it gets here (the nearest command of the other running lanes)
+    int runningCount                    = 0;        // Running lanes, including the ones outside of the group
+    int divergentSteps                  = 0;        // Steps in a row without some of the running lanes
+};
+
+/**
+ * @brief Function that writes the state of the lanes of `laneBits` (they are not in the group anymore)
+ * 
+ * @param lockstep 
+ * @param laneBits 
+ * @param ip 
+ * @param stackSize 
+ * @param callDepth 
+ * @param state 
+ */
+static void lockstepPark(lockstep_t *lockstep, int laneBits, int ip, int stackSize, int callDepth, LOCKSTEP_LANE_STATES state)
+{
+    for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+    {
+        if ((laneBits >> lane & 1) != 0)
+        {
+            lockstep->lanes[lane].state     = state;
+            lockstep->lanes[lane].ip        = ip;
+            lockstep->lanes[lane].stackSize = stackSize;
+            lockstep->lanes[lane].callDepth = callDepth;
+        }
+    }
+}
+
+/**
+ * @brief Function that makes the new group: the running lanes at the smallest command (the other lanes wait until the group gets to them)
+ * 
+ * @param lockstep 
+ * @param group 
+ */
+static void lockstepSchedule(lockstep_t *lockstep, lockstep_group_t *group)
+{
+    const lockstep_lane_t *lanes = lockstep->lanes;
+
+    int leader = -1;
+    group->runningCount = 0;
+    for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+    {
+        if (lanes[lane].state == LOCKSTEP_LANE_STATES::RUNNING)
+        {
+            group->runningCount += 1;
+            if (leader == -1 || lanes[lane].ip < lanes[leader].ip)
+            {
+                leader = lane;
+            }
+        }
+    }
+
+    group->lanes    = 0;
+    group->size     = 0;
+    group->nextIp   = INT_MAX;
+    if (leader == -1)
+    {
+        return;
+    }
+
+    group->ip           = lanes[leader].ip;
+    group->stackSize    = lanes[leader].stackSize;
+    group->callDepth    = lanes[leader].callDepth;
+    for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+    {
+        if (lanes[lane].state != LOCKSTEP_LANE_STATES::RUNNING)
+        {
+            continue;
+        }
+
+        if (lanes[lane].ip == group->ip && lanes[lane].stackSize == group->stackSize && lanes[lane].callDepth == group->callDepth)
+        {
+            group->lanes |= 1 << lane;
+            group->size  += 1;
+        }
+        else
+        {
+            // Lanes at the same command with another stack run after this command
+            int ip = lanes[lane].ip == group->ip ? group->ip + 1 : lanes[lane].ip;
+            group->nextIp = ip < group->nextIp ? ip : group->nextIp;
+        }
+    }
+}
+
+/**
+ * @brief Function that takes the lanes of `laneBits` out of the group, the scalar engine runs them from the current command
+ * 
+ * @param lockstep 
+ * @param group 
+ * @param laneBits 
+ */
+static void lockstepHandOffLanes(lockstep_t *lockstep, lockstep_group_t *group, int laneBits)
+{
+    int count = __builtin_popcount((unsigned) laneBits);
+    lockstepPark(lockstep, laneBits, group->ip, group->stackSize, group->callDepth, LOCKSTEP_LANE_STATES::HANDED_OFF);
+
+    group->lanes        &= ~laneBits;
+    group->size         -= count;
+    group->runningCount -= count;
+    lockstep->stats.handOffsCount += count;
+}
+
+/**
+ * @brief Function that finishes the lanes of the group (`halt`)
+ * 
+ * @param lockstep 
+ * @param group 
+ */
+static void lockstepFinishGroup(lockstep_t *lockstep, lockstep_group_t *group)
+{
+    lockstepPark(lockstep, group->lanes, group->ip, group->stackSize, group->callDepth, LOCKSTEP_LANE_STATES::DONE);
+
+    group->runningCount -= group->size;
+    group->lanes        = 0;
+    group->size         = 0;
+}
+
+/**
+ * @brief Function that moves the group to the next command: the lanes of `takenBits` go to `takenIp`, the others go to `ip`
+ * 
+ * Lanes that go different ways are parked, so the group is rescheduled
+ * 
+ * @param lockstep 
+ * @param group 
+ * @param takenBits 
+ * @param takenIp 
+ * @param takenStackSize 
+ * @param ip 
+ */
+static void lockstepBranch(lockstep_t *lockstep, lockstep_group_t *group, int takenBits, int takenIp, int takenStackSize, int ip)
+{
+    if (takenBits == group->lanes)
+    {
+        group->ip           = takenIp;
+        group->stackSize    = takenStackSize;
+    }
+    else if (takenBits == 0)
+    {
+        group->ip = ip;
+    }
+    else
+    {
+        lockstepPark(lockstep, takenBits, takenIp, takenStackSize, group->callDepth, LOCKSTEP_LANE_STATES::RUNNING);
+        lockstepPark(lockstep, group->lanes & ~takenBits, ip, group->stackSize, group->callDepth, LOCKSTEP_LANE_STATES::RUNNING);
+
+        group->lanes    = 0;
+        group->size     = 0;
+    }
+}
+
+/**
+ * @brief Function that counts the step of the group unless the lanes are divergent for too long: the smaller part of the running lanes is handed off then
+ * 
+ * @param lockstep 
+ * @param group 
+ * @return bool some lanes are handed off (the step is not done)
+ */
+static bool lockstepDiverged(lockstep_t *lockstep, lockstep_group_t *group)
+{
+    if (group->size == group->runningCount)
+    {
+        group->divergentSteps = 0;
+    }
+    else if (++group->divergentSteps > LOCKSTEP_MAX_DIVERGENT_STEPS)
+    {
+        int parkedBits = 0;
+        for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+        {
+            if (lockstep->lanes[lane].state == LOCKSTEP_LANE_STATES::RUNNING && (group->lanes >> lane & 1) == 0)
+            {
+                parkedBits |= 1 << lane;
+            }
+        }
+
+        if (group->size < group->runningCount - group->size)
+        {
+            lockstepHandOffLanes(lockstep, group, group->lanes);
+        }
+        else
+        {
+            int count = __builtin_popcount((unsigned) parkedBits);
+            for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+            {
+                if ((parkedBits >> lane & 1) != 0)
+                {
+                    lockstep->lanes[lane].state = LOCKSTEP_LANE_STATES::HANDED_OFF;
+                }
+            }
+
+            group->runningCount -= count;
+            group->nextIp       = INT_MAX;
+            lockstep->stats.handOffsCount += count;
+        }
+
+        group->divergentSteps = 0;
+        return true;
+    }
+
+    lockstep->stats.steps           += 1;
+    lockstep->stats.laneCommands    += (unsigned long long) group->size;
+    lockstep->stats.divergentSteps  += group->size != group->runningCount;
+
+    return false;
+}
+
+/**
+ * @brief Function that makes room for one more row of the stack
+ * 
+ * @param lockstep 
+ * @param stackSize 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES lockstepReserveStack(lockstep_t *lockstep, int stackSize)
+{
+    if (stackSize < lockstep->stackCapacity)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    int capacity = lockstep->stackCapacity * 2;
+    double *stack = (double *) realloc(lockstep->stack, (size_t) capacity * (size_t) lockstep->lanesCount * sizeof(double));
+    CHECK_CALLOC_RESULT(stack);
+
+    lockstep->stack         = stack;
+    lockstep->stackCapacity = capacity;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that makes room for one more row of the call stack (there are at most `maxCallDepth` rows)
+ * 
+ * @param lockstep 
+ * @param callDepth 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES lockstepReserveCallStack(lockstep_t *lockstep, int callDepth)
+{
+    if (callDepth < lockstep->callStackCapacity)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    int capacity = lockstep->callStackCapacity == 0 ? LOCKSTEP_STACK_ROWS : lockstep->callStackCapacity * 2;
+    capacity = capacity < lockstep->maxCallDepth ? capacity : lockstep->maxCallDepth;
+    offset *callStack = (offset *) realloc(lockstep->callStack, (size_t) capacity * (size_t) lockstep->lanesCount * sizeof(offset));
+    CHECK_CALLOC_RESULT(callStack);
+
+    lockstep->callStack         = callStack;
+    lockstep->callStackCapacity = capacity;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that takes the square roots of one row
+ * 
+ * @param roots 
+ * @param values 
+ * @param count 
+ */
+static void lockstepSqrt(double *roots, const double *values, int count)
+{
+    for (int lane = 0; lane < count; ++lane)
+    {
+        roots[lane] = sqrt(values[lane]);
+    }
+}
+
+#if LOCKSTEP_AVX2_SUPPORTED
+
+/**
+ * @brief Function that takes the square roots of one row by AVX2 vectors (`count` is a multiple of 4)
+ * 
+ * @param roots 
+ * @param values 
+ * @param count 
+ */
+__attribute__((target("avx2"))) static void lockstepSqrtAvx2(double *roots, const double *values, int count)
+{
+    for (int lane = 0; lane < count; lane += 4)
+    {
+        _mm256_storeu_pd(roots + lane, _mm256_sqrt_pd(_mm256_loadu_pd(values + lane)));
+    }
+}
+
+#endif
+
+/**
+ * @brief Function that loads the row into the vector
+ * 
+ * @param vector 
+ * @param row 
+ */
+template <typename vector_t, typename element_t>
+static LOCKSTEP_INLINE void lockstepLoad(vector_t *vector, const element_t *row)
+{
+    memcpy(vector, row, sizeof(vector_t));
+}
+
+/**
+ * @brief Function that stores the lanes of the mask of the vector into the row (the other lanes of the row are kept)
+ * 
+ * @param row 
+ * @param vector 
+ * @param mask 
+ */
+template <typename vector_t, typename mask_t, typename element_t>
+static LOCKSTEP_INLINE void lockstepStore(element_t *row, const vector_t *vector, const mask_t *mask)
+{
+    vector_t blended;
+    memcpy(&blended, row, sizeof(vector_t));
+    blended = *mask ? *vector : blended;
+    memcpy(row, &blended, sizeof(vector_t));
+}
+
+/**
+ * @brief Function that sets every lane of the vector to the value
+ * 
+ * @param vector 
+ * @param value 
+ */
+template <int LANES, typename vector_t, typename element_t>
+static LOCKSTEP_INLINE void lockstepSplat(vector_t *vector, element_t value)
+{
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        (*vector)[lane] = value;
+    }
+}
+
+/**
+ * @brief Function that converts the mask vector into the lane bits
+ * 
+ * @param mask 
+ * @return int 
+ */
+template <int LANES, typename mask_t>
+static LOCKSTEP_INLINE int lockstepBits(const mask_t *mask)
+{
+    int laneBits = 0;
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        laneBits |= ((*mask)[lane] != 0) << lane;
+    }
+
+    return laneBits;
+}
+
+/**
+ * @brief Function that converts the lane bits into the mask vector
+ * 
+ * @param mask 
+ * @param laneBits 
+ */
+template <int LANES, typename mask_t>
+static LOCKSTEP_INLINE void lockstepMask(mask_t *mask, int laneBits)
+{
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        (*mask)[lane] = (laneBits >> lane & 1) != 0 ? -1 : 0;
+    }
+}
+
+/**
+ * @brief Function that evaluates the argument of the decoded command for every lane (see `cpuDecodedValue`)
+ * 
+ * @param lockstep 
+ * @param command 
+ * @param value 
+ */
+template <int LANES>
+static LOCKSTEP_INLINE void lockstepDecodedValue(const lockstep_t *lockstep, const decoded_command_t *command,
+                                                 typename lockstep_vectors_t<LANES>::value_t *value)
+{
+    typedef typename lockstep_vectors_t<LANES>::value_t     value_t;
+    typedef typename lockstep_vectors_t<LANES>::integer_t   integer_t;
+    typedef typename lockstep_vectors_t<LANES>::unsigned_t  unsigned_t;
+
+    // Arguments of the operand the command can not keep (in the order of the arguments)
+    if (command->intRegs[0] == EXTRA_INT_REGISTER)
+    {
+        const decoded_extra_regs_t *extra = &lockstep->program.extraRegs[command - lockstep->program.commands];
+
+        *value = (value_t) {};
+        integer_t sum = {};
+        bool hasIntRegs = false;
+        for (int reg = 0; reg < extra->count; ++reg)
+        {
+            if (extra->codes[reg] == EXTRA_IMMEDIATE_CODE)
+            {
+                *value += extra->immediates[reg];
+            }
+            else if (IS_INT_REGISTER_CODE(extra->codes[reg]))
+            {
+                integer_t intReg;
+                lockstepLoad(&intReg, &lockstep->intRegs[(extra->codes[reg] - INT_REGS_BASE) * LANES]);
+                sum         = (integer_t) ((unsigned_t) sum + (unsigned_t) intReg);
+                hasIntRegs  = true;
+            }
+            else
+            {
+                value_t commonReg;
+                lockstepLoad(&commonReg, &lockstep->commonRegs[extra->codes[reg] * LANES]);
+                *value += commonReg;
+            }
+        }
+
+        if (hasIntRegs)
+        {
+            *value += __builtin_convertvector(sum, value_t);
+        }
+        return;
+    }
+
+    value_t firstReg, secondReg;
+    lockstepLoad(&firstReg,  &lockstep->commonRegs[command->regs[0] * LANES]);
+    lockstepLoad(&secondReg, &lockstep->commonRegs[command->regs[1] * LANES]);
+    *value = (firstReg + command->immediate) + secondReg;
+
+    if (command->intRegs[0] != ZERO_INT_REGISTER)
+    {
+        integer_t firstIntReg, secondIntReg;
+        lockstepLoad(&firstIntReg,  &lockstep->intRegs[command->intRegs[0] * LANES]);
+        lockstepLoad(&secondIntReg, &lockstep->intRegs[command->intRegs[1] * LANES]);
+
+        integer_t sum = (integer_t) ((unsigned_t) firstIntReg + (unsigned_t) secondIntReg);
+        *value += __builtin_convertvector(sum, value_t);
+    }
+}
+
+/**
+ * @brief Function that finds the RAM cells the argument of the decoded command points to (see `cpuDecodedCell`)
+ * 
+ * @param lockstep 
+ * @param command 
+ * @param laneBits lanes to find the cells of
+ * @param cells 
+ * @return int lanes with the invalid address
+ */
+template <int LANES>
+static LOCKSTEP_INLINE int lockstepDecodedCells(const lockstep_t *lockstep, const decoded_command_t *command, int laneBits, size_t *cells)
+{
+    int invalidBits = 0;
+    if (command->intAddress)
+    {
+        const long long *firstIntReg    = &lockstep->intRegs[command->intRegs[0] * LANES];
+        const long long *secondIntReg   = &lockstep->intRegs[command->intRegs[1] * LANES];
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            long long index = WRAPPED(WRAPPED(command->intImmediate, +, firstIntReg[lane]), +, secondIntReg[lane]);
+            cells[lane] = (size_t) index;
+            if ((laneBits >> lane & 1) != 0 && (unsigned long long) index >= lockstep->RAMSize)
+            {
+                invalidBits |= 1 << lane;
+            }
+        }
+
+        return invalidBits;
+    }
+
+    typename lockstep_vectors_t<LANES>::value_t index;
+    lockstepDecodedValue<LANES>(lockstep, command, &index);
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        if ((laneBits >> lane & 1) == 0)
+        {
+            continue;
+        }
+
+        if (IS_VALID_RAM_INDEX(index[lane], lockstep->RAMSize))
+        {
+            cells[lane] = (size_t) index[lane];
+        }
+        else
+        {
+            invalidBits |= 1 << lane;
+        }
+    }
+
+    return invalidBits;
+}
+
+/**
+ * @brief Function that executes the lanes in lockstep until every one of them is done or handed off
+ * 
+ * The group is the running lanes at the smallest command, so the lanes that branched apart meet again at the first common command.
+ * Commands that may fail check every lane first: the lanes that would fail are handed off before the command,
+ * so the scalar engine reports the error exactly as it does for the run without lanes
+ * 
+ * @param lockstep 
+ * @return EXIT_CODES 
+ */
+template <int LANES, bool avx2>
+static LOCKSTEP_INLINE EXIT_CODES lockstepRun(lockstep_t *lockstep)
+{
+    typedef typename lockstep_vectors_t<LANES>::value_t     value_t;
+    typedef typename lockstep_vectors_t<LANES>::integer_t   integer_t;
+    typedef typename lockstep_vectors_t<LANES>::unsigned_t  unsigned_t;
+
+    const decoded_command_t *commands   = lockstep->program.commands;
+    lockstep_lane_t *lanes              = lockstep->lanes;
+
+    lockstep_group_t group  = {};
+    integer_t mask          = {};
+
+    #define ROW(rows, index)    (&lockstep->rows[(size_t) (index) * LANES])
+    #define STACK_ROW(depth)    ROW(stack, group.stackSize - (depth))     // Row of the value `depth` rows below the top (1 is the top)
+
+    // Lanes that would fail are handed off, the command is executed again for the others
+    #define HAND_OFF(laneBits)                                              \
+        lockstepHandOffLanes(lockstep, &group, laneBits);                   \
+        lockstepMask<LANES>(&mask, group.lanes);                            \
+        continue
+
+    #define STEP()                                                          \
+        if (lockstepDiverged(lockstep, &group))                             \
+        {                                                                   \
+            lockstepMask<LANES>(&mask, group.lanes);                        \
+            continue;                                                       \
+        }
+
+    #define NEEDS_STACK(depth)                                              \
+        if (group.stackSize < (depth))                                      \
+        {                                                                   \
+            HAND_OFF(group.lanes);                                          \
+        }
+
+    #define NEEDS_TARGET(laneBits)                                          \
+        if (command->target == BAD_TARGET && (laneBits) != 0)               \
+        {                                                                   \
+            HAND_OFF(laneBits);                                             \
+        }
+
+    #define RESERVE_STACK()                                                 \
+        IS_ERROR(lockstepReserveStack(lockstep, group.stackSize))           \
+        {                                                                   \
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;                         \
+        }
+
+    for (;;)
+    {
+        // Reconvergence
+        if (group.size == 0 || group.ip >= group.nextIp)
+        {
+            lockstepPark(lockstep, group.lanes, group.ip, group.stackSize, group.callDepth, LOCKSTEP_LANE_STATES::RUNNING);
+            lockstepSchedule(lockstep, &group);
+            lockstepMask<LANES>(&mask, group.lanes);
+            if (group.size == 0)
+            {
+                break;
+            }
+        }
+
+        const decoded_command_t *command = &commands[group.ip];
+        switch (command->opcode)
+        {
+            case OPCODE_push:
+            {
+                value_t value = {};
+                if (MRI_IS_MEMORY(command->MRI))
+                {
+                    size_t cells[LANES] = {};
+                    int invalidBits = lockstepDecodedCells<LANES>(lockstep, command, group.lanes, cells);
+                    if (invalidBits != 0)
+                    {
+                        HAND_OFF(invalidBits);
+                    }
+                    STEP();
+
+                    for (int lane = 0; lane < LANES; ++lane)
+                    {
+                        value[lane] = (group.lanes >> lane & 1) != 0 ? ROW(RAM, cells[lane])[lane] : 0;
+                    }
+                }
+                else
+                {
+                    STEP();
+                    lockstepDecodedValue<LANES>(lockstep, command, &value);
+                }
+
+                RESERVE_STACK();
+                lockstepStore(STACK_ROW(0), &value, &mask);
+                group.stackSize += 1;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_pop:
+            {
+                NEEDS_STACK(1);
+                value_t value = {};
+                lockstepLoad(&value, STACK_ROW(1));
+
+                if (MRI_IS_MEMORY(command->MRI))
+                {
+                    size_t cells[LANES] = {};
+                    int invalidBits = lockstepDecodedCells<LANES>(lockstep, command, group.lanes, cells);
+                    if (invalidBits != 0)
+                    {
+                        HAND_OFF(invalidBits);
+                    }
+                    STEP();
+
+                    for (int lane = 0; lane < LANES; ++lane)
+                    {
+                        if ((group.lanes >> lane & 1) != 0)
+                        {
+                            ROW(RAM, cells[lane])[lane] = value[lane];
+                        }
+                    }
+                }
+                else if (command->destination != ZERO_REGISTER)
+                {
+                    STEP();
+                    lockstepStore(ROW(commonRegs, command->destination), &value, &mask);
+                }
+                else if (command->intDestination != ZERO_INT_REGISTER)
+                {
+                    int badBits = 0;
+                    for (int lane = 0; lane < LANES; ++lane)
+                    {
+                        badBits |= !FITS_INT_REGISTER(value[lane]) << lane;
+                    }
+                    if ((badBits & group.lanes) != 0)
+                    {
+                        HAND_OFF(badBits & group.lanes);
+                    }
+                    STEP();
+
+                    // Lanes outside of the group may not fit, they are not stored
+                    value_t zero = {};
+                    value = mask ? value : zero;
+                    integer_t intValue = __builtin_convertvector(value, integer_t);
+                    lockstepStore(ROW(intRegs, command->intDestination), &intValue, &mask);
+                }
+                else
+                {
+                    HAND_OFF(group.lanes);
+                }
+
+                group.stackSize -= 1;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_add:
+            case OPCODE_sub:
+            case OPCODE_mul:
+            case OPCODE_div:
+            {
+                NEEDS_STACK(2);
+                STEP();
+
+                value_t first, second, result;
+                lockstepLoad(&first,  STACK_ROW(1));
+                lockstepLoad(&second, STACK_ROW(2));
+                switch (command->opcode)
+                {
+                    case OPCODE_add:    result = first + second;    break;
+                    case OPCODE_sub:    result = first - second;    break;
+                    case OPCODE_mul:    result = first * second;    break;
+                    case OPCODE_div:
+                    default:            result = first / second;    break;
+                }
+
+                lockstepStore(STACK_ROW(2), &result, &mask);
+                group.stackSize -= 1;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_sqrt:
+            {
+                NEEDS_STACK(1);
+                STEP();
+
+                double roots[LANES] = {};
+                #if LOCKSTEP_AVX2_SUPPORTED
+                    if (avx2)
+                    {
+                        lockstepSqrtAvx2(roots, STACK_ROW(1), LANES);
+                    }
+                    else
+                #endif
+                    {
+                        lockstepSqrt(roots, STACK_ROW(1), LANES);
+                    }
+
+                value_t result;
+                lockstepLoad(&result, roots);
+                lockstepStore(STACK_ROW(1), &result, &mask);
+                group.ip += 1;
+                break;
+            }
+
+            case OPCODE_cmp:
+            {
+                NEEDS_STACK(2);
+                STEP();
+
+                value_t first, second, equal, greater, lower;
+                lockstepLoad(&first,  STACK_ROW(1));
+                lockstepLoad(&second, STACK_ROW(2));
+                lockstepSplat<LANES>(&equal,    DOUBLES_ARE_EQUAL);
+                lockstepSplat<LANES>(&greater,  FIRST_DOUBLE_IS_GREATER);
+                lockstepSplat<LANES>(&lower,    FIRST_DOUBLE_IS_LOWER);
+
+                value_t difference = first - second;
+                value_t result = (difference < EPS && difference > -EPS) ? equal : (first > second ? greater : lower);
+
+                RESERVE_STACK();
+                lockstepStore(STACK_ROW(0), &result, &mask);
+                group.stackSize += 1;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_fcmp:
+            {
+                NEEDS_STACK(2);
+                STEP();
+
+                value_t first, second;
+                lockstepLoad(&second, STACK_ROW(1));
+                lockstepLoad(&first,  STACK_ROW(2));
+
+                integer_t equal, lower, greater, none = {};
+                lockstepSplat<LANES>(&equal,    (long long) EQUAL_FLAG);
+                lockstepSplat<LANES>(&lower,    (long long) LOWER_FLAG);
+                lockstepSplat<LANES>(&greater,  (long long) GREATER_FLAG);
+
+                value_t difference = first - second;
+                integer_t flags = (difference < EPS && difference > -EPS) ? equal : (first < second ? lower : (first > second ? greater : none));
+
+                lockstepStore(lockstep->flags, &flags, &mask);
+                group.stackSize -= 2;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_je:
+            case OPCODE_jl:
+            case OPCODE_jg:
+            case OPCODE_jne:
+            {
+                NEEDS_STACK(1);
+                value_t top;
+                lockstepLoad(&top, STACK_ROW(1));
+
+                double compareResult = DOUBLES_ARE_EQUAL;
+                switch (command->opcode)
+                {
+                    case OPCODE_jl:     compareResult = FIRST_DOUBLE_IS_LOWER;      break;
+                    case OPCODE_jg:     compareResult = FIRST_DOUBLE_IS_GREATER;    break;
+                    case OPCODE_je:
+                    case OPCODE_jne:
+                    default:                                                        break;
+                }
+
+                value_t difference = top - compareResult;
+                integer_t taken = command->opcode == OPCODE_jne ? (difference > EPS || difference < -EPS)
+                                                                : (difference < EPS && difference > -EPS);
+                int takenBits = lockstepBits<LANES>(&taken) & group.lanes;
+                NEEDS_TARGET(takenBits);
+                STEP();
+
+                // Taken jump pops the result of the comparison
+                lockstepBranch(lockstep, &group, takenBits, command->target, group.stackSize - 1, group.ip + 1);
+                break;
+            }
+
+            case OPCODE_fje:
+            case OPCODE_fjne:
+            case OPCODE_fjl:
+            case OPCODE_fjle:
+            case OPCODE_fjg:
+            case OPCODE_fjge:
+            case OPCODE_fjeof:
+            {
+                long long flagsMask = 0;
+                switch (command->opcode)
+                {
+                    case OPCODE_fje:
+                    case OPCODE_fjne:   flagsMask = EQUAL_FLAG;                         break;
+                    case OPCODE_fjl:    flagsMask = LOWER_FLAG;                         break;
+                    case OPCODE_fjle:   flagsMask = LOWER_FLAG | EQUAL_FLAG;            break;
+                    case OPCODE_fjg:    flagsMask = GREATER_FLAG;                       break;
+                    case OPCODE_fjge:   flagsMask = GREATER_FLAG | EQUAL_FLAG;          break;
+                    case OPCODE_fjeof:
+                    default:            flagsMask = END_OF_INPUT_FLAG | BAD_INPUT_FLAG; break;
+                }
+
+                integer_t flags;
+                lockstepLoad(&flags, lockstep->flags);
+                integer_t taken = command->opcode == OPCODE_fjne ? (flags & flagsMask) == 0 : (flags & flagsMask) != 0;
+                int takenBits = lockstepBits<LANES>(&taken) & group.lanes;
+                NEEDS_TARGET(takenBits);
+                STEP();
+
+                lockstepBranch(lockstep, &group, takenBits, command->target, group.stackSize, group.ip + 1);
+                break;
+            }
+
+            case OPCODE_jmp:
+            {
+                NEEDS_TARGET(group.lanes);
+                STEP();
+
+                group.ip = command->target;
+                break;
+            }
+
+            case OPCODE_call:
+            {
+                if (group.callDepth >= lockstep->maxCallDepth)
+                {
+                    HAND_OFF(group.lanes);
+                }
+                NEEDS_TARGET(group.lanes);
+                STEP();
+
+                IS_ERROR(lockstepReserveCallStack(lockstep, group.callDepth))
+                {
+                    return EXIT_CODES::BAD_STD_FUNC_RESULT;
+                }
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    if ((group.lanes >> lane & 1) != 0)
+                    {
+                        ROW(callStack, group.callDepth)[lane] = command->nextAddress;
+                    }
+                }
+
+                group.callDepth += 1;
+                group.ip        = command->target;
+                break;
+            }
+
+            case OPCODE_ret:
+            {
+                if (group.callDepth <= 0)
+                {
+                    HAND_OFF(group.lanes);
+                }
+                STEP();
+
+                // Lanes that met in the function may return to different places
+                group.callDepth -= 1;
+                int returnIps[LANES] = {};
+                int divergentBits = 0;
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    if ((group.lanes >> lane & 1) != 0)
+                    {
+                        returnIps[lane] = lockstep->program.commandIndex[ROW(callStack, group.callDepth)[lane]];
+                        divergentBits |= (returnIps[lane] != returnIps[__builtin_ctz((unsigned) group.lanes)]) << lane;
+                    }
+                }
+
+                if (divergentBits == 0)
+                {
+                    group.ip = returnIps[__builtin_ctz((unsigned) group.lanes)];
+                    break;
+                }
+
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    if ((group.lanes >> lane & 1) != 0)
+                    {
+                        lockstepPark(lockstep, 1 << lane, returnIps[lane], group.stackSize, group.callDepth, LOCKSTEP_LANE_STATES::RUNNING);
+                    }
+                }
+                group.lanes = 0;
+                group.size  = 0;
+                break;
+            }
+
+            case OPCODE_in:
+            {
+                STEP();
+                RESERVE_STACK();
+
+                double *row = STACK_ROW(0);
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    if ((group.lanes >> lane & 1) == 0)
+                    {
+                        continue;
+                    }
+
+                    INPUT_RESULTS result = INPUT_RESULTS::VALUE;
+                    IS_ERROR(inputDouble(&lanes[lane].input, &row[lane], &result))
+                    {
+                        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+                    }
+
+                    long long *flags = &lockstep->flags[lane];
+                    *flags &= ~(END_OF_INPUT_FLAG | BAD_INPUT_FLAG);
+                    switch (result)
+                    {
+                        case INPUT_RESULTS::END_OF_INPUT:   *flags |= END_OF_INPUT_FLAG;    break;
+                        case INPUT_RESULTS::BAD_VALUE:      *flags |= BAD_INPUT_FLAG;       break;
+                        case INPUT_RESULTS::VALUE:
+                        case INPUT_RESULTS::NOT_READY:
+                        default:                                                            break;
+                    }
+                }
+
+                group.stackSize += 1;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_out:
+            case OPCODE_outc:
+            {
+                NEEDS_STACK(1);
+                STEP();
+
+                const double *row = STACK_ROW(1);
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    if ((group.lanes >> lane & 1) == 0)
+                    {
+                        continue;
+                    }
+
+                    IS_ERROR((command->opcode == OPCODE_out ? outputDouble(&lanes[lane].output, row[lane])
+                                                            : outputChar(&lanes[lane].output, (char) (int) row[lane])))
+                    {
+                        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+                    }
+                }
+
+                group.stackSize -= 1;
+                group.ip        += 1;
+                break;
+            }
+
+            case OPCODE_imov:
+            case OPCODE_iadd:
+            case OPCODE_isub:
+            case OPCODE_imul:
+            case OPCODE_iand:
+            case OPCODE_ior:
+            case OPCODE_ixor:
+            case OPCODE_ishl:
+            case OPCODE_ishr:
+            case OPCODE_icmp:
+            {
+                if (command->intDestination == ZERO_INT_REGISTER)
+                {
+                    HAND_OFF(group.lanes);
+                }
+                STEP();
+
+                integer_t destination, source;
+                lockstepLoad(&destination, ROW(intRegs, command->intDestination));
+                lockstepLoad(&source,      ROW(intRegs, command->intRegs[0]));
+                source += command->intImmediate;
+
+                if (command->opcode == OPCODE_icmp)
+                {
+                    integer_t equal, lower, greater;
+                    lockstepSplat<LANES>(&equal,    (long long) EQUAL_FLAG);
+                    lockstepSplat<LANES>(&lower,    (long long) LOWER_FLAG);
+                    lockstepSplat<LANES>(&greater,  (long long) GREATER_FLAG);
+
+                    integer_t flags = destination == source ? equal : (destination < source ? lower : greater);
+                    lockstepStore(lockstep->flags, &flags, &mask);
+                    group.ip += 1;
+                    break;
+                }
+
+                integer_t result;
+                switch (command->opcode)
+                {
+                    case OPCODE_iadd:   result = (integer_t) ((unsigned_t) destination + (unsigned_t) source);          break;
+                    case OPCODE_isub:   result = (integer_t) ((unsigned_t) destination - (unsigned_t) source);          break;
+                    case OPCODE_imul:   result = (integer_t) ((unsigned_t) destination * (unsigned_t) source);          break;
+                    case OPCODE_iand:   result = destination & source;                                                  break;
+                    case OPCODE_ior:    result = destination | source;                                                  break;
+                    case OPCODE_ixor:   result = destination ^ source;                                                  break;
+                    case OPCODE_ishl:   result = (integer_t) ((unsigned_t) destination << (unsigned_t) (source & 63));  break;
+                    case OPCODE_ishr:   result = destination >> (source & 63);                                          break;
+                    case OPCODE_imov:
+                    default:            result = source;                                                                break;
+                }
+
+                lockstepStore(ROW(intRegs, command->intDestination), &result, &mask);
+                group.ip += 1;
+                break;
+            }
+
+            case OPCODE_idiv:
+            case OPCODE_imod:
+            {
+                if (command->intDestination == ZERO_INT_REGISTER)
+                {
+                    HAND_OFF(group.lanes);
+                }
+
+                // Division is done lane by lane (there is no vector one), division by zero is reported by the scalar engine
+                long long *destination  = ROW(intRegs, command->intDestination);
+                const long long *source = ROW(intRegs, command->intRegs[0]);
+                int zeroBits = 0;
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    zeroBits |= (source[lane] + command->intImmediate == 0) << lane;
+                }
+                if ((zeroBits & group.lanes) != 0)
+                {
+                    HAND_OFF(zeroBits & group.lanes);
+                }
+                STEP();
+
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    if ((group.lanes >> lane & 1) == 0)
+                    {
+                        continue;
+                    }
+
+                    long long divisor = source[lane] + command->intImmediate;
+                    if (command->opcode == OPCODE_idiv)
+                    {
+                        destination[lane] = divisor == -1 ? WRAPPED(0, -, destination[lane]) : destination[lane] / divisor;
+                    }
+                    else
+                    {
+                        destination[lane] = divisor == -1 ? 0 : destination[lane] % divisor;
+                    }
+                }
+
+                group.ip += 1;
+                break;
+            }
+
+            case OPCODE_halt:
+            {
+                STEP();
+                lockstepFinishGroup(lockstep, &group);
+                break;
+            }
+
+            // The end of the program, invalid commands and the commands without the lockstep version are left to the scalar engine
+            default:
+            {
+                HAND_OFF(group.lanes);
+            }
+        }
+    }
+
+    #undef RESERVE_STACK
+    #undef NEEDS_TARGET
+    #undef NEEDS_STACK
+    #undef STEP
+    #undef HAND_OFF
+    #undef STACK_ROW
+    #undef ROW
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Functions that instantiate the lockstep engine for every amount of lanes (the vectors are AVX2 registers in the "avx2" ones)
+ * 
+ * @param lockstep 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES lockstepRun4(lockstep_t *lockstep)    { return lockstepRun<4, false>(lockstep); }
+static EXIT_CODES lockstepRun8(lockstep_t *lockstep)    { return lockstepRun<8, false>(lockstep); }
+
+#if LOCKSTEP_AVX2_SUPPORTED
+    __attribute__((target("avx2"))) static EXIT_CODES lockstepRun4Avx2(lockstep_t *lockstep)  { return lockstepRun<4, true>(lockstep); }
+    __attribute__((target("avx2"))) static EXIT_CODES lockstepRun8Avx2(lockstep_t *lockstep)  { return lockstepRun<8, true>(lockstep); }
+#endif
+
+/**
+ * @brief Function that decodes the bytecode and allocates the lanes (settings are taken from `CPU`)
+ * 
+ * @param lockstep 
+ * @param byteCode 
+ * @param CPU 
+ * @param lanesCount 4 or 8
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepCtor(lockstep_t *lockstep, text_t *byteCode, const cpu_t *CPU, int lanesCount)
+{
+    // Error check
+    if (lockstep == NULL || byteCode == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (lanesCount != 4 && lanesCount != 8)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::BAD_LANES_COUNT);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    if (CPU->RAMSize > LOCKSTEP_MAX_RAM_SIZE)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::RAM_IS_TOO_LARGE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Commands are not fused, every lane executes them one by one
+    IS_ERROR(decodedProgramCtor(&lockstep->program, byteCode))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DECODING_BYTECODE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    lockstep->lanesCount    = lanesCount;
+    lockstep->maxCallDepth  = CPU->maxCallDepth;
+    lockstep->RAMSize       = CPU->RAMSize;
+    #if LOCKSTEP_AVX2_SUPPORTED
+        lockstep->avx2 = __builtin_cpu_supports("avx2");
+    #endif
+
+    // Rows
+    size_t lanes = (size_t) lanesCount;
+    lockstep->commonRegs    = (double *)    calloc((MAX_REGS_COUNT + 1) * lanes, sizeof(double));
+    lockstep->intRegs       = (long long *) calloc((MAX_INT_REGS_COUNT + 1) * lanes, sizeof(long long));
+    lockstep->flags         = (long long *) calloc(lanes, sizeof(long long));
+    lockstep->stack         = (double *)    calloc((size_t) LOCKSTEP_STACK_ROWS * lanes, sizeof(double));
+    lockstep->RAM           = (double *)    calloc(lockstep->RAMSize * lanes + 1, sizeof(double));
+    lockstep->stackCapacity = LOCKSTEP_STACK_ROWS;
+    if (lockstep->commonRegs == NULL || lockstep->intRegs == NULL || lockstep->flags == NULL || lockstep->stack == NULL || lockstep->RAM == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::ERROR_ALLOCATING_LANES);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    for (int lane = 0; lane < lanesCount; ++lane)
+    {
+        IS_ERROR(outputCtor(&lockstep->lanes[lane].output, NULL, OUTPUT_BUFFER_SIZE, CPU->outputFormat))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::ERROR_ALLOCATING_LANES);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+        lockstep->lanes[lane].input.format = CPU->inputFormat;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that frees all the memory of the lanes and the decoded program
+ * 
+ * @param lockstep 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepDtor(lockstep_t *lockstep)
+{
+    // Error check
+    if (lockstep == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+    {
+        if (lockstep->lanes[lane].output.buffer != NULL)
+        {
+            IS_OK_WO_EXIT(outputDtor(&lockstep->lanes[lane].output));
+        }
+    }
+
+    free(lockstep->commonRegs);
+    free(lockstep->intRegs);
+    free(lockstep->flags);
+    free(lockstep->stack);
+    free(lockstep->callStack);
+    free(lockstep->RAM);
+    IS_OK_WO_EXIT(decodedProgramDtor(&lockstep->program));
+
+    lockstep->commonRegs        = NULL;
+    lockstep->intRegs           = NULL;
+    lockstep->flags             = NULL;
+    lockstep->stack             = NULL;
+    lockstep->callStack         = NULL;
+    lockstep->RAM               = NULL;
+    lockstep->stackCapacity     = 0;
+    lockstep->callStackCapacity = 0;
+    lockstep->lanesCount        = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that runs the group of records (one per lane) in lockstep until every lane is done or handed off
+ * 
+ * Lanes start as new virtual CPUs: registers, flags and RAM of all of them are cleared
+ * 
+ * @param lockstep 
+ * @param records 
+ * @param recordsCount at most `lanesCount`
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepExecuteGroup(lockstep_t *lockstep, const text_line_t *records, int recordsCount)
+{
+    // Error check
+    if (lockstep == NULL || records == NULL || lockstep->program.commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (recordsCount <= 0 || recordsCount > lockstep->lanesCount)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::BAD_LANES_COUNT);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // New virtual CPUs
+    size_t lanes = (size_t) lockstep->lanesCount;
+    memset(lockstep->commonRegs, 0, (MAX_REGS_COUNT + 1) * lanes * sizeof(double));
+    memset(lockstep->intRegs, 0, (MAX_INT_REGS_COUNT + 1) * lanes * sizeof(long long));
+    memset(lockstep->flags, 0, lanes * sizeof(long long));
+    memset(lockstep->RAM, 0, lockstep->RAMSize * lanes * sizeof(double));
+
+    for (int lane = 0; lane < lockstep->lanesCount; ++lane)
+    {
+        lockstep_lane_t *state = &lockstep->lanes[lane];
+        state->state        = lane < recordsCount ? LOCKSTEP_LANE_STATES::RUNNING : LOCKSTEP_LANE_STATES::EMPTY;
+        state->ip           = lockstep->program.commandIndex[0];
+        state->stackSize    = 0;
+        state->callDepth    = 0;
+        if (lane < recordsCount)
+        {
+            IS_OK_WO_EXIT(inputRecord(&state->input, records[lane].beginning, records[lane].length));
+        }
+    }
+    lockstep->stats.groupsCount += 1;
+
+    // Execution
+    #if LOCKSTEP_AVX2_SUPPORTED
+        if (lockstep->avx2)
+        {
+            return lockstep->lanesCount == 4 ? lockstepRun4Avx2(lockstep) : lockstepRun8Avx2(lockstep);
+        }
+    #endif
+
+    return lockstep->lanesCount == 4 ? lockstepRun4(lockstep) : lockstepRun8(lockstep);
+}
+
+/**
+ * @brief Function that moves the state of the handed off lane into the reset `CPU`, `cpuExecuteBytecode` continues the run from it
+ * 
+ * The text the lane has printed is written to the output of `CPU` first
+ * 
+ * @param lockstep 
+ * @param lane 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES lockstepHandOff(lockstep_t *lockstep, int lane, cpu_t *CPU)
+{
+    // Error check
+    if (lockstep == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (lane < 0 || lane >= lockstep->lanesCount || lockstep->lanes[lane].state != LOCKSTEP_LANE_STATES::HANDED_OFF)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::ERROR_HANDING_OFF_LANE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    lockstep_lane_t *state = &lockstep->lanes[lane];
+    size_t lanes = (size_t) lockstep->lanesCount;
+
+    // Output and input
+    char *text = NULL;
+    size_t length = 0;
+    IS_ERROR(outputTake(&state->output, &text, &length))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(LOCKSTEP_EXIT_CODES::ERROR_HANDING_OFF_LANE);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    EXIT_CODES exitCode = outputText(&CPU->output, text, length);
+    free(text);
+    IS_ERROR(exitCode)
+    {
+        return exitCode;
+    }
+
+    IS_OK_WO_EXIT(inputRecord(&CPU->input, state->input.data, state->input.size));
+    CPU->input.position = state->input.position;
+
+    // Stack
+    for (int row = 0; row < state->stackSize; ++row)
+    {
+        double value = lockstep->stack[(size_t) row * lanes + (size_t) lane];
+        if ((CPU->paranoid ? stackPush(&CPU->paranoidStack, value) : stackPush(&CPU->stack, value)) != EXIT_CODES::NO_ERRORS)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+
+    // Registers
+    for (int reg = 0; reg < MAX_REGS_COUNT; ++reg)
+    {
+        CPU->commonRegs[reg] = lockstep->commonRegs[(size_t) reg * lanes + (size_t) lane];
+    }
+    for (int reg = 0; reg < MAX_INT_REGS_COUNT; ++reg)
+    {
+        CPU->intRegs[reg] = lockstep->intRegs[(size_t) reg * lanes + (size_t) lane];
+    }
+    CPU->flags = (int) lockstep->flags[lane];
+
+    // RAM (cells that are still zero are not touched, the paged RAM does not allocate their pages)
+    for (size_t cell = 0; cell < lockstep->RAMSize; ++cell)
+    {
+        double value = lockstep->RAM[cell * lanes + (size_t) lane];
+        unsigned long long bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        if (bits != 0)
+        {
+            *ramCell(&CPU->memory, cell) = value;
+        }
+    }
+
+    // Call stack and the next command
+    for (int depth = 0; depth < state->callDepth; ++depth)
+    {
+        CPU->callStack[depth] = lockstep->callStack[(size_t) depth * lanes + (size_t) lane];
+    }
+    CPU->callDepth  = state->callDepth;
+    CPU->ip         = (int) lockstep->program.commands[state->ip].address;
+
+    return EXIT_CODES::NO_ERRORS;
+}
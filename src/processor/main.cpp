@@ -1,9 +1,17 @@
 // TODO: #2 Add Video memory && GPU commands @V13kv
-// TODO: #3 Add flags in order to easily determine state of machine after `cmp` command @V13kv
+#include <string.h>  // for strcmp
+#include <stdlib.h>  // for strtol, strtoull
+#include <limits.h>  // for INT_MAX
+
 #include "libs/text/include/text.h"
 #include "libs/colors/colors.h"
 
 #include "include/processor/processor.h"
+#include "include/processor/batch.h"
+#include "include/processor/smp.h"
+#include "include/processor/pipeline.h"
+#include "include/processor/green.h"
+#include "include/processor/verifier.h"
 
 #define CLEAN_UP(textObj, cpuObj)   \
     textDtor(textObj);              \
@@ -14,22 +22,139 @@
     exit(exitCode);
 
 void hint();
-char *getFileName(int argc, char **argv);
+char *parseArguments(int argc, char **argv, cpu_t *CPU, char **recordsFileName, int *threadsCount, int *lanesCount, int *coresCount,
+                     char **pipeFileNames, int *pipeFilesCount, int *greenThreadsCount, unsigned long long *quantum);
 
 int main(int argc, char **argv)
 {
+    // Parse command line options
+    cpu_t CPU = {};
+    char *recordsFileName = NULL;
+    int threadsCount = 1;
+    int lanesCount = 1;
+    int coresCount = 1;
+    char *pipeFileNames[MAX_PIPELINE_STAGES] = {};
+    int pipeFilesCount = 0;
+    int greenThreadsCount = 0;
+    unsigned long long quantum = 0;
+    char *fileName = parseArguments(argc, argv, &CPU, &recordsFileName, &threadsCount, &lanesCount, &coresCount,
+                                    pipeFileNames, &pipeFilesCount, &greenThreadsCount, &quantum);
+    if (fileName == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
     // Read bytecode
     text_t byteCode = {};
-    textCtor(&byteCode, getFileName(argc, argv), FILE_MODE::RB);
+    textCtor(&byteCode, fileName, FILE_MODE::RB);
+
+    // Verify bytecode (once, before the execution)
+    if (CPU.verify)
+    {
+        int violationsCount = 0;
+        IS_ERROR(verifyBytecode(&byteCode, CPU.RAMSize, &violationsCount))
+        {
+            textDtor(&byteCode);
+            EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::ERROR_VERIFYING_BYTECODE);
+        }
+
+        if (violationsCount != 0)
+        {
+            textDtor(&byteCode);
+            EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::BYTECODE_IS_NOT_VERIFIED);
+        }
+
+        CPU.verified = true;
+    }
 
     // Processor initialization
-    cpu_t CPU = {};
     IS_ERROR(cpuCtor(&CPU))
     {
         CLEAN_UP(&byteCode, &CPU);
         EXIT(EXIT_FAILURE, EXIT_CODES::CONSTRUCTOR_ERROR);
     }
 
+    // Execute bytecode once per record (the program is loaded and decoded once)
+    if (recordsFileName != NULL)
+    {
+        text_t records = {};
+        textCtor(&records, recordsFileName, FILE_MODE::R);
+
+        int failedRunsCount = 0;
+        IS_ERROR(cpuExecuteBatch(&byteCode, &CPU, &records, threadsCount, lanesCount, &failedRunsCount))
+        {
+            textDtor(&records);
+            CLEAN_UP(&byteCode, &CPU);
+            EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+        }
+        textDtor(&records);
+
+        if (CPU.stats.enabled)
+        {
+            cpuPrintStats(&CPU);
+        }
+
+        CLEAN_UP(&byteCode, &CPU);
+        return failedRunsCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Execute bytecode on the virtual cores that share the RAM
+    if (coresCount != 1)
+    {
+        int exitCode = EXIT_SUCCESS;
+        IS_ERROR(cpuExecuteSmp(&byteCode, &CPU, coresCount, &exitCode))
+        {
+            CLEAN_UP(&byteCode, &CPU);
+            EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+        }
+
+        if (CPU.stats.enabled)
+        {
+            cpuPrintStats(&CPU);
+        }
+
+        CLEAN_UP(&byteCode, &CPU);
+        return exitCode;
+    }
+
+    // Execute the programs connected by the rings (`out` of every one is `in` of the next one)
+    if (pipeFilesCount != 0)
+    {
+        int exitCode = EXIT_SUCCESS;
+        IS_ERROR(cpuExecutePipeline(&byteCode, &CPU, fileName, pipeFileNames, pipeFilesCount, &exitCode))
+        {
+            CLEAN_UP(&byteCode, &CPU);
+            EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+        }
+
+        if (CPU.stats.enabled)
+        {
+            cpuPrintStats(&CPU);
+        }
+
+        CLEAN_UP(&byteCode, &CPU);
+        return exitCode;
+    }
+
+    // Execute the instances of the program by slices on this thread (stdin lines go to the instances by their indices)
+    if (greenThreadsCount != 0)
+    {
+        int exitCode = EXIT_SUCCESS;
+        IS_ERROR(cpuExecuteGreen(&byteCode, &CPU, greenThreadsCount, quantum, &exitCode))
+        {
+            CLEAN_UP(&byteCode, &CPU);
+            EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
+        }
+
+        if (CPU.stats.enabled)
+        {
+            cpuPrintStats(&CPU);
+        }
+
+        CLEAN_UP(&byteCode, &CPU);
+        return exitCode;
+    }
+
     // Execute bytecode
     IS_ERROR(cpuExecuteBytecode(&byteCode, &CPU))
     {
@@ -37,31 +162,339 @@ int main(int argc, char **argv)
         EXIT(EXIT_FAILURE, PROCESSOR_EXIT_CODES::BYTES_EXECUTION_FAILURE);
     }
 
+    // Status of the run is the exit code of the process (the paused run has nothing left to resume it with)
+    switch (CPU.status.state)
+    {
+        case CPU_STATES::TRAPPED:
+            fprintf(stderr, RED "[TRAP]" RESET " runtime error %d at ip %d\n", (int) CPU.status.trap, CPU.status.ip);
+            break;
+
+        case CPU_STATES::BUDGET_IS_EXHAUSTED:
+            fprintf(stderr, YELLOW "[BUDGET]" RESET " exhausted at ip %d after %llu commands\n", CPU.status.ip,
+                    CPU.budget - CPU.budgetLeft);
+            break;
+
+        case CPU_STATES::HALTED:
+        case CPU_STATES::WAITING_FOR_INPUT:
+        default:
+            break;
+    }
+    int exitCode = cpuGetExitCode(&CPU);
+
     // Free allocated space
+    if (CPU.stats.enabled)
+    {
+        cpuPrintStats(&CPU);
+    }
+
     textDtor(&byteCode);
     IS_ERROR(cpuDtor(&CPU))
     {
-        CLEAN_UP(&byteCode, &CPU);
+        // The text is already freed and the CPU can not be destroyed again
         EXIT(EXIT_FAILURE, EXIT_CODES::DESTRUCTOR_ERROR);
     }
 
-    return 0;
+    return exitCode;
 }
 
 void hint()
 {
     printf(RED "Incorrect inline argument input!\n" RESET);
-    printf("prog.exe <file_name>\n");
+    printf("proc.exe [--engine switch|threaded|jit|trace] [--no-fusion] [--no-tos-cache] [--paranoid] [--no-verify] [--max-call-depth N] [--budget N] [--memory flat|paged] [--ram SIZE[K|M|G]] [--huge-pages] [--input text|binary] [--output lf|shortest] [--batch FILE [--threads N | --lanes 4|8] | --cores N | --pipe FILE... | --green N [--quantum N]] [--stats] <file_name>\n");
 }
 
-char *getFileName(int argc, char *argv[])
+char *parseArguments(int argc, char *argv[], cpu_t *CPU, char **recordsFileName, int *threadsCount, int *lanesCount, int *coresCount,
+                     char **pipeFileNames, int *pipeFilesCount, int *greenThreadsCount, unsigned long long *quantum)
 {
     char *file_name = NULL;
-    if (argc == 2)
+    bool isRAMSizeSet = false;
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp(argv[arg], "--engine") && arg + 1 < argc)
+        {
+            ++arg;
+            if (!strcmp(argv[arg], "switch"))
+            {
+                CPU->engine = CPU_ENGINES::SWITCH;
+            }
+            else if (!strcmp(argv[arg], "threaded"))
+            {
+                CPU->engine = CPU_ENGINES::THREADED;
+            }
+            else if (!strcmp(argv[arg], "jit"))
+            {
+                CPU->engine = CPU_ENGINES::JIT;
+            }
+            else if (!strcmp(argv[arg], "trace"))
+            {
+                CPU->engine = CPU_ENGINES::TRACING;
+            }
+            else
+            {
+                hint();
+                return NULL;
+            }
+        }
+        else if (!strcmp(argv[arg], "--stats"))
+        {
+            CPU->stats.enabled = true;
+        }
+        else if (!strcmp(argv[arg], "--no-fusion"))
+        {
+            CPU->fusion = false;
+        }
+        else if (!strcmp(argv[arg], "--no-tos-cache"))
+        {
+            CPU->tosCaching = false;
+        }
+        else if (!strcmp(argv[arg], "--paranoid"))
+        {
+            CPU->paranoid = true;
+        }
+        else if (!strcmp(argv[arg], "--no-verify"))
+        {
+            CPU->verify = false;
+        }
+        else if (!strcmp(argv[arg], "--max-call-depth") && arg + 1 < argc)
+        {
+            ++arg;
+            char *end = NULL;
+            long depth = strtol(argv[arg], &end, 10);
+            if (*end != '\0' || depth <= 0 || depth > INT_MAX)
+            {
+                hint();
+                return NULL;
+            }
+            CPU->maxCallDepth = (int) depth;
+        }
+        else if (!strcmp(argv[arg], "--budget") && arg + 1 < argc)
+        {
+            ++arg;
+            char *end = NULL;
+            unsigned long long commands = strtoull(argv[arg], &end, 10);
+            if (*end != '\0' || argv[arg][0] == '-' || commands == 0)
+            {
+                hint();
+                return NULL;
+            }
+            CPU->budget = commands;
+        }
+        else if (!strcmp(argv[arg], "--ram") && arg + 1 < argc)
+        {
+            ++arg;
+            IS_ERROR(ramParseSize(argv[arg], &CPU->RAMSize))
+            {
+                hint();
+                return NULL;
+            }
+            isRAMSizeSet = true;
+        }
+        else if (!strcmp(argv[arg], "--memory") && arg + 1 < argc)
+        {
+            ++arg;
+            if (!strcmp(argv[arg], "flat"))
+            {
+                CPU->RAMBackend = RAM_BACKENDS::FLAT;
+            }
+            else if (!strcmp(argv[arg], "paged"))
+            {
+                CPU->RAMBackend = RAM_BACKENDS::PAGED;
+            }
+            else
+            {
+                hint();
+                return NULL;
+            }
+        }
+        else if (!strcmp(argv[arg], "--huge-pages"))
+        {
+            CPU->hugePages = true;
+        }
+        else if (!strcmp(argv[arg], "--input") && arg + 1 < argc)
+        {
+            ++arg;
+            if (!strcmp(argv[arg], "text"))
+            {
+                CPU->inputFormat = INPUT_FORMATS::TEXT;
+            }
+            else if (!strcmp(argv[arg], "binary"))
+            {
+                CPU->inputFormat = INPUT_FORMATS::BINARY;
+            }
+            else
+            {
+                hint();
+                return NULL;
+            }
+        }
+        else if (!strcmp(argv[arg], "--output") && arg + 1 < argc)
+        {
+            ++arg;
+            if (!strcmp(argv[arg], "lf"))
+            {
+                CPU->outputFormat = OUTPUT_FORMATS::LF;
+            }
+            else if (!strcmp(argv[arg], "shortest"))
+            {
+                CPU->outputFormat = OUTPUT_FORMATS::SHORTEST;
+            }
+            else
+            {
+                hint();
+                return NULL;
+            }
+        }
+        else if (!strcmp(argv[arg], "--batch") && arg + 1 < argc)
+        {
+            ++arg;
+            *recordsFileName = argv[arg];
+        }
+        else if (!strcmp(argv[arg], "--threads") && arg + 1 < argc)
+        {
+            ++arg;
+            char *end = NULL;
+            long threads = strtol(argv[arg], &end, 10);
+            if (*end != '\0' || threads <= 0 || threads > MAX_BATCH_THREADS)
+            {
+                hint();
+                return NULL;
+            }
+            *threadsCount = (int) threads;
+        }
+        else if (!strcmp(argv[arg], "--lanes") && arg + 1 < argc)
+        {
+            ++arg;
+            if (!strcmp(argv[arg], "4") || !strcmp(argv[arg], "8"))
+            {
+                *lanesCount = argv[arg][0] - '0';
+            }
+            else
+            {
+                hint();
+                return NULL;
+            }
+        }
+        else if (!strcmp(argv[arg], "--cores") && arg + 1 < argc)
+        {
+            ++arg;
+            char *end = NULL;
+            long cores = strtol(argv[arg], &end, 10);
+            if (*end != '\0' || cores <= 0 || cores > MAX_SMP_CORES)
+            {
+                hint();
+                return NULL;
+            }
+            *coresCount = (int) cores;
+        }
+        else if (!strcmp(argv[arg], "--pipe") && arg + 1 < argc)
+        {
+            ++arg;
+            if (*pipeFilesCount >= MAX_PIPELINE_STAGES - 1)
+            {
+                hint();
+                return NULL;
+            }
+            pipeFileNames[(*pipeFilesCount)++] = argv[arg];
+        }
+        else if (!strcmp(argv[arg], "--green") && arg + 1 < argc)
+        {
+            ++arg;
+            char *end = NULL;
+            long threads = strtol(argv[arg], &end, 10);
+            if (*end != '\0' || threads <= 0 || threads > MAX_GREEN_THREADS)
+            {
+                hint();
+                return NULL;
+            }
+            *greenThreadsCount = (int) threads;
+        }
+        else if (!strcmp(argv[arg], "--quantum") && arg + 1 < argc)
+        {
+            ++arg;
+            char *end = NULL;
+            unsigned long long commands = strtoull(argv[arg], &end, 10);
+            if (*end != '\0' || argv[arg][0] == '-' || commands == 0)
+            {
+                hint();
+                return NULL;
+            }
+            *quantum = commands;
+        }
+        else if (file_name == NULL && argv[arg][0] != '-')
+        {
+            file_name = argv[arg];
+        }
+        else
+        {
+            hint();
+            return NULL;
+        }
+    }
+
+    // Paged RAM costs only the touched pages, so it is the whole address space by default
+    if (CPU->RAMBackend == RAM_BACKENDS::PAGED)
     {
-        file_name = argv[1];
+        if (!isRAMSizeSet)
+        {
+            CPU->RAMSize = PAGED_RAM_SIZE;
+        }
+        else if (CPU->RAMSize > PAGED_RAM_SIZE)
+        {
+            hint();
+            return NULL;
+        }
     }
-    else
+
+    // Records of the batch are lines of text
+    if ((*recordsFileName != NULL && CPU->inputFormat == INPUT_FORMATS::BINARY) || (*recordsFileName == NULL && *threadsCount != 1))
+    {
+        hint();
+        return NULL;
+    }
+
+    // Lanes run on one thread, every one of them has its own copy of the RAM
+    if (*lanesCount != 1 && (*recordsFileName == NULL || *threadsCount != 1 || CPU->RAMSize > LOCKSTEP_MAX_RAM_SIZE))
+    {
+        hint();
+        return NULL;
+    }
+
+    // Cores share one RAM (pages of the paged one are allocated by the core that touches them first)
+    if (*coresCount != 1 && (*recordsFileName != NULL || CPU->RAMBackend != RAM_BACKENDS::FLAT))
+    {
+        hint();
+        return NULL;
+    }
+
+    // Stages of the pipeline run once each
+    if (*pipeFilesCount != 0 && (*recordsFileName != NULL || *coresCount != 1))
+    {
+        hint();
+        return NULL;
+    }
+
+    // Green threads are resumed from `ip` (`switch` engine) and their input is appended by lines of text
+    if (*greenThreadsCount == 0 ? *quantum != 0
+                                : (*recordsFileName != NULL || *coresCount != 1 || *pipeFilesCount != 0 ||
+                                   CPU->engine != CPU_ENGINES::SWITCH || CPU->inputFormat != INPUT_FORMATS::TEXT))
+    {
+        hint();
+        return NULL;
+    }
+    if (*quantum == 0)
+    {
+        *quantum = GREEN_QUANTUM;
+    }
+
+    // Metered runs are interpreted (the native code and the lanes are not charged), every run of the batch has its own budget
+    if (CPU->budget != 0 && ((CPU->engine != CPU_ENGINES::SWITCH && CPU->engine != CPU_ENGINES::THREADED) || *lanesCount != 1 ||
+                             *coresCount != 1 || *pipeFilesCount != 0 || *greenThreadsCount != 0))
+    {
+        hint();
+        return NULL;
+    }
+
+    if (file_name == NULL)
     {
         hint();
     }
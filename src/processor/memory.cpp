@@ -0,0 +1,502 @@
+#include <stdlib.h>  // for calloc, strtoull
+#include <string.h>  // for memset
+#include <stdint.h>  // for uintptr_t
+
+#include "include/processor/memory.h"
+#include "include/processor/settings.h"
+
+#if RAM_GUARD_SUPPORTED
+
+#include <signal.h>     // for sigaction
+#include <pthread.h>    // for pthread_mutex_t
+#include <ucontext.h>   // for ucontext_t
+#include <sys/mman.h>   // for mmap, madvise, munmap
+#include <unistd.h>     // for sysconf
+
+// Faults are delivered to the thread that caused them, so every thread traps the faults of its own RAM
+static thread_local ram_fault_resolver_t trapResolver = NULL;  // Native code to continue with after the fault inside of the RAM reservation
+static thread_local void *trapContext       = NULL;
+static thread_local uintptr_t trapBegin     = 0;        // Reservation of the RAM (the cells are not accessed out of bounds)
+static thread_local uintptr_t trapEnd       = 0;
+static pthread_mutex_t trapLock             = PTHREAD_MUTEX_INITIALIZER;
+static int trapsCount                       = 0;        // Threads with the trap (the handler is set by the first one)
+static struct sigaction oldSegvAction       = {};
+static struct sigaction oldBusAction        = {};
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Handler of SIGSEGV and SIGBUS: known instructions that fault inside of the RAM reservation continue with the code
+ * given by the resolver, other faults crash as before (the old handler is restored and the instruction faults again)
+ * 
+ * @param signal 
+ * @param info 
+ * @param context 
+ */
+static void ramTrapHandler(int signal, siginfo_t *info, void *context)
+{
+    ucontext_t *userContext = (ucontext_t *) context;
+    uintptr_t address = (uintptr_t) info->si_addr;
+    if (trapResolver != NULL && address >= trapBegin && address < trapEnd)
+    {
+        const void *resume = trapResolver((const void *) userContext->uc_mcontext.gregs[REG_RIP], trapContext);
+        if (resume != NULL)
+        {
+            userContext->uc_mcontext.gregs[REG_RIP] = (greg_t) resume;
+            return;
+        }
+    }
+
+    sigaction(signal, signal == SIGSEGV ? &oldSegvAction : &oldBusAction, NULL);
+}
+
+/**
+ * @brief Function that maps zeroed RAM of `size` cells (pages are allocated on the first touch)
+ * 
+ * The cells end right before the guard region of `RAM_GUARD_SIZE` bytes (`PROT_NONE`, only address space is reserved),
+ * there is one more guard page (or huge page) before the cells
+ * 
+ * @param ram 
+ * @param size amount of cells
+ * @param hugePages back the cells with huge pages if possible
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramCtor(ram_t *ram, size_t size, bool hugePages)
+{
+    // Error check
+    if (ram == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (size == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Reservation: guard | cells (aligned to the end) | guard
+    size_t pageSize     = hugePages ? HUGE_PAGE_SIZE : (size_t) sysconf(_SC_PAGESIZE);
+    size_t cellsSize    = alignUp(size * sizeof(double), pageSize);
+    size_t guardSize    = size <= (size_t) INT32_MAX ? RAM_GUARD_SIZE : pageSize;
+    size_t mappingSize  = pageSize + pageSize + cellsSize + guardSize;  // One more page to align the cells
+
+    void *mapping = mmap(NULL, mappingSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(MEMORY_EXIT_CODES::ERROR_RESERVING_RAM);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    char *cellsBegin = (char *) alignUp((size_t) mapping + pageSize, pageSize);
+    char *cellsEnd   = cellsBegin + cellsSize;
+
+    // Cells (explicit huge pages are tried first, transparent ones are the fallback)
+    bool isMapped = false;
+    if (hugePages)
+    {
+        isMapped = mmap(cellsBegin, cellsSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB,
+                        -1, 0) != MAP_FAILED;
+    }
+    if (!isMapped)
+    {
+        // Failed MAP_FIXED may have unmapped the range already, so it is mapped again instead of `mprotect`
+        if (mmap(cellsBegin, cellsSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE,
+                 -1, 0) == MAP_FAILED)
+        {
+            munmap(mapping, mappingSize);
+            PRINT_ERROR_TRACING_MESSAGE(MEMORY_EXIT_CODES::ERROR_MAPPING_RAM);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+
+        if (hugePages)
+        {
+            isMapped = madvise(cellsBegin, cellsSize, MADV_HUGEPAGE) == 0;
+        }
+    }
+
+    ram->mapping        = mapping;
+    ram->mappingSize    = mappingSize;
+    ram->cells          = (double *) (cellsEnd - size * sizeof(double));
+    ram->size           = size;
+    ram->guarded        = guardSize == RAM_GUARD_SIZE;
+    ram->hugePages      = hugePages && isMapped;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that makes the faults of the calling thread inside of the RAM reservation continue with the code given by `resolver` (other faults crash as before)
+ * 
+ * @param ram 
+ * @param resolver 
+ * @param context user data for the resolver
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramTrapCtor(const ram_t *ram, ram_fault_resolver_t resolver, void *context)
+{
+    // Error check
+    if (ram == NULL || resolver == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    if (trapResolver != NULL)
+    {
+        IS_OK_WO_EXIT(ramTrapDtor());
+    }
+
+    // Handler of the process
+    pthread_mutex_lock(&trapLock);
+    if (trapsCount == 0)
+    {
+        struct sigaction action = {};
+        action.sa_sigaction = ramTrapHandler;
+        action.sa_flags     = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGSEGV, &action, &oldSegvAction) != 0 || sigaction(SIGBUS, &action, &oldBusAction) != 0)
+        {
+            pthread_mutex_unlock(&trapLock);
+            PRINT_ERROR_TRACING_MESSAGE(MEMORY_EXIT_CODES::ERROR_SETTING_TRAP_HANDLER);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+    ++trapsCount;
+    pthread_mutex_unlock(&trapLock);
+
+    // Trap of the thread
+    trapResolver    = resolver;
+    trapContext     = context;
+    trapBegin   = (uintptr_t) ram->mapping;
+    trapEnd     = (uintptr_t) ram->mapping + ram->mappingSize;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that removes the trap of the calling thread (the previous handlers of the faults are restored by the last one)
+ * 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramTrapDtor()
+{
+    if (trapResolver != NULL)
+    {
+        pthread_mutex_lock(&trapLock);
+        if (--trapsCount == 0)
+        {
+            sigaction(SIGSEGV, &oldSegvAction, NULL);
+            sigaction(SIGBUS, &oldBusAction, NULL);
+        }
+        pthread_mutex_unlock(&trapLock);
+    }
+    trapResolver    = NULL;
+    trapContext     = NULL;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+#else
+
+/**
+ * @brief Function that allocates zeroed RAM of `size` cells (no guard regions on this host)
+ * 
+ * @param ram 
+ * @param size amount of cells
+ * @param hugePages ignored
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramCtor(ram_t *ram, size_t size, bool hugePages)
+{
+    // Error check
+    if (ram == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (size == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    (void) hugePages;
+
+    return ramHeapCtor(ram, size);
+}
+
+#endif
+
+/**
+ * @brief Function that allocates zeroed RAM of `size` cells on the heap (no guard regions, the bounds are checked)
+ * 
+ * The reservation of `ramCtor` has the guard region of 32 GB and three mappings, so thousands of them do not fit into the address space
+ * 
+ * @param ram 
+ * @param size amount of cells
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramHeapCtor(ram_t *ram, size_t size)
+{
+    // Error check
+    if (ram == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (size == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    ram->cells = (double *) calloc(size, sizeof(double));
+    CHECK_CALLOC_RESULT(ram->cells);
+    ram->size = size;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that constructs the paged RAM of `size` cells (the page table and the TLB are empty)
+ * 
+ * @param ram 
+ * @param size amount of cells (up to PAGED_RAM_SIZE)
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramPagedCtor(ram_t *ram, size_t size)
+{
+    // Error check
+    if (ram == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (size == 0 || size > PAGED_RAM_SIZE)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    ram->directory = (void **) calloc((size_t) 1 << RAM_LEVEL_BITS, sizeof(void *));
+    CHECK_CALLOC_RESULT(ram->directory);
+
+    ram->tlb = (ram_tlb_entry_t *) calloc(RAM_TLB_SIZE, sizeof(ram_tlb_entry_t));
+    CHECK_CALLOC_RESULT(ram->tlb);
+    for (int entry = 0; entry < RAM_TLB_SIZE; ++entry)
+    {
+        ram->tlb[entry] = {};
+    }
+
+    ram->size       = size;
+    ram->pagesCount = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that finds the page in the page table (it is allocated on the first access) and caches it in the TLB
+ * 
+ * @param ram 
+ * @param page index of the cell >> RAM_PAGE_BITS
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramFillTlb(ram_t *ram, size_t page)
+{
+    // Error check
+    if (ram == NULL || ram->directory == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Walk: tables of the upper levels, the last level points to the cells
+    void **table = ram->directory;
+    for (int level = RAM_LEVELS - 1; level >= 0; --level)
+    {
+        size_t index = (page >> (level * RAM_LEVEL_BITS)) & (((size_t) 1 << RAM_LEVEL_BITS) - 1);
+        if (table[index] == NULL)
+        {
+            table[index] = level == 0 ? calloc(RAM_PAGE_SIZE, sizeof(double))
+                                      : calloc((size_t) 1 << RAM_LEVEL_BITS, sizeof(void *));
+            if (table[index] == NULL)
+            {
+                PRINT_ERROR_TRACING_MESSAGE(MEMORY_EXIT_CODES::ERROR_ALLOCATING_PAGE);
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+            ram->pagesCount += level == 0;
+        }
+
+        if (level == 0)
+        {
+            ram->tlb[page & (RAM_TLB_SIZE - 1)] = {page, (double *) table[index]};
+        }
+        else
+        {
+            table = (void **) table[index];
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that frees the table of the page table with everything it points to
+ * 
+ * @param table 
+ * @param level 0 for the tables that point to the cells
+ */
+static void ramFreeTable(void **table, int level)
+{
+    for (size_t index = 0; table != NULL && index < (size_t) 1 << RAM_LEVEL_BITS; ++index)
+    {
+        if (level > 0)
+        {
+            ramFreeTable((void **) table[index], level - 1);
+        }
+        else
+        {
+            free(table[index]);
+        }
+    }
+
+    free(table);
+}
+
+/**
+ * @brief Function that frees the RAM (both flat and paged)
+ * 
+ * @param ram 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramDtor(ram_t *ram)
+{
+    // Error check
+    if (ram == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    ramFreeTable(ram->directory, RAM_LEVELS - 1);
+    free(ram->tlb);
+
+#if RAM_GUARD_SUPPORTED
+    if (ram->mapping != NULL)
+    {
+        munmap(ram->mapping, ram->mappingSize);
+    }
+    else
+    {
+        free(ram->cells);
+    }
+#else
+    free(ram->cells);
+#endif
+    *ram = {};
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that zeroes the pages of the table and of everything it points to
+ * 
+ * @param table 
+ * @param level 0 for the tables that point to the cells
+ */
+static void ramClearTable(void **table, int level)
+{
+    for (size_t index = 0; table != NULL && index < (size_t) 1 << RAM_LEVEL_BITS; ++index)
+    {
+        if (level > 0)
+        {
+            ramClearTable((void **) table[index], level - 1);
+        }
+        else if (table[index] != NULL)
+        {
+            memset(table[index], 0, RAM_PAGE_SIZE * sizeof(double));
+        }
+    }
+}
+
+/**
+ * @brief Function that zeroes every cell of the RAM (both flat and paged), the pages and the TLB stay as they are
+ * 
+ * Large mapped cells are given back to the kernel instead (only the touched pages cost anything, they are zeroed on the next touch)
+ * 
+ * @param ram 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramClear(ram_t *ram)
+{
+    // Error check
+    if (ram == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Paged RAM
+    if (ram->cells == NULL)
+    {
+        ramClearTable(ram->directory, RAM_LEVELS - 1);
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Flat RAM
+#if RAM_GUARD_SUPPORTED
+    if (ram->mapping != NULL && ram->size * sizeof(double) > RAM_CLEAR_BY_MEMSET_SIZE)
+    {
+        // Cells are aligned to the end of the mapped pages (see `ramCtor`)
+        size_t pageSize     = ram->hugePages ? HUGE_PAGE_SIZE : (size_t) sysconf(_SC_PAGESIZE);
+        char *cellsEnd      = (char *) (ram->cells + ram->size);
+        size_t cellsSize    = alignUp(ram->size * sizeof(double), pageSize);
+        if (madvise(cellsEnd - cellsSize, cellsSize, MADV_DONTNEED) == 0)
+        {
+            return EXIT_CODES::NO_ERRORS;
+        }
+    }
+#endif
+    memset(ram->cells, 0, ram->size * sizeof(double));
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that parses the size of the RAM in bytes with an optional `K`, `M` or `G` suffix
+ * 
+ * @param string 
+ * @param size amount of cells
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ramParseSize(const char *string, size_t *size)
+{
+    // Error check
+    if (string == NULL || size == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Parse
+    char *end = NULL;
+    unsigned long long bytes = strtoull(string, &end, 10);
+    switch (*end)
+    {
+        case 'K': case 'k': bytes <<= 10; ++end; break;
+        case 'M': case 'm': bytes <<= 20; ++end; break;
+        case 'G': case 'g': bytes <<= 30; ++end; break;
+        default:                                 break;
+    }
+
+    if (end == string || *end != '\0' || bytes < sizeof(double) || string[0] == '-')
+    {
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    *size = (size_t) bytes / sizeof(double);
+
+    return EXIT_CODES::NO_ERRORS;
+}
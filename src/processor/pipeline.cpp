@@ -0,0 +1,307 @@
+#include <chrono>       // for std::chrono::steady_clock
+#include <new>          // for std::nothrow
+#include <system_error> // for std::system_error
+
+#include "libs/colors/colors.h"
+
+#include "include/processor/pipeline.h"
+#include "include/processor/verifier.h"
+#include "include/processor/settings.h"
+
+/**
+ * @brief Function that reads, verifies and constructs the stage of `fileName` with the settings of `CPU` (nothing is left allocated on failure)
+ * 
+ * @param stage 
+ * @param CPU processor of the first stage
+ * @param fileName 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES pipelineStageCtor(pipeline_stage_t *stage, const cpu_t *CPU, const char *fileName)
+{
+    // Error check
+    if (stage == NULL || CPU == NULL || fileName == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    stage->fileName = fileName;
+    stage->byteCode = &stage->stageByteCode;
+    stage->CPU      = &stage->stageCPU;
+    textCtor(stage->byteCode, fileName, FILE_MODE::RB);
+
+    // Settings
+    cpu_t *stageCPU = stage->CPU;
+    stageCPU->RAMSize           = CPU->RAMSize;
+    stageCPU->RAMBackend        = CPU->RAMBackend;
+    stageCPU->hugePages         = CPU->hugePages;
+    stageCPU->outputFormat      = CPU->outputFormat;
+    stageCPU->inputFormat       = CPU->inputFormat;
+    stageCPU->maxCallDepth      = CPU->maxCallDepth;
+    stageCPU->engine            = CPU->engine;
+    stageCPU->paranoid          = CPU->paranoid;
+    stageCPU->verify            = CPU->verify;
+    stageCPU->fusion            = CPU->fusion;
+    stageCPU->tosCaching        = CPU->tosCaching;
+    stageCPU->stats.enabled     = CPU->stats.enabled;
+
+    // Verification (once, before the execution)
+    if (stageCPU->verify)
+    {
+        int violationsCount = 0;
+        IS_ERROR(verifyBytecode(stage->byteCode, stageCPU->RAMSize, &violationsCount))
+        {
+            textDtor(stage->byteCode);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        if (violationsCount != 0)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PIPELINE_EXIT_CODES::STAGE_BYTECODE_IS_NOT_VERIFIED);
+            textDtor(stage->byteCode);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        stageCPU->verified = true;
+    }
+
+    IS_ERROR(cpuCtor(stageCPU))
+    {
+        IS_OK_WO_EXIT(cpuDtor(stageCPU));
+        textDtor(stage->byteCode);
+        return EXIT_CODES::CONSTRUCTOR_ERROR;
+    }
+
+    // Stdin belongs to the first stage
+    return inputRecord(&stageCPU->input, NULL, 0);
+}
+
+/**
+ * @brief Function of the host thread of the stage: runs the program once and ends the rings around it
+ * 
+ * @param stage 
+ */
+static void pipelineStage(pipeline_stage_t *stage)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    cpu_t *CPU = stage->CPU;
+
+    IS_OK_WO_EXIT(cpuExecuteBytecode(stage->byteCode, CPU));
+    IS_OK_WO_EXIT(outputFlush(&CPU->output));
+
+    // The next stage reads the end of the input, the previous one drops the rest of its values
+    if (CPU->output.ring != NULL)
+    {
+        ringClose(CPU->output.ring);
+    }
+    if (CPU->input.ring != NULL)
+    {
+        ringAbandon(CPU->input.ring);
+    }
+
+    stage->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * @brief Function that prints the throughput of every stage and adds the statistics of the stages to the first one
+ * 
+ * @param pipeline 
+ */
+static void pipelinePrintStats(pipeline_t *pipeline)
+{
+    cpu_t *CPU = pipeline->stages[0].CPU;
+    for (int index = 0; index < pipeline->stagesCount; ++index)
+    {
+        pipeline_stage_t *stage = &pipeline->stages[index];
+        double seconds = stage->seconds > 0 ? stage->seconds : 1e-9;
+        unsigned long long emptyWaitsCount  = index > 0 ? pipeline->rings[index - 1].emptyWaitsCount : 0;
+        unsigned long long fullWaitsCount   = index < pipeline->stagesCount - 1 ? pipeline->rings[index].fullWaitsCount : 0;
+
+        fprintf(stderr, YELLOW "[PIPELINE]" RESET " stage %d (%s): in: %llu (%.1lf values/s), out: %llu (%.1lf values/s), "
+                        "waits for input: %llu, waits for output: %llu, time: %.3lf s, exit code: %d\n",
+                index + 1, stage->fileName,
+                stage->CPU->input.valuesCount, (double) stage->CPU->input.valuesCount / seconds,
+                stage->CPU->output.valuesCount, (double) stage->CPU->output.valuesCount / seconds,
+                emptyWaitsCount, fullWaitsCount, stage->seconds, cpuGetExitCode(stage->CPU));
+
+        if (index > 0)
+        {
+            CPU->stats.commands         += stage->CPU->stats.commands;
+            CPU->stats.fusedCommands    += stage->CPU->stats.fusedCommands;
+            CPU->stats.nativeCommands   += stage->CPU->stats.nativeCommands;
+        }
+    }
+}
+
+/**
+ * @brief Function that frees the stages after the first one (the first `constructedCount` are constructed) and the rings
+ * 
+ * @param pipeline 
+ * @param constructedCount 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES pipelineDtor(pipeline_t *pipeline, int constructedCount)
+{
+    // Error check
+    if (pipeline == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+    if (pipeline->stages != NULL)
+    {
+        for (int index = 1; index < constructedCount; ++index)
+        {
+            IS_ERROR(cpuDtor(pipeline->stages[index].CPU))
+            {
+                exitCode = EXIT_CODES::DESTRUCTOR_ERROR;
+            }
+            textDtor(pipeline->stages[index].byteCode);
+        }
+
+        // The processor of `main` outlives the rings
+        pipeline->stages[0].CPU->input.ring     = NULL;
+        pipeline->stages[0].CPU->output.ring    = NULL;
+    }
+
+    if (pipeline->rings != NULL)
+    {
+        for (int index = 0; index < pipeline->stagesCount - 1; ++index)
+        {
+            IS_OK_WO_EXIT(ringDtor(&pipeline->rings[index]));
+        }
+    }
+
+    delete[] pipeline->stages;
+    delete[] pipeline->rings;
+    *pipeline = {};
+
+    return exitCode;
+}
+
+/**
+ * @brief Function that executes the programs as one pipeline: the first one reads the input, the last one writes the output
+ * 
+ * Every stage runs on its own host thread with its own RAM. `out` of the stage pushes the raw double into the ring of the
+ * next stage and `in` of that stage pops it (`outc` is dropped), so no text is formatted or parsed between them. The producer
+ * of the full ring and the consumer of the empty one are parked. The stage that halts closes its output (the next stage reads
+ * the end of the input) and abandons its input (the previous stage drops the rest of its values)
+ * 
+ * @param byteCode bytecode of the first stage
+ * @param CPU processor of the first stage (its settings are used for all the stages)
+ * @param fileName bytecode file of the first stage
+ * @param pipeFileNames bytecode files of the next stages
+ * @param pipeFilesCount 
+ * @param exitCode EXIT_SUCCESS if every stage halted without a runtime error
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecutePipeline(text_t *byteCode, cpu_t *CPU, const char *fileName, char **pipeFileNames, int pipeFilesCount, int *exitCode)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL || fileName == NULL || pipeFileNames == NULL || exitCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (pipeFilesCount <= 0 || pipeFilesCount >= MAX_PIPELINE_STAGES)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PIPELINE_EXIT_CODES::BAD_STAGES_COUNT);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Stages and the rings between them
+    pipeline_t pipeline = {};
+    pipeline.stagesCount    = pipeFilesCount + 1;
+    pipeline.stages         = new (std::nothrow) pipeline_stage_t[pipeline.stagesCount];
+    pipeline.rings          = new (std::nothrow) ring_t[pipeline.stagesCount - 1];
+    if (pipeline.stages == NULL || pipeline.rings == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PIPELINE_EXIT_CODES::ERROR_ALLOCATING_STAGES);
+        IS_OK_WO_EXIT(pipelineDtor(&pipeline, 0));
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    for (int index = 0; index < pipeline.stagesCount - 1; ++index)
+    {
+        IS_ERROR(ringCtor(&pipeline.rings[index], PIPELINE_RING_SIZE))
+        {
+            IS_OK_WO_EXIT(pipelineDtor(&pipeline, 0));
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+
+    pipeline.stages[0].fileName = fileName;
+    pipeline.stages[0].byteCode = byteCode;
+    pipeline.stages[0].CPU      = CPU;
+
+    int constructedCount = 1;
+    for (; constructedCount < pipeline.stagesCount; ++constructedCount)
+    {
+        IS_ERROR(pipelineStageCtor(&pipeline.stages[constructedCount], CPU, pipeFileNames[constructedCount - 1]))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PIPELINE_EXIT_CODES::ERROR_CONSTRUCTING_STAGE_CPU);
+            IS_OK_WO_EXIT(pipelineDtor(&pipeline, constructedCount));
+            return EXIT_CODES::CONSTRUCTOR_ERROR;
+        }
+    }
+
+    // `out` of every stage but the last one is `in` of the next one
+    for (int index = 0; index < pipeline.stagesCount; ++index)
+    {
+        cpu_t *stageCPU = pipeline.stages[index].CPU;
+        if (index > 0)
+        {
+            stageCPU->input.ring = &pipeline.rings[index - 1];
+        }
+        if (index < pipeline.stagesCount - 1)
+        {
+            stageCPU->output.ring           = &pipeline.rings[index];
+            stageCPU->output.interactive    = false;
+        }
+    }
+
+    // Run (the stages that are started run to the end even if the next ones are not)
+    EXIT_CODES executionCode = EXIT_CODES::NO_ERRORS;
+    int startedCount = 0;
+    for (; startedCount < pipeline.stagesCount; ++startedCount)
+    {
+        try
+        {
+            pipeline.stages[startedCount].thread = std::thread(pipelineStage, &pipeline.stages[startedCount]);
+        }
+        catch (const std::system_error &)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PIPELINE_EXIT_CODES::ERROR_STARTING_STAGE);
+            if (startedCount > 0)
+            {
+                ringAbandon(&pipeline.rings[startedCount - 1]);
+            }
+            executionCode = EXIT_CODES::BAD_STD_FUNC_RESULT;
+            break;
+        }
+    }
+
+    *exitCode = EXIT_SUCCESS;
+    for (int index = 0; index < startedCount; ++index)
+    {
+        pipeline.stages[index].thread.join();
+        if (cpuGetExitCode(pipeline.stages[index].CPU) != EXIT_SUCCESS)
+        {
+            *exitCode = EXIT_FAILURE;
+        }
+    }
+
+    if (CPU->stats.enabled && executionCode == EXIT_CODES::NO_ERRORS)
+    {
+        pipelinePrintStats(&pipeline);
+    }
+
+    IS_ERROR(pipelineDtor(&pipeline, constructedCount))
+    {
+        return EXIT_CODES::DESTRUCTOR_ERROR;
+    }
+
+    return executionCode;
+}
@@ -1,10 +1,14 @@
 #include <math.h> // for fabs
+#include <string.h> // for memcpy, memset
+#include <setjmp.h> // for setjmp, longjmp
+#include <atomic>   // for std::atomic_thread_fence
 
 #include "libs/colors/colors.h"
 #include "libs/stack/include/stack.h"
 #include "libs/text/include/text.h"
 
 #include "include/processor/processor.h"
+#include "include/processor/smp.h"
 #include "include/processor/settings.h"
 
 /**
@@ -23,20 +27,55 @@ EXIT_CODES cpuCtor(cpu_t *CPU)
     }
 
     // Stack init
-    IS_ERROR(stackCtor(&CPU->stack))
+    IS_ERROR((CPU->paranoid ? stackCtor(&CPU->paranoidStack) : stackCtor(&CPU->stack)))
     {
         PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::BAD_STACK_PASSED);
         return EXIT_CODES::BAD_OBJECT_PASSED;
     }
 
-    // RAM init
-    CPU->RAM = (double *) calloc(MAX_RAM_SIZE, sizeof(double));
-    CHECK_CALLOC_RESULT(CPU->RAM);
+    // RAM init (the cores of the machine get the RAM of the first one, the green threads have no guard regions)
+    if (CPU->ownsMemory)
+    {
+        IS_ERROR((CPU->RAMBackend == RAM_BACKENDS::PAGED ? ramPagedCtor(&CPU->memory, CPU->RAMSize) :
+                  CPU->isGreen                           ? ramHeapCtor(&CPU->memory, CPU->RAMSize)
+                                                         : ramCtor(&CPU->memory, CPU->RAMSize, CPU->hugePages)))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(MEMORY_EXIT_CODES::ERROR_MAPPING_RAM);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+    }
+    CPU->RAM = CPU->memory.cells;
 
     // VRAM init
     CPU->VRAM = (byte *) calloc(MAX_VRAM_SIZE, sizeof(byte));
     CHECK_CALLOC_RESULT(CPU->VRAM);
 
+    // Output init (the green threads keep their output in memory, it grows from the small buffer)
+    IS_ERROR(outputCtor(&CPU->output, CPU->captureOutput || CPU->isGreen ? NULL : stdout,
+                        CPU->isGreen ? GREEN_OUTPUT_BUFFER_SIZE : OUTPUT_BUFFER_SIZE, CPU->outputFormat))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_OUTPUT_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    // Input init (the input of the green threads is appended by the scheduler)
+    IS_ERROR(inputCtor(&CPU->input, CPU->isGreen ? NULL : stdin, CPU->isGreen ? GREEN_INPUT_BUFFER_SIZE : INPUT_BUFFER_SIZE,
+                       CPU->inputFormat))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(IO_EXIT_CODES::ERROR_ALLOCATING_INPUT_BUFFER);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    // Call stack init (the green threads grow it when it is full)
+    CPU->callStackCapacity = CPU->isGreen && CPU->maxCallDepth > GREEN_CALL_STACK_SIZE ? GREEN_CALL_STACK_SIZE : CPU->maxCallDepth;
+    CPU->callStack = (offset *) calloc((size_t) CPU->callStackCapacity, sizeof(offset));
+    CHECK_CALLOC_RESULT(CPU->callStack);
+    CPU->callDepth = 0;
+
+    // Budget of the first run
+    CPU->budgetLeft = CPU->budget;
+    CPU->status     = {};
+
     return EXIT_CODES::NO_ERRORS;
 }
 
@@ -56,18 +95,57 @@ EXIT_CODES cpuDtor(cpu_t *CPU)
     }
 
     // Stack destruction
-    IS_ERROR(stackDtor(&CPU->stack))
+    IS_ERROR((CPU->paranoid ? stackDtor(&CPU->paranoidStack) : stackDtor(&CPU->stack)))
     {
         PRINT_ERROR_TRACING_MESSAGE(STACK_EXIT_CODES::BAD_STACK_PASSED);
         return EXIT_CODES::BAD_OBJECT_PASSED;
     }
 
-    // RAM destruction
-    free(CPU->RAM);
+    // RAM destruction (unless it is shared)
+    if (CPU->ownsMemory)
+    {
+        IS_ERROR(ramDtor(&CPU->memory))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    CPU->memory = {};
+    CPU->RAM    = NULL;
 
     // VRAM destruction
     free(CPU->VRAM);
 
+    // Output destruction (the rest of the text is written)
+    IS_OK_WO_EXIT(outputDtor(&CPU->output));
+
+    // Input destruction
+    IS_OK_WO_EXIT(inputDtor(&CPU->input));
+
+    // Call stack destruction
+    free(CPU->callStack);
+    CPU->callStack          = NULL;
+    CPU->callStackCapacity  = 0;
+    CPU->callDepth          = 0;
+
+    // Decoded program and native code destruction (unless they are shared)
+    if (CPU->program.commands != NULL && CPU->ownsProgram)
+    {
+        IS_OK_WO_EXIT(decodedProgramDtor(&CPU->program));
+    }
+    if (CPU->ownsProgram)
+    {
+        IS_OK_WO_EXIT(jitDtor(&CPU->jit));
+    }
+    CPU->program    = {};
+    CPU->jit        = {};
+    IS_OK_WO_EXIT(jitRecorderDtor(&CPU->recorder));
+    if (CPU->paranoid)
+    {
+        free(CPU->jitState.stackBase);  // Otherwise it is the buffer of the processor stack
+    }
+    CPU->jitState = {};
+
     return EXIT_CODES::NO_ERRORS;
 }
 
@@ -87,15 +165,32 @@ EXIT_CODES cpuDump(cpu_t *CPU, text_t *byteCode)
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
+    // Output of the program goes first
+    if (CPU->output.buffer != NULL)
+    {
+        IS_OK_WO_EXIT(outputFlush(&CPU->output));
+    }
+
     // Dump registers
     for (int reg = 0; reg < MAX_REGS_COUNT; ++reg)
     {
         printf(GREEN "$%cX" RESET ": %lf\n", 'A' + reg, CPU->commonRegs[reg]);
     }
-    printf(RED "$ip" RESET ": %d -> 0x%x\n\n", CPU->ip, (byte) byteCode->data[CPU->ip]);
+    for (int reg = 0; reg < MAX_INT_REGS_COUNT; ++reg)
+    {
+        printf(GREEN "$r%d" RESET ": %lld\n", reg, CPU->intRegs[reg]);
+    }
+    printf(RED "$ip" RESET ": %d -> 0x%x\n", CPU->ip, (byte) byteCode->data[CPU->ip]);
+    printf(RED "$flags" RESET ": 0x%x\n", (unsigned int) CPU->flags);
+    printf(RED "call stack" RESET " (%d of %d):", CPU->callDepth, CPU->maxCallDepth);
+    for (int frame = CPU->callDepth - 1; frame >= 0 && frame >= CPU->callDepth - RAM_CELLS_TO_DUMP; --frame)
+    {
+        printf(" 0x%x", CPU->callStack[frame]);
+    }
+    printf("\n\n");
 
     // Dump stack
-    IS_ERROR(stackDump(&CPU->stack))
+    IS_ERROR((CPU->paranoid ? stackDump(&CPU->paranoidStack) : stackDump(&CPU->stack)))
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DUMPING_PROCESSOR_STACK);
         return EXIT_CODES::BAD_OBJECT_PASSED;
@@ -103,9 +198,10 @@ EXIT_CODES cpuDump(cpu_t *CPU, text_t *byteCode)
     putchar('\n');
 
     // Dump RAM
-    for (int cell = 0; cell < RAM_CELLS_TO_DUMP; ++cell)
+    for (size_t cell = 0; cell < (size_t) RAM_CELLS_TO_DUMP && cell < CPU->RAMSize; ++cell)
     {
-        printf("[%lf]", CPU->RAM[cell]);
+        const double *value = ramCell(&CPU->memory, cell);
+        printf("[%lf]", value != NULL ? *value : BAD_DOUBLE_VALUE);
     }
     printf("\n\n");
 
@@ -113,34 +209,107 @@ EXIT_CODES cpuDump(cpu_t *CPU, text_t *byteCode)
 }
 
 /**
- * @brief Function used to destruct all the allocated memory for the entire virtual CPU
+ * @brief Function that prints the execution statistics (executed commands, CPU time, MIPS) of an virtual CPU
  * 
  * @param CPU 
- * @param byteCode 
- * @param exitCode 
+ * @return EXIT_CODES 
  */
-static void cpuExit(cpu_t *CPU, text_t *byteCode, int exitCode)
+EXIT_CODES cpuPrintStats(cpu_t *CPU)
 {
     // Error check
-    if (CPU == NULL || byteCode == NULL)
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Print statistics
+    double seconds = (double) (clock() - CPU->stats.startTime) / CLOCKS_PER_SEC;
+    double mips    = seconds > 0 ? (double) CPU->stats.commands / seconds / 1e6 : 0;
+
+    fprintf(stderr, YELLOW "[STATS]" RESET " commands: %llu, time: %.3lf s, %.3lf MIPS\n", CPU->stats.commands, seconds, mips);
+    if (CPU->engine == CPU_ENGINES::THREADED)
+    {
+        fprintf(stderr, YELLOW "[STATS]" RESET " superinstructions: %d, dispatches eliminated by fusion: %llu\n",
+                CPU->program.fusedCount, CPU->stats.fusedCommands);
+    }
+    else if (CPU->engine == CPU_ENGINES::JIT)
+    {
+        fprintf(stderr, YELLOW "[STATS]" RESET " compiled blocks: %d of %d, native code: %zu bytes, commands executed natively: %llu\n",
+                CPU->jit.compiledBlocksCount, CPU->jit.blocksCount, CPU->jit.codeSize, CPU->stats.nativeCommands);
+    }
+    else if (CPU->engine == CPU_ENGINES::TRACING)
+    {
+        fprintf(stderr, YELLOW "[STATS]" RESET " compiled traces: %d, native code: %zu bytes, commands executed natively: %llu\n",
+                CPU->jit.compiledBlocksCount, CPU->jit.codeSize, CPU->stats.nativeCommands);
+    }
+    if (CPU->RAMBackend == RAM_BACKENDS::PAGED)
+    {
+        fprintf(stderr, YELLOW "[STATS]" RESET " paged RAM: %zu pages touched (%zu KiB)\n",
+                CPU->memory.pagesCount, CPU->memory.pagesCount * RAM_PAGE_SIZE * sizeof(double) / 1024);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that stops the run with the status (the processor is kept as it is, so it may be reused or resumed)
+ * 
+ * Every run is executed under `exitPoint` (see `cpuExecuteBytecode` and `cpuExecuteSlice`), nothing is left to return to otherwise
+ * 
+ * @param CPU 
+ * @param state 
+ */
+[[noreturn]] static void cpuStop(cpu_t *CPU, CPU_STATES state)
+{
+    // Error check
+    if (CPU == NULL || CPU->exitPoint == NULL)
     {
         PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
-        exit(EXIT_FAILURE);
+        abort();
+    }
+
+    CPU->status.state = state;
+    longjmp(*CPU->exitPoint, 1);
+}
+
+/**
+ * @brief Function that finishes the run by `halt`
+ * 
+ * @param CPU 
+ * @param exitCode 
+ */
+[[noreturn]] static void cpuHalt(cpu_t *CPU, int exitCode)
+{
+    if (CPU != NULL)
+    {
+        CPU->status.exitCode = exitCode;
     }
 
-    // Exit
-    textDtor(byteCode);
-    IS_ERROR(cpuDtor(CPU))
+    cpuStop(CPU, CPU_STATES::HALTED);
+}
+
+/**
+ * @brief Function that finishes the run by the runtime error at `commandIp` (the command being executed, `ip` is left at it)
+ * 
+ * @param CPU 
+ * @param reason 
+ * @param commandIp 
+ */
+[[noreturn]] static void cpuTrap(cpu_t *CPU, PROCESSOR_EXIT_CODES reason, int commandIp)
+{
+    if (CPU != NULL)
     {
-        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::FAIL_DURING_CPU_DTOR_IN_HALT);
-        exit(EXIT_FAILURE);
+        CPU->status.trap    = reason;
+        CPU->status.ip      = commandIp;
+        CPU->ip             = commandIp;
     }
 
-    exit(exitCode);
+    cpuStop(CPU, CPU_STATES::TRAPPED);
 }
 
 /**
- * @brief Get the Register Value stored in it from bytecode
+ * @brief Get the Register Value stored in it from bytecode (the reason of the failure is left in `status.trap`)
  * 
  * @param CPU 
  * @param byteCode 
@@ -157,14 +326,27 @@ static EXIT_CODES _getRegisterValue(cpu_t *CPU, text_t *byteCode, double *result
     }
 
     // Get register value
+    if ((size_t) CPU->ip + sizeof(byte) > byteCode->size)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+        CPU->status.trap = PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE;
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
     byte regCode = (byte) byteCode->data[CPU->ip];
+    if (regCode >= MAX_REGS_COUNT)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_REGISTER_CODE);
+        CPU->status.trap = PROCESSOR_EXIT_CODES::BAD_REGISTER_CODE;
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
     *result = CPU->commonRegs[regCode];
 
     return EXIT_CODES::NO_ERRORS;
 }
 
 /**
- * @brief Function-wrapper of `_getRegisterValue` function (used for better error tracking)
+ * @brief Function-wrapper of `_getRegisterValue` function (the program is stopped if the register can not be read)
  * 
  * @param CPU 
  * @param byteCode 
@@ -181,10 +363,10 @@ static double getRegisterValue(cpu_t *CPU, text_t *byteCode)
 
     // Get register value
     double result = 0;
-    IS_ERROR(_getRegisterValue(CPU, byteCode, &result))
+    if (_getRegisterValue(CPU, byteCode, &result) != EXIT_CODES::NO_ERRORS)
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::FAIL_DURING_TAKING_REGISTER_VALUE);
-        return BAD_DOUBLE_VALUE;
+        cpuTrap(CPU, CPU->status.trap, CPU->status.ip);
     }
 
     return result;
@@ -208,13 +390,18 @@ static EXIT_CODES _getImmediateValue(cpu_t *CPU, text_t *byteCode, double *resul
     }
 
     // Get immediate (double) value
+    if ((size_t) CPU->ip + sizeof(double) > byteCode->size)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
     *result = *((double *) &byteCode->data[CPU->ip]);
 
     return EXIT_CODES::NO_ERRORS;
 }
 
 /**
- * @brief Wrapper-function of `_getImmediateValue` function (used for better error tracking)
+ * @brief Wrapper-function of `_getImmediateValue` function (the program is stopped if the immediate is out of the bytecode)
  * 
  * @param CPU 
  * @param byteCode 
@@ -231,17 +418,84 @@ static double getImmediateValue(cpu_t *CPU, text_t *byteCode)
 
     // Get immediate (double) value
     double result = 0;
-    IS_ERROR(_getImmediateValue(CPU, byteCode, &result))
+    if (_getImmediateValue(CPU, byteCode, &result) != EXIT_CODES::NO_ERRORS)
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::FAIL_DURING_TAKING_IMMEDIATE_VALUE);
-        return BAD_DOUBLE_VALUE;
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE, CPU->status.ip);
     }
 
     return result;
 }
 
 /**
- * @brief Function that evaluates the argument of a command
+ * @brief Structure that represents the evaluated argument of a command (integer registers are summed separately)
+ * 
+ */
+struct cpu_expression_t
+{
+    double value                        = 0;        // Sum of the immediates and the common registers
+    long long intValue                  = 0;        // Sum of the integer registers
+    int regsCount                       = 0;        // Amount of common registers
+    int intRegsCount                    = 0;        // Amount of integer registers
+};
+
+/**
+ * @brief Function that finds the RAM cell by the integer index (NULL if it is out of range)
+ * 
+ * @param CPU 
+ * @param index 
+ * @return double* 
+ */
+static inline double *cpuIntRamCell(cpu_t *CPU, long long index)
+{
+    return (unsigned long long) index < CPU->RAMSize ? ramCell(&CPU->memory, (size_t) index) : NULL;
+}
+
+/**
+ * @brief Function that finds the RAM cell by the address popped from the stack (NULL if it is invalid)
+ * 
+ * @param CPU 
+ * @param index 
+ * @return double* 
+ */
+static inline double *cpuRamCell(cpu_t *CPU, double index)
+{
+    return IS_VALID_RAM_INDEX(index, CPU->RAMSize) ? ramCell(&CPU->memory, (size_t) index) : NULL;
+}
+
+/**
+ * @brief Function that returns the value of the evaluated argument
+ * 
+ * @param expression 
+ * @return double 
+ */
+static inline double cpuExpressionValue(const cpu_expression_t *expression)
+{
+    return expression->intRegsCount != 0 ? expression->value + (double) expression->intValue : expression->value;
+}
+
+/**
+ * @brief Function that finds the RAM cell the evaluated argument points to (NULL if the address is invalid)
+ * 
+ * Address of integer registers and integral displacement is not checked with EPS (see `IS_VALID_RAM_INDEX`)
+ * 
+ * @param CPU 
+ * @param expression 
+ * @return double* 
+ */
+static double *cpuExpressionCell(cpu_t *CPU, const cpu_expression_t *expression)
+{
+    if (expression->regsCount == 0 && expression->intRegsCount != 0 && IS_INTEGRAL(expression->value))
+    {
+        return cpuIntRamCell(CPU, WRAPPED(expression->intValue, +, (long long) expression->value));
+    }
+
+    double index = cpuExpressionValue(expression);
+    return IS_VALID_RAM_INDEX(index, CPU->RAMSize) ? ramCell(&CPU->memory, (size_t) index) : NULL;
+}
+
+/**
+ * @brief Function that evaluates the argument of a command (the program is stopped if it is invalid)
  * 
  * @param CPU 
  * @param byteCode 
@@ -249,7 +503,7 @@ static double getImmediateValue(cpu_t *CPU, text_t *byteCode)
  * @param result 
  * @return EXIT_CODES 
  */
-static EXIT_CODES __cpuCountInternalExpressionValue(cpu_t *CPU, text_t *byteCode, size_t argc, double *result)
+static EXIT_CODES __cpuCountInternalExpressionValue(cpu_t *CPU, text_t *byteCode, size_t argc, cpu_expression_t *result)
 {
     // Error check
     if (CPU == NULL || byteCode == NULL || result == NULL)
@@ -259,15 +513,30 @@ static EXIT_CODES __cpuCountInternalExpressionValue(cpu_t *CPU, text_t *byteCode
     }
 
     // Count expression value
-    *result = 0;
+    *result = {};
     for (size_t arg = 0; arg < argc; ++arg)
     {
+        if ((size_t) CPU->ip >= byteCode->size)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE, CPU->status.ip);
+        }
+
         // Get bytecode double value
         if (MRI_IS_REGISTER(byteCode->data[CPU->ip]))  // CPU->ip is pointing to byte after globalMRI
         {
             ++CPU->ip;   
 
-            *result += getRegisterValue(CPU, byteCode);
+            if ((size_t) CPU->ip < byteCode->size && IS_INT_REGISTER_CODE((byte) byteCode->data[CPU->ip]))
+            {
+                result->intValue = WRAPPED(result->intValue, +, CPU->intRegs[(byte) byteCode->data[CPU->ip] - INT_REGS_BASE]);
+                ++result->intRegsCount;
+            }
+            else
+            {
+                result->value += getRegisterValue(CPU, byteCode);
+                ++result->regsCount;
+            }
 
             CPU->ip += sizeof(byte);
         }
@@ -275,14 +544,14 @@ static EXIT_CODES __cpuCountInternalExpressionValue(cpu_t *CPU, text_t *byteCode
         {
             ++CPU->ip;
             
-            *result += getImmediateValue(CPU, byteCode);
+            result->value += getImmediateValue(CPU, byteCode);
 
             CPU->ip += sizeof(double);
         }
         else
         {
             PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_INSTRUCTION_TYPE_ARG);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::UNKNOWN_INSTRUCTION_TYPE_ARG, CPU->status.ip);
         }
     }
 
@@ -307,27 +576,32 @@ static EXIT_CODES _cpuGetBytecodeValue(cpu_t *CPU, text_t *byteCode, double *res
     }
 
     // Get metainfo
+    if ((size_t) CPU->ip >= byteCode->size)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE, CPU->status.ip);
+    }
+
     size_t argc     = (size_t)  GET_TOTAL_ARGS(byteCode->data[CPU->ip]);
     int globalMRI   = (int)     GET_GLOBAL_MRI(byteCode->data[CPU->ip++]);
-    IS_ERROR(__cpuCountInternalExpressionValue(CPU, byteCode, argc, result))
+    cpu_expression_t expression = {};
+    IS_ERROR(__cpuCountInternalExpressionValue(CPU, byteCode, argc, &expression))
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_COUNTING_INTERNAL_EXPRESSION_VALUE);
         return EXIT_CODES::BAD_OBJECT_PASSED;
     }
+    *result = cpuExpressionValue(&expression);
 
     // Check global MRI <-> Memory, Register, Immediate (actually for globalMRI using only memory)
     if (MRI_IS_MEMORY(globalMRI))
     {
-        // TODO: check all RAM index etc. && maybe do separate function
-        if (fabs(*result - fabs((int) *result)) < EPS)
-        {
-            *result = CPU->RAM[(int) *result];  
-        }
-        else
+        double *cell = cpuExpressionCell(CPU, &expression);
+        if (cell == NULL)
         {
             PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX, CPU->status.ip);
         }
+        *result = ramLoad(cell);
     }
 
     return EXIT_CODES::NO_ERRORS;
@@ -349,14 +623,12 @@ static double cpuGetBytecodeValue(cpu_t *CPU, text_t *byteCode)
         return BAD_DOUBLE_VALUE;
     }
 
-    //TODO: EXIT_PANIC
-    // Get bytecode double value (calculate expression if there is one)
+    // Get bytecode double value (calculate expression if there is one), the program is stopped if it can not be read
     double result = DEFAULT_DOUBLE_VALUE;
-    IS_ERROR(_cpuGetBytecodeValue(CPU, byteCode, &result))
+    if (_cpuGetBytecodeValue(CPU, byteCode, &result) != EXIT_CODES::NO_ERRORS)
     {
-        // TODO: processor error flag that determines the stay of processor
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_READING_BYTECODE_DOUBLE_VALUE);
-        return BAD_DOUBLE_VALUE;
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::ERROR_READING_BYTECODE_DOUBLE_VALUE, CPU->status.ip);
     }
 
     return result;
@@ -379,7 +651,7 @@ static EXIT_CODES _cpuPop(cpu_t *CPU, double *result)
     }
 
     // Pop
-    IS_ERROR(stackPop(&CPU->stack, result))
+    IS_ERROR((CPU->paranoid ? stackPop(&CPU->paranoidStack, result) : stackPop(&CPU->stack, result)))
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_POPPING_VALUE_FROM_STACK);
         return EXIT_CODES::BAD_OBJECT_PASSED;
@@ -389,12 +661,13 @@ static EXIT_CODES _cpuPop(cpu_t *CPU, double *result)
 }
 
 /**
- * @brief Function-wrapper of `_cpuPop` function (used for better error tracking)
+ * @brief Function-wrapper of `_cpuPop` function (the program is stopped if the stack is empty)
  * 
  * @param CPU 
+ * @param commandIp bytecode offset of the command that pops
  * @return double 
  */
-static double cpuPop(cpu_t *CPU)
+static double cpuPop(cpu_t *CPU, int commandIp)
 {
     // Error check
     if (CPU == NULL)
@@ -405,23 +678,24 @@ static double cpuPop(cpu_t *CPU)
 
     // Pop
     double result = DEFAULT_DOUBLE_VALUE;
-    IS_ERROR(_cpuPop(CPU, &result))
+    if (_cpuPop(CPU, &result) != EXIT_CODES::NO_ERRORS)
     {
-        // TODO: processor error flag that determines the stay of processor
+        bool isEmpty = (CPU->paranoid ? CPU->paranoidStack.size : CPU->stack.size) == 0;
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_READING_DOUBLE_FROM_STACK);
-        return BAD_DOUBLE_VALUE;
+        cpuTrap(CPU, isEmpty ? PROCESSOR_EXIT_CODES::STACK_UNDERFLOW : PROCESSOR_EXIT_CODES::ERROR_READING_DOUBLE_FROM_STACK, commandIp);
     }
     return result;
 }
 
 /**
- * @brief Function-wrapper of `stackPush` function (used for better error tracking)
+ * @brief Function-wrapper of `stackPush` function (the program is stopped if the stack is corrupted or can not grow)
  * 
  * @param CPU 
  * @param value 
+ * @param commandIp bytecode offset of the command that pushes
  * @return EXIT_CODES 
  */
-static EXIT_CODES cpuPush(cpu_t *CPU, double value)
+static EXIT_CODES cpuPush(cpu_t *CPU, double value, int commandIp)
 {
     // Error check
     if (CPU == NULL)
@@ -431,19 +705,81 @@ static EXIT_CODES cpuPush(cpu_t *CPU, double value)
     }
 
     // Push
-    IS_ERROR(stackPush(&CPU->stack, value))
+    if ((CPU->paranoid ? stackPush(&CPU->paranoidStack, value) : stackPush(&CPU->stack, value)) != EXIT_CODES::NO_ERRORS)
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
-        return EXIT_CODES::BAD_OBJECT_PASSED;
-    }   
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK, commandIp);
+    }
 
     return EXIT_CODES::NO_ERRORS;
 }
 
+/**
+ * @brief Function that doubles the call stack of the green thread (up to `maxCallDepth` entries), the program is stopped if it fails
+ * 
+ * @param CPU 
+ * @param commandIp bytecode offset of `call`
+ */
+static void cpuGrowCallStack(cpu_t *CPU, int commandIp)
+{
+    int capacity = CPU->callStackCapacity <= CPU->maxCallDepth / 2 ? 2 * CPU->callStackCapacity : CPU->maxCallDepth;
+    offset *callStack = (offset *) realloc(CPU->callStack, (size_t) capacity * sizeof(offset));
+    if (callStack == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_GROWING_CALL_STACK);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::ERROR_GROWING_CALL_STACK, commandIp);
+    }
+
+    CPU->callStack          = callStack;
+    CPU->callStackCapacity  = capacity;
+}
+
+/**
+ * @brief Function that saves the return address of `call` on the call stack (the program is stopped if it is full)
+ * 
+ * @param CPU 
+ * @param address 
+ * @param commandIp bytecode offset of `call`
+ */
+static inline void cpuCallPush(cpu_t *CPU, offset address, int commandIp)
+{
+    if (CPU->callDepth >= CPU->callStackCapacity)
+    {
+        if (CPU->callDepth >= CPU->maxCallDepth)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::CALL_STACK_OVERFLOW);
+            fprintf(stderr, "Call depth exceeded %d (see `--max-call-depth`)\n", CPU->maxCallDepth);
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::CALL_STACK_OVERFLOW, commandIp);
+        }
+
+        cpuGrowCallStack(CPU, commandIp);
+    }
+
+    CPU->callStack[CPU->callDepth++] = address;
+}
+
+/**
+ * @brief Function that takes the return address of `ret` from the call stack (the program is stopped if it is empty)
+ * 
+ * @param CPU 
+ * @param commandIp bytecode offset of `ret`
+ * @return offset 
+ */
+static inline offset cpuCallPop(cpu_t *CPU, int commandIp)
+{
+    if (CPU->callDepth <= 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::CALL_STACK_UNDERFLOW);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::CALL_STACK_UNDERFLOW, commandIp);
+    }
+
+    return CPU->callStack[--CPU->callDepth];
+}
+
 /**
  * @brief Function that extracts an offset (to the label) from the bytecode
  * 
- * @param CPU
+ * @param CPU 
  * @param byteCode 
  * @param result 
  * @return EXIT_CODES 
@@ -458,6 +794,11 @@ static EXIT_CODES _cpuGetBytecodeOffset(cpu_t *CPU, text_t *byteCode, offset *re
     }
 
     // Get offset
+    if ((size_t) CPU->ip + sizeof(offset) > byteCode->size)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
     *result = *((offset *) &byteCode->data[CPU->ip]);
 
     return EXIT_CODES::NO_ERRORS;
@@ -476,7 +817,7 @@ static offset cpuGetBytecodeOffset(cpu_t *CPU, text_t *byteCode)
     if (CPU == NULL || byteCode == NULL)
     {
         PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
-        cpuExit(CPU, byteCode, EXIT_FAILURE);
+        cpuStop(CPU, CPU_STATES::TRAPPED);
     }
 
     // Get offset
@@ -484,7 +825,7 @@ static offset cpuGetBytecodeOffset(cpu_t *CPU, text_t *byteCode)
     IS_ERROR(_cpuGetBytecodeOffset(CPU, byteCode, &displacement))
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::FAIL_DURING_TAKING_OFFSET);
-        cpuExit(CPU, byteCode, EXIT_FAILURE);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::FAIL_DURING_TAKING_OFFSET, CPU->status.ip);
     }
 
     return displacement;
@@ -506,11 +847,52 @@ static EXIT_CODES cpuOut(cpu_t *CPU)
     }
 
     // Out
-    printf("%lf", cpuPop(CPU));
+    IS_ERROR(outputDouble(&CPU->output, cpuPop(CPU, CPU->status.ip)))
+    {
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
 
     return EXIT_CODES::NO_ERRORS;
 }
 
+/**
+ * @brief Function that reads the next value of the input and sets END_OF_INPUT_FLAG or BAD_INPUT_FLAG (the value is NaN then)
+ * 
+ * @param CPU 
+ * @return double 
+ */
+static double cpuInput(cpu_t *CPU)
+{
+    // Prompt is shown before the input on terminals
+    if (CPU->output.interactive)
+    {
+        IS_OK_WO_EXIT(outputFlush(&CPU->output));
+    }
+
+    double value = 0;
+    INPUT_RESULTS result = INPUT_RESULTS::VALUE;
+    IS_OK_WO_EXIT(inputDouble(&CPU->input, &value, &result));
+
+    // The green thread waits for the value (the flags are set by the `in` that reads it)
+    if (result == INPUT_RESULTS::NOT_READY)
+    {
+        CPU->isWaitingForInput = true;
+        return value;
+    }
+
+    CPU->flags &= ~(END_OF_INPUT_FLAG | BAD_INPUT_FLAG);
+    switch (result)
+    {
+        case INPUT_RESULTS::END_OF_INPUT:   CPU->flags |= END_OF_INPUT_FLAG;    break;
+        case INPUT_RESULTS::BAD_VALUE:      CPU->flags |= BAD_INPUT_FLAG;       break;
+        case INPUT_RESULTS::VALUE:
+        case INPUT_RESULTS::NOT_READY:
+        default:                                                                break;
+    }
+
+    return value;
+}
+
 /**
  * @brief Function that reads value from the keyboard into RAM (actually it is stack)
  * 
@@ -526,12 +908,15 @@ static EXIT_CODES cpuIn(cpu_t *CPU)
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
-    // Get input
-    double input = 0;
-    scanf("%lf", &input);
+    // Get input (nothing is pushed while the green thread waits for it)
+    double input = cpuInput(CPU);
+    if (CPU->isWaitingForInput)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
 
     // Push
-    IS_ERROR(cpuPush(CPU, input))
+    IS_ERROR(cpuPush(CPU, input, CPU->status.ip))
     {
         PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_INPUTED_VALUE_TO_STACK);
         return EXIT_CODES::BAD_OBJECT_PASSED;
@@ -555,120 +940,1172 @@ static EXIT_CODES cpuOutc(cpu_t *CPU)
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
-    printf("%c", (int) cpuPop(CPU));
+    IS_ERROR(outputChar(&CPU->output, (char) (int) cpuPop(CPU, CPU->status.ip)))
+    {
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
 
     return EXIT_CODES::NO_ERRORS;
 }
 
 /**
- * @brief Function that does the 'mov' action
+ * @brief Function that moves the value into the integer register (it is truncated, the register is kept if the value does not fit)
  * 
  * @param CPU 
+ * @param reg index of the integer register
+ * @param value 
  * @return EXIT_CODES 
  */
-static EXIT_CODES cpuMoveValue(cpu_t *CPU, text_t *byteCode, double value)
+static EXIT_CODES cpuMoveIntoIntRegister(cpu_t *CPU, byte reg, double value)
 {
     // Error check
-    if (CPU == NULL || byteCode == NULL)
+    if (CPU == NULL || reg >= MAX_INT_REGS_COUNT)
     {
         PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
 
-    // Move value
-    size_t argc     = (size_t)  GET_TOTAL_ARGS(byteCode->data[CPU->ip]);
-    int globalMRI   = (int)     GET_GLOBAL_MRI(byteCode->data[CPU->ip++]);
-    if (MRI_IS_MEMORY(globalMRI))
-    {
-        double result = 0;
-        IS_ERROR(__cpuCountInternalExpressionValue(CPU, byteCode, argc, &result))
-        {
-            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_COUNTING_INTERNAL_EXPRESSION_VALUE);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
-
-        // TODO: check all RAM index etc. && maybe do separate function
-        // TODO: copy-paste do function or something
-        if (fabs(result - fabs((int) result)) < EPS)
-        {
-            CPU->RAM[(int) result] = value;
-        }
-        else
-        {
-            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }       
-    }
-    else
+    // Move
+    if (!FITS_INT_REGISTER(value))
     {
-        if (MRI_IS_REGISTER(byteCode->data[CPU->ip]))
-        {
-            // Move value into register
-            ++CPU->ip;
-
-            byte regCode = (byte) byteCode->data[CPU->ip];
-            CPU->commonRegs[regCode] = value;
-
-            CPU->ip += sizeof(byte);
-        }
-        else
-        {
-            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::CANT_POP_VALUE_INTO_IMMEDIATE);
-            return EXIT_CODES::BAD_OBJECT_PASSED;
-        }
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::VALUE_DOES_NOT_FIT_INTEGER_REGISTER);
+        CPU->status.trap = PROCESSOR_EXIT_CODES::VALUE_DOES_NOT_FIT_INTEGER_REGISTER;
+        return EXIT_CODES::BAD_OBJECT_PASSED;
     }
+    CPU->intRegs[reg] = (long long) value;
 
     return EXIT_CODES::NO_ERRORS;
 }
 
-#define OPDEF(unused, opcode, argc, code, ...)   \
-    case ((byte) opcode): { code }; break; //printf("Mnemonics: %s\n", #unused);
-
 /**
- * @brief Function that determines and executes one instruction from bytecode
+ * @brief Function that extracts the operand of INTEGER command from the bytecode (the program is stopped if it is invalid)
  * 
  * @param CPU 
  * @param byteCode 
- * @return EXIT_CODES 
+ * @param source value of the source register or immediate
+ * @return long long* destination register
  */
-static EXIT_CODES cpuExecuteCommand(cpu_t *CPU, text_t *byteCode)
+static long long *cpuGetIntegerOperand(cpu_t *CPU, text_t *byteCode, long long *source)
 {
     // Error check
-    if (CPU == NULL || byteCode == NULL)
+    if (CPU == NULL || byteCode == NULL || source == NULL)
     {
         PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
-        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+        cpuStop(CPU, CPU_STATES::TRAPPED);
     }
 
-    // Execution
-    double val              = DEFAULT_DOUBLE_VALUE;
-    double val1             = DEFAULT_DOUBLE_VALUE;
-    double val2             = DEFAULT_DOUBLE_VALUE;
+    // Destination
+    if ((size_t) CPU->ip + 2 * sizeof(byte) > byteCode->size || !IS_INT_REGISTER_CODE((byte) byteCode->data[CPU->ip]))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_REGISTER_CODE);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::BAD_REGISTER_CODE, CPU->status.ip);
+    }
+    long long *destination = &CPU->intRegs[(byte) byteCode->data[CPU->ip++] - INT_REGS_BASE];
+
+    // Source
+    byte sourceMRI = (byte) byteCode->data[CPU->ip++];
+    if (MRI_IS_REGISTER(sourceMRI) && (size_t) CPU->ip + sizeof(byte) <= byteCode->size &&
+        IS_INT_REGISTER_CODE((byte) byteCode->data[CPU->ip]))
+    {
+        *source = CPU->intRegs[(byte) byteCode->data[CPU->ip] - INT_REGS_BASE];
+        CPU->ip += sizeof(byte);
+    }
+    else if (MRI_IS_IMMEDIATE(sourceMRI) && (size_t) CPU->ip + sizeof(long long) <= byteCode->size)
+    {
+        memcpy(source, &byteCode->data[CPU->ip], sizeof(long long));
+        CPU->ip += sizeof(long long);
+    }
+    else
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_INSTRUCTION_TYPE_ARG);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::UNKNOWN_INSTRUCTION_TYPE_ARG, CPU->status.ip);
+    }
+
+    return destination;
+}
+
+/**
+ * @brief Function that does the 'mov' action
+ * 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuMoveValue(cpu_t *CPU, text_t *byteCode, double value)
+{
+    // Error check
+    if (CPU == NULL || byteCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Move value
+    if ((size_t) CPU->ip >= byteCode->size)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+        cpuTrap(CPU, PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE, CPU->status.ip);
+    }
+
+    size_t argc     = (size_t)  GET_TOTAL_ARGS(byteCode->data[CPU->ip]);
+    int globalMRI   = (int)     GET_GLOBAL_MRI(byteCode->data[CPU->ip++]);
+    if (MRI_IS_MEMORY(globalMRI))
+    {
+        cpu_expression_t expression = {};
+        IS_ERROR(__cpuCountInternalExpressionValue(CPU, byteCode, argc, &expression))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_COUNTING_INTERNAL_EXPRESSION_VALUE);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        double *cell = cpuExpressionCell(CPU, &expression);
+        if (cell == NULL)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX, CPU->status.ip);
+        }
+        ramStore(cell, value);
+    }
+    else
+    {
+        if ((size_t) CPU->ip < byteCode->size && MRI_IS_REGISTER(byteCode->data[CPU->ip]))
+        {
+            // Move value into register
+            ++CPU->ip;
+
+            if ((size_t) CPU->ip >= byteCode->size)
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE);
+                cpuTrap(CPU, PROCESSOR_EXIT_CODES::OPERAND_IS_OUT_OF_BYTECODE, CPU->status.ip);
+            }
+            if ((byte) byteCode->data[CPU->ip] >= MAX_REGS_COUNT && !IS_INT_REGISTER_CODE((byte) byteCode->data[CPU->ip]))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_REGISTER_CODE);
+                cpuTrap(CPU, PROCESSOR_EXIT_CODES::BAD_REGISTER_CODE, CPU->status.ip);
+            }
+
+            byte regCode = (byte) byteCode->data[CPU->ip];
+            CPU->ip += sizeof(byte);
+            if (IS_INT_REGISTER_CODE(regCode))
+            {
+                if (cpuMoveIntoIntRegister(CPU, (byte) (regCode - INT_REGS_BASE), value) != EXIT_CODES::NO_ERRORS)
+                {
+                    cpuTrap(CPU, PROCESSOR_EXIT_CODES::VALUE_DOES_NOT_FIT_INTEGER_REGISTER, CPU->status.ip);
+                }
+            }
+            else
+            {
+                CPU->commonRegs[regCode] = value;
+            }
+        }
+        else
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::CANT_POP_VALUE_INTO_IMMEDIATE);
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::CANT_POP_VALUE_INTO_IMMEDIATE, CPU->status.ip);
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+#define OPDEF(unused, opcode, argc, argType, code, ...)   \
+    case ((byte) opcode): { code }; break; //printf("Mnemonics: %s\n", #unused);
+
+/**
+ * @brief Function that determines and executes one instruction from bytecode
+ * 
+ * @param CPU 
+ * @param byteCode 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuExecuteCommand(cpu_t *CPU, text_t *byteCode)
+{
+    // Error check
+    if (CPU == NULL || byteCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Execution
+    double val              = DEFAULT_DOUBLE_VALUE;
+    double val1             = DEFAULT_DOUBLE_VALUE;
+    double val2             = DEFAULT_DOUBLE_VALUE;
+    offset displacement     = 0;
+    long long *intDestination   = NULL;
+    long long intSource         = 0;
+    double *cell                = NULL;
+
+    CPU->status.ip = CPU->ip;   // Command the runtime error of it is reported at
+    byte opcode = (byte) byteCode->data[CPU->ip++];    
+    switch(opcode)
+    {
+        #include "include/opdefs.h"
+
+        default:
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_OPCODE_BYTE);
+            cpuTrap(CPU, PROCESSOR_EXIT_CODES::UNKNOWN_OPCODE_BYTE, CPU->status.ip);
+    } 
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+#undef OPDEF
+
+/**
+ * @brief Function that evaluates the argument of the decoded command whose arguments are in `extraRegs` of the program (EXTRA_INT_REGISTER)
+ * 
+ * Immediates and common registers are added in the order of the arguments (the same as `switch` engine does)
+ * 
+ * @param CPU 
+ * @param command 
+ * @return double 
+ */
+static __attribute__((noinline, cold)) double cpuExtraRegsValue(const cpu_t *CPU, const decoded_command_t *command)
+{
+    const decoded_extra_regs_t *extra = &CPU->program.extraRegs[command - CPU->program.commands];
+
+    double value        = 0;
+    long long intSum    = 0;
+    bool hasIntRegs     = false;
+    for (int reg = 0; reg < extra->count; ++reg)
+    {
+        byte regCode = extra->codes[reg];
+        if (regCode == EXTRA_IMMEDIATE_CODE)
+        {
+            value += extra->immediates[reg];
+        }
+        else if (IS_INT_REGISTER_CODE(regCode))
+        {
+            intSum      = WRAPPED(intSum, +, CPU->intRegs[regCode - INT_REGS_BASE]);
+            hasIntRegs  = true;
+        }
+        else
+        {
+            value += CPU->commonRegs[regCode];
+        }
+    }
+
+    return hasIntRegs ? value + (double) intSum : value;
+}
+
+/**
+ * @brief Function that evaluates the argument of the decoded command (unused registers are ZERO_REGISTER and ZERO_INT_REGISTER)
+ * 
+ * @param CPU 
+ * @param command 
+ * @return double 
+ */
+static inline double cpuDecodedValue(const cpu_t *CPU, const decoded_command_t *command)
+{
+    double value = (command->immediate + CPU->commonRegs[command->regs[0]]) + CPU->commonRegs[command->regs[1]];
+    if (command->intRegs[0] != ZERO_INT_REGISTER)
+    {
+        if (command->intRegs[0] == EXTRA_INT_REGISTER)
+        {
+            return cpuExtraRegsValue(CPU, command);
+        }
+
+        value += (double) WRAPPED(CPU->intRegs[command->intRegs[0]], +, CPU->intRegs[command->intRegs[1]]);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Function that finds the RAM cell the argument of the decoded command points to (NULL if the address is invalid)
+ * 
+ * @param CPU 
+ * @param command 
+ * @return double* 
+ */
+static inline double *cpuDecodedCell(cpu_t *CPU, const decoded_command_t *command)
+{
+    if (command->intAddress)
+    {
+        long long index = WRAPPED(command->intImmediate, +, CPU->intRegs[command->intRegs[0]]);
+        return cpuIntRamCell(CPU, WRAPPED(index, +, CPU->intRegs[command->intRegs[1]]));
+    }
+
+    double index = cpuDecodedValue(CPU, command);
+    return IS_VALID_RAM_INDEX(index, CPU->RAMSize) ? ramCell(&CPU->memory, (size_t) index) : NULL;
+}
+
+/**
+ * @brief Function that extracts the argument value of the decoded command (memory, registers, immediate), the reason of the failure is left in `status.trap`
+ * 
+ * @param CPU 
+ * @param command 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES _cpuGetDecodedValue(cpu_t *CPU, const decoded_command_t *command, double *result)
+{
+    // Error check
+    if (CPU == NULL || command == NULL || result == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Check global MRI
+    if (MRI_IS_MEMORY(command->MRI))
+    {
+        double *cell = cpuDecodedCell(CPU, command);
+        if (cell != NULL)
+        {
+            *result = ramLoad(cell);
+        }
+        else
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+            CPU->status.trap = PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX;
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    else
+    {
+        *result = cpuDecodedValue(CPU, command);
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that does the 'mov' action for the decoded command, the reason of the failure is left in `status.trap`
+ * 
+ * @param CPU 
+ * @param command 
+ * @param value 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuMoveDecodedValue(cpu_t *CPU, const decoded_command_t *command, double value)
+{
+    // Error check
+    if (CPU == NULL || command == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Move value
+    if (MRI_IS_MEMORY(command->MRI))
+    {
+        double *cell = cpuDecodedCell(CPU, command);
+        if (cell != NULL)
+        {
+            ramStore(cell, value);
+        }
+        else
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX);
+            CPU->status.trap = PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX;
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    else if (command->destination != ZERO_REGISTER)
+    {
+        CPU->commonRegs[command->destination] = value;
+    }
+    else if (command->intDestination != ZERO_INT_REGISTER)
+    {
+        return cpuMoveIntoIntRegister(CPU, command->intDestination, value);
+    }
+    else
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::CANT_POP_VALUE_INTO_IMMEDIATE);
+        CPU->status.trap = PROCESSOR_EXIT_CODES::CANT_POP_VALUE_INTO_IMMEDIATE;
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that checks the return address of `vret` (taken from the stack of values) is the start of the decoded command
+ * 
+ * @param CPU 
+ * @param address 
+ * @return bool 
+ */
+static bool cpuIsDecodedReturnAddress(const cpu_t *CPU, double address)
+{
+    return IS_INTEGRAL(address) && address >= 0 && address <= (double) CPU->program.bytesCount &&
+           CPU->program.commandIndex[(offset) address] != BAD_TARGET;
+}
+
+#if defined(__GNUC__)
+
+/**
+ * @brief Structure that holds up to two topmost values of the processor stack outside of `stack_t` (in host registers)
+ * 
+ * Its push and pop are always inlined: the cache stays in host registers only if every handler of the engine inlines them
+ * 
+ */
+struct tos_cache_t
+{
+    double top                          = 0;    // Topmost value of the stack
+    double next                         = 0;    // Value right below the topmost one
+    int count                           = 0;    // Amount of cached values (0, 1 or 2)
+};
+
+/**
+ * @brief Function that pushes the value onto the cached top of the stack (the bottom cached value is spilled into `stack_t` if the cache is full)
+ * 
+ * @param CPU 
+ * @param cache 
+ * @param value 
+ * @param commandIp bytecode offset of the command that pushes
+ * @return EXIT_CODES 
+ */
+static inline __attribute__((always_inline)) EXIT_CODES cpuCachedPush(cpu_t *CPU, tos_cache_t *cache, double value, int commandIp)
+{
+    // Error check
+    if (CPU == NULL || cache == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Spill
+    if (cache->count == 2)
+    {
+        IS_ERROR(cpuPush(CPU, cache->next, commandIp))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+        --cache->count;
+    }
+
+    // Push
+    cache->next = cache->top;
+    cache->top  = value;
+    ++cache->count;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that pops the value from the cached top of the stack (from `stack_t` if the cache is empty)
+ * 
+ * @param CPU 
+ * @param cache 
+ * @param commandIp bytecode offset of the command that pops
+ * @return double 
+ */
+static inline __attribute__((always_inline)) double cpuCachedPop(cpu_t *CPU, tos_cache_t *cache, int commandIp)
+{
+    // Error check
+    if (CPU == NULL || cache == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return BAD_DOUBLE_VALUE;
+    }
+
+    // Pop
+    if (cache->count == 0)
+    {
+        return cpuPop(CPU, commandIp);
+    }
+
+    double result = cache->top;
+    cache->top = cache->next;
+    --cache->count;
+
+    return result;
+}
+
+/**
+ * @brief Function that writes all the cached values back into `stack_t` (before anything that works with `stack_t` directly)
+ * 
+ * @param CPU 
+ * @param cache 
+ * @param commandIp bytecode offset of the command being executed
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuFlushCachedStack(cpu_t *CPU, tos_cache_t *cache, int commandIp)
+{
+    // Error check
+    if (CPU == NULL || cache == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Flush (bottom cached value goes first)
+    if (cache->count == 2)
+    {
+        IS_ERROR(cpuPush(CPU, cache->next, commandIp))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    if (cache->count >= 1)
+    {
+        IS_ERROR(cpuPush(CPU, cache->top, commandIp))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    cache->count = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that extracts the argument value of the verified decoded command (constant RAM address is not checked), the reason of the failure is left in `status.trap`
+ * 
+ * @param CPU 
+ * @param command 
+ * @param result 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuGetVerifiedValue(cpu_t *CPU, const decoded_command_t *command, double *result)
+{
+    // Error check
+    if (CPU == NULL || command == NULL || result == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Constant RAM address is proved by the verifier, computed one is checked as usual
+    if (MRI_IS_MEMORY(command->MRI))
+    {
+        if (command->regs[0] == ZERO_REGISTER && command->regs[1] == ZERO_REGISTER && command->intRegs[0] == ZERO_INT_REGISTER)
+        {
+            const double *cell = ramCell(&CPU->memory, (size_t) command->immediate);
+            if (cell == NULL)
+            {
+                CPU->status.trap = PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX;
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+            *result = ramLoad(cell);
+
+            return EXIT_CODES::NO_ERRORS;
+        }
+
+        return _cpuGetDecodedValue(CPU, command, result);
+    }
+
+    *result = cpuDecodedValue(CPU, command);
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that does the 'mov' action for the verified decoded command (constant RAM address and destination are not checked)
+ * 
+ * @param CPU 
+ * @param command 
+ * @param value 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuMoveVerifiedValue(cpu_t *CPU, const decoded_command_t *command, double value)
+{
+    // Error check
+    if (CPU == NULL || command == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Constant RAM address is proved by the verifier, computed one is checked as usual
+    if (MRI_IS_MEMORY(command->MRI))
+    {
+        if (command->regs[0] == ZERO_REGISTER && command->regs[1] == ZERO_REGISTER && command->intRegs[0] == ZERO_INT_REGISTER)
+        {
+            double *cell = ramCell(&CPU->memory, (size_t) command->immediate);
+            if (cell == NULL)
+            {
+                CPU->status.trap = PROCESSOR_EXIT_CODES::BAD_TO_ACCESS_RAM_INDEX;
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+            ramStore(cell, value);
+
+            return EXIT_CODES::NO_ERRORS;
+        }
+
+        return cpuMoveDecodedValue(CPU, command, value);
+    }
+
+    // `pop` into immediate is rejected by the verifier
+    if (command->intDestination != ZERO_INT_REGISTER)
+    {
+        return cpuMoveIntoIntRegister(CPU, command->intDestination, value);
+    }
+    CPU->commonRegs[command->destination] = value;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Direct-threaded engine: every handler of the decoded command jumps straight to the next one via computed `goto`
+ * 
+ * @tparam tosCaching keep up to two topmost stack values in host registers (flushed into `stack_t` before I/O and exit)
+ * @tparam verified bytecode passed the verifier (jump targets, register destinations and constant RAM addresses are not checked)
+ * @tparam metered the block is charged when the control comes to it by the jump or the return (see `meterDecodedCommands`)
+ * @param CPU 
+ * @param byteCode 
+ * @return EXIT_CODES 
+ */
+template <bool tosCaching, bool verified, bool metered>
+static EXIT_CODES cpuExecuteBytecodeThreaded(cpu_t *CPU, text_t *byteCode)
+{
+    // Error check
+    if (CPU == NULL || byteCode == NULL || CPU->program.commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Dispatch table (opcode -> handler label)
+    void *dispatchTable[DECODED_OPCODES_COUNT] = {};
+    for (int opcode = 0; opcode < DECODED_OPCODES_COUNT; ++opcode)
+    {
+        dispatchTable[opcode] = &&UNKNOWN_OPCODE;
+    }
+    dispatchTable[DECODED_END_OPCODE]       = &&END_OF_PROGRAM;
+    dispatchTable[DECODED_INVALID_OPCODE]   = &&INVALID_COMMAND;
+
+    #define OPDEF(opName, opcode, ...)  dispatchTable[(byte) opcode] = &&OPCODE_##opName;
+        #include "include/opdefs.h"
+    #undef OPDEF
+
+    #define FUSEDEF(fusedName, ...)     dispatchTable[FUSED_OPCODE_##fusedName] = &&FUSED_OPCODE_##fusedName;
+        #include "include/fusedefs.h"
+    #undef FUSEDEF
+
+    // Execution
+    double val              = DEFAULT_DOUBLE_VALUE;
+    double val1             = DEFAULT_DOUBLE_VALUE;
+    double val2             = DEFAULT_DOUBLE_VALUE;
     offset displacement     = 0;
+    long long *intDestination   = NULL;
+    long long intSource         = 0;
+    double *cell                = NULL;
+    tos_cache_t cache       = {};
+    double operand          = DEFAULT_DOUBLE_VALUE;
+
+    const decoded_command_t *commands   = CPU->program.commands;
+    const decoded_command_t *command    = NULL;
+    const int *blockCosts               = CPU->program.blockCosts;
+    const int *jumpCosts                = CPU->program.jumpCosts;
+    int jumpCost                        = 0;
+    int ip                              = CPU->program.commandIndex[CPU->ip];   // Index of the next decoded command
+
+    #define DISPATCH()                                  \
+        command = &commands[ip++];                      \
+        goto *dispatchTable[command->handler]
+
+    // Decoded commands microcode helpers (`switch` engine ones are defined by the first `opdefs.h` inclusion)
+    #undef IP
+    #undef PUSH
+    #undef POP
+    #undef OUT
+    #undef OUTC
+    #undef IN
+    #undef HALT
+    #undef TRAP
+    #undef GET_VALUE
+    #undef GET_OFFSET
+    #undef MOVE_VALUE
+    #undef GET_INT_OPERAND
+    #undef JUMP
+    #undef SKIP_OFFSET
+    #undef RETURN_ADDRESS
+    #undef RETURN_TO
+    #undef IS_RETURN_ADDRESS
+    #undef CALL_PUSH
+    #undef CALL_POP
+    #undef SPAWN
+
+    #define REDEFINE_VALUES
+    #define REDEFINE_HELPERS
+
+    #define IP                      ip
+
+    #define FLUSH_STACK()           (tosCaching ? cpuFlushCachedStack(CPU, &cache, (int) command->address) : EXIT_CODES::NO_ERRORS)
+    #define PUSH(value)             (tosCaching ? cpuCachedPush(CPU, &cache, (double) (value), (int) command->address)  \
+                                                : cpuPush(CPU, (double) (value), (int) command->address))
+    #define POP()                   (tosCaching ? cpuCachedPop(CPU, &cache, (int) command->address) : cpuPop(CPU, (int) command->address))
+    #define OUT()                   outputDouble(&CPU->output, POP())               // Cached top of the stack is printed as is
+    #define OUTC()                  outputChar(&CPU->output, (char) (int) POP())
+    #define IN()                    PUSH(cpuInput(CPU))
+    #define HALT(exitCode)          FLUSH_STACK(); cpuHalt(CPU, exitCode)
+    #define TRAP(reason)            TRAP_OF(0, reason)  // Start of the superinstruction
+    #define TRAP_OF(index, reason)  (FLUSH_STACK(), cpuTrap(CPU, reason, (int) command[index].address))
+
+    #define GET_VALUE()             GET_VALUE_OF(0)
+    #define GET_OFFSET()            GET_OFFSET_OF(0)
+    #define MOVE_VALUE(value)       MOVE_VALUE_OF(0, value)
+    #define GET_INT_OPERAND()       intDestination  = &CPU->intRegs[command->intDestination];                  \
+                                    intSource       = CPU->intRegs[command->intRegs[0]] + command->intImmediate
+
+    #define CHARGE_BLOCK()          if (metered)                                                                    \
+                                    {                                                                               \
+                                        if (CPU->budgetLeft < (unsigned long long) blockCosts[IP])                  \
+                                        {                                                                           \
+                                            goto BUDGET_IS_EXHAUSTED;                                               \
+                                        }                                                                           \
+                                        CPU->budgetLeft -= (unsigned long long) blockCosts[IP];                     \
+                                    }
+    #define CHARGE_JUMP()           if (metered)                                                                    \
+                                    {                                                                               \
+                                        jumpCost = jumpCosts[command - commands];                                   \
+                                        if (jumpCost > 0 && CPU->budgetLeft < (unsigned long long) jumpCost)        \
+                                        {                                                                           \
+                                            CPU->budgetLeft += (unsigned long long) (blockCosts[IP] - jumpCost);    \
+                                            goto BUDGET_IS_EXHAUSTED;                                               \
+                                        }                                                                           \
+                                        CPU->budgetLeft -= (unsigned long long) jumpCost;                           \
+                                    }
+
+    #define JUMP(destination)       IP = destination; CHARGE_JUMP()
+    #define SKIP_OFFSET()
+    #define RETURN_ADDRESS()        command->nextAddress
+    #define RETURN_TO(address)      IP = CPU->program.commandIndex[address]; CHARGE_BLOCK()    // Only `call` writes the call stack, `vret` checks the address
+    #define IS_RETURN_ADDRESS(value)    cpuIsDecodedReturnAddress(CPU, value)
+    #define CALL_PUSH(returnAddress) if (CPU->callDepth >= CPU->callStackCapacity)                                   \
+                                    {                                                                               \
+                                        FLUSH_STACK();  /* Growing may trap */                                      \
+                                    }                                                                               \
+                                    cpuCallPush(CPU, returnAddress, (int) command->address)
+    #define CALL_POP()              ((CPU->callDepth > 0 ? (void) 0 : (void) TRAP(PROCESSOR_EXIT_CODES::CALL_STACK_UNDERFLOW)),  \
+                                     cpuCallPop(CPU, (int) command->address))
+    #define SPAWN(target)           smpSpawn(CPU, commands[target].address)   // Cores start at the bytecode offset
+
+    #define GET_VALUE_OF(index)             (!MRI_IS_MEMORY(command[index].MRI) ? cpuDecodedValue(CPU, command + (index))        \
+                                            : ((verified ? cpuGetVerifiedValue(CPU, command + (index), &operand)                \
+                                                         : _cpuGetDecodedValue(CPU, command + (index), &operand))               \
+                                               == EXIT_CODES::NO_ERRORS) ? operand : (TRAP_OF(index, CPU->status.trap), operand))
+    #define MOVE_VALUE_OF(index, value)     (((verified ? cpuMoveVerifiedValue(CPU, command + (index), value)                   \
+                                                        : cpuMoveDecodedValue(CPU, command + (index), value))                   \
+                                              == EXIT_CODES::NO_ERRORS) ? (void) 0 : (void) TRAP_OF(index, CPU->status.trap))
+    #define GET_OFFSET_OF(index)            ((verified || command[index].target != BAD_TARGET) ? command[index].target          \
+                                                      : (TRAP_OF(index, PROCESSOR_EXIT_CODES::ERROR_DURING_JUMP), BAD_TARGET))
+    #define COMPARE(result, first, second)                                                              \
+        result = fabs(first - second) < EPS ? DOUBLES_ARE_EQUAL                                         \
+                                            : (first > second ? FIRST_DOUBLE_IS_GREATER : FIRST_DOUBLE_IS_LOWER)
+
+    #define OPDEF(opName, opcode, argc, argType, code, ...)     \
+        OPCODE_##opName: ++CPU->stats.commands; { code } DISPATCH();
+
+    #define FUSEDEF(fusedName, sequenceLength, pattern, code, ...)  \
+        FUSED_OPCODE_##fusedName:                                   \
+            CPU->stats.commands         += sequenceLength;          \
+            CPU->stats.fusedCommands    += sequenceLength - 1;      \
+            IP += sequenceLength - 1;                               \
+            { code } DISPATCH();
+
+    if (ip == BAD_TARGET)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DURING_JUMP);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+    command = &commands[ip];    // Stack is flushed at it if the run is paused before the first dispatch
+
+    CHARGE_BLOCK();
+    DISPATCH();
+
+        #include "include/opdefs.h"
+        #include "include/fusedefs.h"
+
+    #undef FUSEDEF
+    #undef OPDEF
+    #undef COMPARE
+    #undef GET_OFFSET_OF
+    #undef MOVE_VALUE_OF
+    #undef GET_VALUE_OF
+    #undef TRAP_OF
+    #undef DISPATCH
+    #undef REDEFINE_VALUES
+    #undef REDEFINE_HELPERS
+    #undef CHARGE_JUMP
+    #undef CHARGE_BLOCK
+
+END_OF_PROGRAM:
+    CPU->ip = (int) command->address;
+    FLUSH_STACK();
+    return EXIT_CODES::NO_ERRORS;
+
+BUDGET_IS_EXHAUSTED:
+    CPU->ip             = (int) commands[ip].address;
+    CPU->status.state   = CPU_STATES::BUDGET_IS_EXHAUSTED;
+    CPU->status.ip      = CPU->ip;
+    FLUSH_STACK();
+    return EXIT_CODES::NO_ERRORS;
+
+INVALID_COMMAND:
+    CPU->ip = (int) command->address;
+    FLUSH_STACK();
+    PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::INVALID_DECODED_COMMAND);
+    cpuTrap(CPU, PROCESSOR_EXIT_CODES::INVALID_DECODED_COMMAND, CPU->ip);
+
+UNKNOWN_OPCODE:
+    CPU->ip = (int) command->address;
+    FLUSH_STACK();
+    PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_OPCODE_BYTE);
+    cpuTrap(CPU, PROCESSOR_EXIT_CODES::UNKNOWN_OPCODE_BYTE, CPU->ip);
+
+    #undef FLUSH_STACK
+}
+
+#endif
+
+/**
+ * @brief Callback of the native code for `in` command
+ * 
+ * @param state 
+ */
+static void cpuJitIn(jit_state_t *state)
+{
+    cpu_t *CPU = (cpu_t *) state->context;
+
+    *state->sp++ = cpuInput(CPU);
+}
+
+/**
+ * @brief Callback of the native code for `out` command
+ * 
+ * @param state 
+ */
+static void cpuJitOut(jit_state_t *state)
+{
+    cpu_t *CPU = (cpu_t *) state->context;
+
+    IS_OK_WO_EXIT(outputDouble(&CPU->output, *--state->sp));
+}
+
+/**
+ * @brief Callback of the native code for `outc` command
+ * 
+ * @param state 
+ */
+static void cpuJitOutc(jit_state_t *state)
+{
+    cpu_t *CPU = (cpu_t *) state->context;
+
+    IS_OK_WO_EXIT(outputChar(&CPU->output, (char) (int) *--state->sp));
+}
+
+#if RAM_GUARD_SUPPORTED
+
+/**
+ * @brief Fault resolver of the guarded RAM (see `ram_fault_resolver_t`)
+ * 
+ * @param instruction 
+ * @param context 
+ * @return const void* 
+ */
+static const void *cpuJitResolveFault(const void *instruction, void *context)
+{
+    return jitResolveFault(&((cpu_t *) context)->jit, instruction);
+}
+
+#endif
+
+/**
+ * @brief Function that gives the processor stack to the native code as its operand stack (the call stack is shared, only its depth is copied)
+ * 
+ * The buffer of the processor stack is shared, so the entry is O(1) whatever the depth of the stack is. The paranoid stack
+ * keeps its canaries and checksum, so it is moved into the separate buffer instead
+ * 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuJitLoadStack(cpu_t *CPU)
+{
+    // Error check
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    jit_state_t *state = &CPU->jitState;
+    state->callDepth = CPU->callDepth;
+
+    // Shared buffer (at least JIT_STACK_RESERVE free slots)
+    if (!CPU->paranoid)
+    {
+        while (CPU->stack.capacity - CPU->stack.size < JIT_STACK_RESERVE)
+        {
+            IS_ERROR(stackReallocation(&CPU->stack, REALLOC_MODES::INCREASE))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+        }
+
+        state->stackBase    = CPU->stack.data;
+        state->sp           = CPU->stack.data + CPU->stack.size;
+        state->stackLimit   = CPU->stack.data + CPU->stack.capacity;
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    size_t size     = (size_t) CPU->paranoidStack.size;
+    size_t capacity = (size_t) (state->stackLimit - state->stackBase);
+
+    // Reallocation (at least JIT_STACK_RESERVE free slots)
+    if (capacity < size + JIT_STACK_RESERVE)
+    {
+        size_t newCapacity = 2 * capacity > size + JIT_STACK_RESERVE ? 2 * capacity : size + JIT_STACK_RESERVE;
+        double *newStack = (double *) realloc(state->stackBase, newCapacity * sizeof(double));
+        CHECK_CALLOC_RESULT(newStack);
+
+        state->stackBase    = newStack;
+        state->stackLimit   = newStack + newCapacity;
+    }
+
+    // Move
+    for (size_t element = size; element > 0; --element)
+    {
+        state->stackBase[element - 1] = cpuPop(CPU, CPU->ip);
+    }
+    state->sp = state->stackBase + size;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that takes the operand stack of the native code back as the processor stack
+ * 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuJitStoreStack(cpu_t *CPU)
+{
+    // Error check
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    jit_state_t *state = &CPU->jitState;
+    CPU->callDepth = state->callDepth;
+
+    // Shared buffer
+    if (!CPU->paranoid)
+    {
+        CPU->stack.size = (int) (state->sp - state->stackBase);
+
+        state->stackBase    = NULL;
+        state->sp           = NULL;
+        state->stackLimit   = NULL;
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Move
+    for (const double *element = state->stackBase; element < state->sp; ++element)
+    {
+        IS_ERROR(cpuPush(CPU, *element, CPU->ip))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    state->sp = state->stackBase;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that executes the bytecode with the native code of its basic blocks or hot loops (the other commands are interpreted)
+ * 
+ * @param CPU 
+ * @param byteCode 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuExecuteBytecodeJit(cpu_t *CPU, text_t *byteCode)
+{
+    // Error check
+    if (CPU == NULL || byteCode == NULL || CPU->program.commands == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
 
-    byte opcode = (byte) byteCode->data[CPU->ip++];    
-    switch(opcode)
+    // State shared with the native code
+    jit_state_t *state  = &CPU->jitState;
+    state->regs         = CPU->commonRegs;
+    state->intRegs      = CPU->intRegs;
+    state->flags        = &CPU->flags;
+    state->callStack    = CPU->callStack;
+    state->maxCallDepth = CPU->maxCallDepth;
+    state->RAM          = CPU->RAM;
+    state->tlb          = CPU->memory.tlb;
+    state->RAMSize      = CPU->RAMSize;
+    state->entries      = CPU->jit.entries;
+    state->eps          = EPS;
+    state->in           = cpuJitIn;
+    state->out          = cpuJitOut;
+    state->outc         = cpuJitOutc;
+    state->context      = CPU;
+
+    // Out of range RAM index of the native code faults in the guard region (the command is exited to the interpreter)
+    #if RAM_GUARD_SUPPORTED
+        if (CPU->jit.ramGuarded)
+        {
+            IS_ERROR(ramTrapCtor(&CPU->memory, cpuJitResolveFault, CPU))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(MEMORY_EXIT_CODES::ERROR_SETTING_TRAP_HANDLER);
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+        }
+    #endif
+
+    // Execution
+    bool tracing = CPU->engine == CPU_ENGINES::TRACING && CPU->jit.blockEntries != NULL;
+    while ((size_t) CPU->ip < byteCode->size)
     {
-        #include "include/opdefs.h"
+        int command = CPU->program.commandIndex[CPU->ip];
 
-        default:
-            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_OPCODE_BYTE);
+        // Recorded trace ends when the loop is closed or the native code is reached
+        jit_recorder_t *recorder = &CPU->recorder;
+        if (tracing && recorder->head != NOT_RECORDING && recorder->length > 0 && command != BAD_TARGET &&
+            (command == recorder->head || CPU->jit.blockEntries[command] != NULL))
+        {
+            IS_OK_WO_EXIT(jitFinishTrace(&CPU->jit, recorder, &CPU->program, command));
+        }
+
+        const void *code = (CPU->jit.blockEntries != NULL && command != BAD_TARGET) ? CPU->jit.blockEntries[command] : NULL;
+        if (code != NULL)
+        {
+            IS_ERROR(cpuJitLoadStack(CPU))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_POPPING_VALUE_FROM_STACK);
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            state->commands = 0;
+            command = CPU->jit.enter(state, code);
+            CPU->stats.commands         += state->commands;
+            CPU->stats.nativeCommands   += state->commands;
+
+            IS_ERROR(cpuJitStoreStack(CPU))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_PUSHING_VALUE_TO_STACK);
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            CPU->ip = (int) CPU->program.commands[command].address;
+            if ((size_t) CPU->ip >= byteCode->size)
+            {
+                break;
+            }
+
+            // The command the native code exited to is interpreted (its own native code would exit again on a TLB miss)
+            if (tracing)
+            {
+                IS_OK_WO_EXIT(jitRecordSideExit(recorder, &CPU->jit, command));
+            }
+        }
+
+        // Command without native code
+        int stackSize = CPU->paranoid ? CPU->paranoidStack.size : CPU->stack.size;
+        ++CPU->stats.commands;
+        IS_ERROR(cpuExecuteCommand(CPU, byteCode))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
             return EXIT_CODES::BAD_OBJECT_PASSED;
-    } 
+        }
+
+        if (tracing)
+        {
+            bool popped = (CPU->paranoid ? CPU->paranoidStack.size : CPU->stack.size) < stackSize;
+            IS_OK_WO_EXIT(jitRecordCommand(recorder, &CPU->jit, &CPU->program, command, CPU->ip, popped, CPU->flags));
+        }
+    }
+
+    #if RAM_GUARD_SUPPORTED
+        IS_OK_WO_EXIT(ramTrapDtor());
+    #endif
 
     return EXIT_CODES::NO_ERRORS;
 }
 
-#undef OPDEF
+/**
+ * @brief Function that executes the bytecode (`switch` engine) while the budget pays for its blocks, the run is paused at the first unpaid one
+ * 
+ * The block is charged when the control comes to it, the rest of it is given back when its branch is taken (the decoded program
+ * is not fused, so the block is the commands that follow each other in the bytecode)
+ * 
+ * @param CPU 
+ * @param byteCode 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuExecuteBytecodeMetered(cpu_t *CPU, text_t *byteCode)
+{
+    // Error check
+    if (CPU == NULL || byteCode == NULL || CPU->program.blockCosts == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Execution
+    const int *blockCosts   = CPU->program.blockCosts;
+    int command             = BAD_TARGET;       // Index of the command of the charged block (BAD_TARGET after the control is transferred)
+    while ((size_t) CPU->ip < byteCode->size)
+    {
+        if (command == BAD_TARGET)
+        {
+            command = CPU->program.commandIndex[CPU->ip];
+            if (command == BAD_TARGET)
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DURING_JUMP);
+                cpuTrap(CPU, PROCESSOR_EXIT_CODES::ERROR_DURING_JUMP, CPU->ip);
+            }
+
+            if (CPU->budgetLeft < (unsigned long long) blockCosts[command])
+            {
+                CPU->status.state   = CPU_STATES::BUDGET_IS_EXHAUSTED;
+                CPU->status.ip      = CPU->ip;
+                return EXIT_CODES::NO_ERRORS;
+            }
+            CPU->budgetLeft -= (unsigned long long) blockCosts[command];
+        }
+
+        ++CPU->stats.commands;
+        IS_ERROR(cpuExecuteCommand(CPU, byteCode))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        // The last command of the block costs 1, the taken branch leaves the rest of the block
+        if (blockCosts[command] == 1)
+        {
+            command = BAD_TARGET;
+        }
+        else if (CPU->ip != (int) CPU->program.commands[command].nextAddress)
+        {
+            CPU->budgetLeft += (unsigned long long) blockCosts[command + 1];
+            command = BAD_TARGET;
+        }
+        else
+        {
+            ++command;
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
 
 /**
- * @brief Main function that executes bytecode file
+ * @brief Function that decodes the bytecode for the engine of the virtual CPU (and translates it into native code) unless it is done already
  * 
  * @param byteCode 
  * @param CPU 
  * @return EXIT_CODES 
  */
-EXIT_CODES cpuExecuteBytecode(text_t *byteCode, cpu_t *CPU)
+EXIT_CODES cpuLoadProgram(text_t *byteCode, cpu_t *CPU)
 {
     // Error check
     if (byteCode == NULL || CPU == NULL)
@@ -676,12 +2113,147 @@ EXIT_CODES cpuExecuteBytecode(text_t *byteCode, cpu_t *CPU)
         PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
         return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
     }
-    
+
+    // `switch` engine executes the bytecode as it is (the metered one looks up the costs of the blocks)
+    if ((CPU->engine == CPU_ENGINES::SWITCH && CPU->budget == 0) || CPU->program.commands != NULL)
+    {
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    IS_ERROR(decodedProgramCtor(&CPU->program, byteCode))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DECODING_BYTECODE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Superinstructions and the costs of the blocks (they follow the handlers)
+    if (CPU->engine == CPU_ENGINES::SWITCH || CPU->engine == CPU_ENGINES::THREADED)
+    {
+        if (CPU->engine == CPU_ENGINES::THREADED && CPU->fusion)
+        {
+            IS_OK_WO_EXIT(fuseDecodedCommands(&CPU->program));
+        }
+
+        if (CPU->budget != 0)
+        {
+            IS_ERROR(meterDecodedCommands(&CPU->program))
+            {
+                PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_STD_FUNC_RESULT);
+                return EXIT_CODES::BAD_STD_FUNC_RESULT;
+            }
+        }
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // Native code (the commands without it are interpreted)
+    CPU->jit.ramGuarded = CPU->memory.guarded;
+    CPU->jit.ramPaged   = CPU->RAMBackend == RAM_BACKENDS::PAGED;
+    if (CPU->engine == CPU_ENGINES::JIT)
+    {
+        IS_ERROR(jitCtor(&CPU->jit, &CPU->program))
+        {
+            IS_OK_WO_EXIT(jitDtor(&CPU->jit));
+        }
+    }
+    else
+    {
+        IS_ERROR(jitRecorderCtor(&CPU->recorder, &CPU->program))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_STD_FUNC_RESULT);
+            return EXIT_CODES::BAD_STD_FUNC_RESULT;
+        }
+
+        IS_ERROR(jitTracesCtor(&CPU->jit, &CPU->program))
+        {
+            IS_OK_WO_EXIT(jitDtor(&CPU->jit));
+        }
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that executes the loaded program from `ip` by the engine of the virtual CPU, `halt` and the runtime errors leave it via `exitPoint`
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuExecuteEngine(text_t *byteCode, cpu_t *CPU)
+{
+    // Threaded execution
+    if (CPU->engine == CPU_ENGINES::THREADED)
+    {
+        #if defined(__GNUC__)
+            EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+            if (CPU->budget != 0)
+            {
+                exitCode = CPU->verified ? (CPU->tosCaching ? cpuExecuteBytecodeThreaded<true, true, true>(CPU, byteCode)
+                                                            : cpuExecuteBytecodeThreaded<false, true, true>(CPU, byteCode))
+                                         : (CPU->tosCaching ? cpuExecuteBytecodeThreaded<true, false, true>(CPU, byteCode)
+                                                            : cpuExecuteBytecodeThreaded<false, false, true>(CPU, byteCode));
+            }
+            else if (CPU->verified)
+            {
+                exitCode = CPU->tosCaching ? cpuExecuteBytecodeThreaded<true, true, false>(CPU, byteCode)
+                                           : cpuExecuteBytecodeThreaded<false, true, false>(CPU, byteCode);
+            }
+            else
+            {
+                exitCode = CPU->tosCaching ? cpuExecuteBytecodeThreaded<true, false, false>(CPU, byteCode)
+                                           : cpuExecuteBytecodeThreaded<false, false, false>(CPU, byteCode);
+            }
+
+            IS_ERROR(exitCode)
+            {
+                PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            return EXIT_CODES::NO_ERRORS;
+        #else
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_EXECUTION_ENGINE);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        #endif
+    }
+
+    // Metered execution (the native code is not metered)
+    if (CPU->budget != 0)
+    {
+        if (CPU->engine != CPU_ENGINES::SWITCH)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_EXECUTION_ENGINE);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        IS_ERROR(cpuExecuteBytecodeMetered(CPU, byteCode))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
+    // JIT execution (falls back to the interpreter for everything that is not compiled)
+    if (CPU->engine == CPU_ENGINES::JIT || CPU->engine == CPU_ENGINES::TRACING)
+    {
+        IS_ERROR(cpuExecuteBytecodeJit(CPU, byteCode))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        return EXIT_CODES::NO_ERRORS;
+    }
+
     // Execution
     // char chr = 0;
     while ((size_t) CPU->ip < byteCode->size)
     {
         // cpuDump(CPU, byteCode);
+        ++CPU->stats.commands;
         IS_ERROR(cpuExecuteCommand(CPU, byteCode))
         {
             PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
@@ -692,3 +2264,215 @@ EXIT_CODES cpuExecuteBytecode(text_t *byteCode, cpu_t *CPU)
 
     return EXIT_CODES::NO_ERRORS;
 }
+
+/**
+ * @brief Main function that executes bytecode file from `ip` until the run stops, `halt` and the runtime errors stop the run only (see `status`)
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteBytecode(text_t *byteCode, cpu_t *CPU)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    
+    CPU->stats.startTime = clock();
+
+    // Decoding (and translation) is done once
+    IS_ERROR(cpuLoadProgram(byteCode, CPU))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DECODING_BYTECODE);
+        CPU->status.state   = CPU_STATES::TRAPPED;
+        CPU->status.trap    = PROCESSOR_EXIT_CODES::ERROR_DECODING_BYTECODE;
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // The run is halted unless the engine stops it otherwise (nothing is changed between `setjmp` and `longjmp` but the fields of the processor)
+    CPU->status = {};
+    jmp_buf exitPoint;
+    CPU->exitPoint = &exitPoint;
+    if (setjmp(exitPoint) == 0)
+    {
+        IS_ERROR(cpuExecuteEngine(byteCode, CPU))
+        {
+            CPU->status.state   = CPU_STATES::TRAPPED;
+            CPU->status.trap    = PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED;
+        }
+    }
+    CPU->exitPoint = NULL;
+
+    // `cpuTrap` may be called while the fault handler of the native code is set
+    #if RAM_GUARD_SUPPORTED
+        IS_OK_WO_EXIT(ramTrapDtor());
+    #endif
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that maps the status of the last run to the exit code of the process (and of the record of the batch)
+ * 
+ * @param CPU 
+ * @return int 
+ */
+int cpuGetExitCode(const cpu_t *CPU)
+{
+    // Error check
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_FAILURE;
+    }
+
+    switch (CPU->status.state)
+    {
+        case CPU_STATES::HALTED:                return CPU->status.exitCode;
+        case CPU_STATES::BUDGET_IS_EXHAUSTED:   return BUDGET_EXHAUSTED_EXIT_CODE;
+        case CPU_STATES::TRAPPED:
+        case CPU_STATES::WAITING_FOR_INPUT:
+        default:                                return EXIT_FAILURE;
+    }
+}
+
+/**
+ * @brief Function that resets the virtual CPU to the state of a new one in place (the decoded program and the native code are kept)
+ * 
+ * @param CPU 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuReset(cpu_t *CPU)
+{
+    // Error check
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Stack (its memory is kept)
+    while ((CPU->paranoid ? CPU->paranoidStack.size : CPU->stack.size) > 0)
+    {
+        if ((CPU->paranoid ? stackPop(&CPU->paranoidStack) : stackPop(&CPU->stack)) != EXIT_CODES::NO_ERRORS)
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_POPPING_VALUE_FROM_STACK);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+
+    // RAM (unless it is shared) and VRAM
+    if (CPU->ownsMemory)
+    {
+        IS_ERROR(ramClear(&CPU->memory))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+    memset(CPU->VRAM, 0, MAX_VRAM_SIZE * sizeof(byte));
+
+    // Registers
+    memset(CPU->commonRegs, 0, sizeof(CPU->commonRegs));
+    memset(CPU->intRegs, 0, sizeof(CPU->intRegs));
+    CPU->flags      = 0;
+    CPU->ip         = 0;
+    CPU->callDepth  = 0;
+    CPU->status     = {};
+
+    // Budget
+    CPU->budgetLeft = CPU->budget;
+
+    // Trace that was being recorded belongs to the previous run (hot loop counters are kept)
+    CPU->recorder.head      = NOT_RECORDING;
+    CPU->recorder.length    = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that executes at most `quantum` commands from `ip`, `halt` and the runtime errors leave it via `exitPoint`
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param quantum 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES cpuExecuteSliceCommands(text_t *byteCode, cpu_t *CPU, unsigned long long quantum)
+{
+    for (unsigned long long command = 0; command < quantum; ++command)
+    {
+        if ((size_t) CPU->ip >= byteCode->size)
+        {
+            return EXIT_CODES::NO_ERRORS;
+        }
+
+        ++CPU->stats.commands;
+        IS_ERROR(cpuExecuteCommand(CPU, byteCode))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED);
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        // `in` pushed nothing, so it is executed again from the start
+        if (CPU->isWaitingForInput)
+        {
+            CPU->isWaitingForInput  = false;
+            CPU->ip                 = CPU->status.ip;
+            CPU->status.state       = CPU_STATES::WAITING_FOR_INPUT;
+            --CPU->stats.commands;
+            return EXIT_CODES::NO_ERRORS;
+        }
+    }
+
+    // The quantum is the budget of the slice
+    CPU->status.state   = CPU_STATES::BUDGET_IS_EXHAUSTED;
+    CPU->status.ip      = CPU->ip;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that executes at most `quantum` commands of the bytecode from `ip` (`switch` engine), the next slice goes on from there
+ * 
+ * Every field of the run is in the processor (the `switch` engine keeps nothing in the host registers between the commands),
+ * so the slice is left and resumed without saving anything. The slice that used its quantum is BUDGET_IS_EXHAUSTED (see `status`)
+ * 
+ * @param byteCode 
+ * @param CPU 
+ * @param quantum 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteSlice(text_t *byteCode, cpu_t *CPU, unsigned long long quantum)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (CPU->engine != CPU_ENGINES::SWITCH)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::UNKNOWN_EXECUTION_ENGINE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Nothing is changed between `setjmp` and `longjmp` but the fields of the processor
+    CPU->status = {};
+    jmp_buf exitPoint;
+    CPU->exitPoint = &exitPoint;
+    if (setjmp(exitPoint) == 0)
+    {
+        IS_ERROR(cpuExecuteSliceCommands(byteCode, CPU, quantum))
+        {
+            CPU->status.state   = CPU_STATES::TRAPPED;
+            CPU->status.trap    = PROCESSOR_EXIT_CODES::BAD_BYTECODE_PASSED;
+        }
+    }
+    CPU->exitPoint = NULL;
+
+    return EXIT_CODES::NO_ERRORS;
+}
@@ -0,0 +1,184 @@
+#include <stdlib.h>     // for calloc, free
+#include <thread>       // for std::this_thread::yield
+
+#include "include/processor/ring.h"
+#include "include/processor/settings.h"
+
+/**
+ * @brief Function that allocates the ring of at least `capacity` values (it is rounded up to a power of 2)
+ * 
+ * @param ring 
+ * @param capacity 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ringCtor(ring_t *ring, size_t capacity)
+{
+    // Error check
+    if (ring == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (capacity == 0)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_OBJECT_PASSED);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Values (indices are masked instead of the division)
+    size_t roundedCapacity = 1;
+    while (roundedCapacity < capacity)
+    {
+        roundedCapacity <<= 1;
+    }
+
+    ring->values = (double *) calloc(roundedCapacity, sizeof(double));
+    if (ring->values == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(RING_EXIT_CODES::ERROR_ALLOCATING_RING);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+    ring->capacity = roundedCapacity;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that frees the values of the ring (neither side may use it anymore)
+ * 
+ * @param ring 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES ringDtor(ring_t *ring)
+{
+    // Error check
+    if (ring == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    free(ring->values);
+    ring->values    = NULL;
+    ring->capacity  = 0;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that wakes up the parked side of the ring
+ * 
+ * The mutex is taken, so the side that checked its condition under it is either waiting already or sees the change
+ * 
+ * @param ring 
+ */
+void ringWake(ring_t *ring)
+{
+    std::lock_guard<std::mutex> guard(ring->lock);
+    ring->isChanged.notify_all();
+}
+
+/**
+ * @brief Function that marks the end of the values (producer side) and wakes the consumer up
+ * 
+ * @param ring 
+ */
+void ringClose(ring_t *ring)
+{
+    ring->isClosed.store(true, std::memory_order_seq_cst);
+    ringWake(ring);
+}
+
+/**
+ * @brief Function that makes the producer drop the values (consumer side) and wakes it up
+ * 
+ * @param ring 
+ */
+void ringAbandon(ring_t *ring)
+{
+    ring->isAbandoned.store(true, std::memory_order_seq_cst);
+    ringWake(ring);
+}
+
+/**
+ * @brief Function that waits until the full ring has room (producer side), the parked producer waits for half of the ring
+ * 
+ * The consumer is given RING_SPIN_COUNT chances to pop before the producer is parked. The parked one is woken up when half
+ * of the ring is free, so it pushes values by batches instead of parking after every one
+ * 
+ * @param ring 
+ * @return true the value may be pushed
+ * @return false the ring is abandoned
+ */
+bool ringWaitForRoom(ring_t *ring)
+{
+    size_t tail = ring->tail.load(std::memory_order_relaxed);
+    for (int spin = 0; spin < RING_SPIN_COUNT; ++spin)
+    {
+        if (ring->isAbandoned.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        std::this_thread::yield();
+        ring->cachedHead = ring->head.load(std::memory_order_seq_cst);
+        if (tail - ring->cachedHead < ring->capacity)
+        {
+            return true;
+        }
+    }
+
+    // Park (the flag is set before `head` is checked again, see `ringPop`)
+    ++ring->fullWaitsCount;
+    std::unique_lock<std::mutex> lock(ring->lock);
+    ring->isProducerParked.store(true, std::memory_order_seq_cst);
+    ring->isChanged.wait(lock, [ring, tail]
+    {
+        ring->cachedHead = ring->head.load(std::memory_order_seq_cst);
+        return tail - ring->cachedHead <= ring->capacity / 2 || ring->isAbandoned.load(std::memory_order_seq_cst);
+    });
+    ring->isProducerParked.store(false, std::memory_order_relaxed);
+
+    return !ring->isAbandoned.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Function that waits until the empty ring has a value (consumer side)
+ * 
+ * The producer is given RING_SPIN_COUNT chances to push before the consumer is parked
+ * 
+ * @param ring 
+ * @return true the value may be popped
+ * @return false the ring is closed and empty
+ */
+bool ringWaitForValue(ring_t *ring)
+{
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    for (int spin = 0; spin < RING_SPIN_COUNT; ++spin)
+    {
+        // `tail` is read after `isClosed`, so it has the last value pushed
+        bool isClosed = ring->isClosed.load(std::memory_order_seq_cst);
+        ring->cachedTail = ring->tail.load(std::memory_order_seq_cst);
+        if (head != ring->cachedTail || isClosed)
+        {
+            return head != ring->cachedTail;
+        }
+
+        std::this_thread::yield();
+    }
+
+    // Park (the flag is set before `tail` is checked again, see `ringPush`)
+    ++ring->emptyWaitsCount;
+    std::unique_lock<std::mutex> lock(ring->lock);
+    ring->isConsumerParked.store(true, std::memory_order_seq_cst);
+    bool isClosed = false;
+    ring->isChanged.wait(lock, [ring, head, &isClosed]
+    {
+        isClosed = ring->isClosed.load(std::memory_order_seq_cst);
+        ring->cachedTail = ring->tail.load(std::memory_order_seq_cst);
+        return head != ring->cachedTail || isClosed;
+    });
+    ring->isConsumerParked.store(false, std::memory_order_relaxed);
+
+    return head != ring->cachedTail;
+}
@@ -0,0 +1,339 @@
+#include <string.h>     // for memcpy
+#include <new>          // for std::nothrow
+#include <system_error> // for std::system_error
+
+#include "libs/colors/colors.h"
+
+#include "include/processor/smp.h"
+#include "include/processor/settings.h"
+
+/**
+ * @brief Function that constructs the virtual CPU of the core: settings, the decoded program and the RAM are taken from `CPU`
+ * 
+ * The TRACING engine records and compiles the traces while it runs, so every core decodes the program for itself
+ * 
+ * @param core 
+ * @param CPU 
+ * @param smp 
+ * @param coreId 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES smpCoreCpuCtor(cpu_t *core, const cpu_t *CPU, smp_t *smp, int coreId)
+{
+    // Error check
+    if (core == NULL || CPU == NULL || smp == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Settings
+    core->RAMSize           = CPU->RAMSize;
+    core->RAMBackend        = CPU->RAMBackend;
+    core->hugePages         = CPU->hugePages;
+    core->outputFormat      = CPU->outputFormat;
+    core->inputFormat       = CPU->inputFormat;
+    core->maxCallDepth      = CPU->maxCallDepth;
+    core->engine            = CPU->engine;
+    core->paranoid          = CPU->paranoid;
+    core->verify            = CPU->verify;
+    core->verified          = CPU->verified;
+    core->fusion            = CPU->fusion;
+    core->tosCaching        = CPU->tosCaching;
+    core->stats.enabled     = CPU->stats.enabled;
+    core->smp               = smp;
+    core->coreId            = coreId;
+
+    // RAM of the machine
+    core->ownsMemory    = false;
+    core->memory        = CPU->memory;
+
+    // Decoded program and native code
+    core->ownsProgram = CPU->engine == CPU_ENGINES::TRACING;
+    if (!core->ownsProgram)
+    {
+        core->program   = CPU->program;
+        core->jit       = CPU->jit;
+    }
+
+    IS_ERROR(cpuCtor(core))
+    {
+        return EXIT_CODES::CONSTRUCTOR_ERROR;
+    }
+
+    // Only the first core reads the input
+    return inputRecord(&core->input, NULL, 0);
+}
+
+/**
+ * @brief Function of the host thread of the core: runs the core every time it is spawned until the machine is shut down
+ * 
+ * @param smp 
+ * @param core 
+ */
+static void smpCore(smp_t *smp, smp_core_t *core)
+{
+    std::unique_lock<std::mutex> lock(smp->lock);
+    for (;;)
+    {
+        core->isSpawned.wait(lock, [smp, core] { return core->isStarting || smp->isShutDown; });
+        if (!core->isStarting)
+        {
+            break;
+        }
+        core->isStarting = false;
+        lock.unlock();
+
+        // Run (its output is written before `join` returns)
+        IS_OK_WO_EXIT(cpuExecuteBytecode(smp->byteCode, &core->CPU));
+        IS_OK_WO_EXIT(outputFlush(&core->CPU.output));
+
+        lock.lock();
+        core->state = SMP_CORE_STATES::HALTED;
+        smp->failedRunsCount    += cpuGetExitCode(&core->CPU) != EXIT_SUCCESS;
+        smp->runningCoresCount  -= 1;
+        smp->coreIsHalted.notify_all();
+    }
+}
+
+/**
+ * @brief Function that starts the free core at `address` with a copy of the registers of `CPU` (`spawn` command)
+ * 
+ * @param CPU 
+ * @param address bytecode offset of the first command of the core
+ * @return double index of the core, SMP_NO_CORE if every core is busy (or the processor is not a part of the machine)
+ */
+double smpSpawn(cpu_t *CPU, offset address)
+{
+    // Error check
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return SMP_NO_CORE;
+    }
+
+    smp_t *smp = CPU->smp;
+    if (smp == NULL)
+    {
+        return SMP_NO_CORE;
+    }
+
+    // Free core is taken, nobody else touches it until its thread is woken up
+    smp_core_t *core = NULL;
+    {
+        std::lock_guard<std::mutex> guard(smp->lock);
+        for (int index = 0; index < smp->coresCount - 1 && core == NULL; ++index)
+        {
+            if (smp->cores[index].state == SMP_CORE_STATES::IDLE)
+            {
+                core = &smp->cores[index];
+                core->state = SMP_CORE_STATES::RUNNING;
+                smp->runningCoresCount += 1;
+            }
+        }
+    }
+    if (core == NULL)
+    {
+        return SMP_NO_CORE;
+    }
+
+    // Arguments are in the registers
+    IS_OK_WO_EXIT(cpuReset(&core->CPU));
+    IS_OK_WO_EXIT(inputRecord(&core->CPU.input, NULL, 0));
+    memcpy(core->CPU.commonRegs, CPU->commonRegs, sizeof(CPU->commonRegs));
+    memcpy(core->CPU.intRegs, CPU->intRegs, sizeof(CPU->intRegs));
+    core->CPU.ip = (int) address;
+    core->runsCount += 1;
+
+    // Text printed before `spawn` is written before the output of the core
+    IS_OK_WO_EXIT(outputFlush(&CPU->output));
+
+    // Start (the mutex orders the writes of `CPU` before the first command of the core)
+    {
+        std::lock_guard<std::mutex> guard(smp->lock);
+        core->isStarting = true;
+    }
+    if (core->thread.joinable())
+    {
+        core->isSpawned.notify_one();
+        return core->CPU.coreId;
+    }
+
+    try
+    {
+        core->thread = std::thread(smpCore, smp, core);
+    }
+    catch (const std::system_error &)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(SMP_EXIT_CODES::ERROR_STARTING_CORE);
+
+        std::lock_guard<std::mutex> guard(smp->lock);
+        core->isStarting        = false;
+        core->state             = SMP_CORE_STATES::IDLE;
+        smp->runningCoresCount  -= 1;
+        smp->coreIsHalted.notify_all();
+
+        return SMP_NO_CORE;
+    }
+
+    return core->CPU.coreId;
+}
+
+/**
+ * @brief Function that waits for the spawned core to halt and frees it (`join` command)
+ * 
+ * @param CPU 
+ * @param core index of the core
+ * @return double exit code of the core, SMP_NO_CORE if it is not spawned (or it is `CPU` itself)
+ */
+double smpJoin(cpu_t *CPU, double core)
+{
+    // Error check
+    if (CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return SMP_NO_CORE;
+    }
+
+    smp_t *smp = CPU->smp;
+    if (smp == NULL || !IS_INTEGRAL(core) || core < 1 || core >= smp->coresCount || (int) core == CPU->coreId)
+    {
+        return SMP_NO_CORE;
+    }
+
+    // Wait (the mutex orders the writes of the core before the next command of `CPU`)
+    smp_core_t *joined = &smp->cores[(int) core - 1];
+    std::unique_lock<std::mutex> lock(smp->lock);
+    if (joined->state == SMP_CORE_STATES::IDLE)
+    {
+        return SMP_NO_CORE;
+    }
+    smp->coreIsHalted.wait(lock, [joined] { return joined->state != SMP_CORE_STATES::RUNNING; });
+    joined->state = SMP_CORE_STATES::IDLE;
+
+    return cpuGetExitCode(&joined->CPU);
+}
+
+/**
+ * @brief Function that waits for every spawned core to halt, stops the threads of the cores and frees them
+ * 
+ * @param smp 
+ * @param CPU core 0 (gets the statistics of the others)
+ * @param constructedCount cores constructed by `cpuExecuteSmp`
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES smpShutDown(smp_t *smp, cpu_t *CPU, int constructedCount)
+{
+    // Error check
+    if (smp == NULL || CPU == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // The machine halts when all the cores do
+    {
+        std::unique_lock<std::mutex> lock(smp->lock);
+        smp->coreIsHalted.wait(lock, [smp] { return smp->runningCoresCount == 0; });
+        smp->isShutDown = true;
+    }
+
+    EXIT_CODES exitCode = EXIT_CODES::NO_ERRORS;
+    int spawnsCount = 0;
+    for (int index = 0; index < constructedCount; ++index)
+    {
+        smp_core_t *core = &smp->cores[index];
+        if (core->thread.joinable())
+        {
+            core->isSpawned.notify_one();
+            core->thread.join();
+        }
+
+        spawnsCount                 += core->runsCount;
+        CPU->stats.commands         += core->CPU.stats.commands;
+        CPU->stats.fusedCommands    += core->CPU.stats.fusedCommands;
+        CPU->stats.nativeCommands   += core->CPU.stats.nativeCommands;
+        IS_ERROR(cpuDtor(&core->CPU))
+        {
+            exitCode = EXIT_CODES::DESTRUCTOR_ERROR;
+        }
+    }
+
+    if (CPU->stats.enabled)
+    {
+        fprintf(stderr, YELLOW "[SMP]" RESET " cores: %d, spawns: %d, failed: %d\n", smp->coresCount, spawnsCount, smp->failedRunsCount);
+    }
+
+    delete[] smp->cores;
+    smp->cores = NULL;
+
+    return exitCode;
+}
+
+/**
+ * @brief Function that executes the bytecode on the machine of `coresCount` virtual cores, the first one starts at the beginning of the program
+ * 
+ * Every core has its own stack, registers, flags and output, the RAM, the decoded program and the `jit` native code are shared.
+ * Cores are started by `spawn` on their own host threads, the machine halts when all of them do
+ * 
+ * @param byteCode 
+ * @param CPU core 0 (its settings are used for all the cores, its RAM is shared by them)
+ * @param coresCount 
+ * @param exitCode EXIT_SUCCESS if every core halted without a runtime error
+ * @return EXIT_CODES 
+ */
+EXIT_CODES cpuExecuteSmp(text_t *byteCode, cpu_t *CPU, int coresCount, int *exitCode)
+{
+    // Error check
+    if (byteCode == NULL || CPU == NULL || exitCode == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+    if (coresCount <= 0 || coresCount > MAX_SMP_CORES || CPU->RAMBackend != RAM_BACKENDS::FLAT)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(SMP_EXIT_CODES::BAD_CORES_COUNT);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Decoding (and translation) is shared by the cores
+    IS_ERROR(cpuLoadProgram(byteCode, CPU))
+    {
+        PRINT_ERROR_TRACING_MESSAGE(PROCESSOR_EXIT_CODES::ERROR_DECODING_BYTECODE);
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    smp_t smp = {};
+    smp.byteCode    = byteCode;
+    smp.coresCount  = coresCount;
+    smp.cores       = new (std::nothrow) smp_core_t[coresCount - 1];
+    if (smp.cores == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(SMP_EXIT_CODES::ERROR_ALLOCATING_CORES);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    int constructedCount = 0;
+    for (; constructedCount < coresCount - 1; ++constructedCount)
+    {
+        IS_ERROR(smpCoreCpuCtor(&smp.cores[constructedCount].CPU, CPU, &smp, constructedCount + 1))
+        {
+            PRINT_ERROR_TRACING_MESSAGE(SMP_EXIT_CODES::ERROR_CONSTRUCTING_CORE_CPU);
+            IS_OK_WO_EXIT(cpuDtor(&smp.cores[constructedCount].CPU));
+            IS_OK_WO_EXIT(smpShutDown(&smp, CPU, constructedCount));
+            return EXIT_CODES::CONSTRUCTOR_ERROR;
+        }
+    }
+
+    // Core 0 boots the machine on the calling thread
+    CPU->smp    = &smp;
+    CPU->coreId = 0;
+    IS_OK_WO_EXIT(cpuExecuteBytecode(byteCode, CPU));
+
+    EXIT_CODES shutDownCode = smpShutDown(&smp, CPU, constructedCount);
+    CPU->smp = NULL;
+
+    *exitCode = cpuGetExitCode(CPU) == EXIT_SUCCESS && smp.failedRunsCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    return shutDownCode;
+}
@@ -0,0 +1,374 @@
+#include <math.h>    // for fabs
+#include <string.h>  // for memcpy
+
+#include "libs/colors/colors.h"
+
+#include "include/opcodes.h"
+#include "include/processor/decoder.h"
+#include "include/processor/settings.h"
+#include "include/processor/verifier.h"
+
+/**
+ * @brief Structure that represents the label operand to check once all the command boundaries are known
+ * 
+ */
+struct verifier_jump_t
+{
+    offset address                  = 0;        // Offset of the command
+    offset target                   = 0;        // Raw label operand
+};
+
+/**
+ * @brief Structure that contains the state of the verification
+ * 
+ */
+struct verifier_t
+{
+    text_t *byteCode                = NULL;
+    size_t RAMSize                  = 0;        // Amount of RAM cells
+    size_t ip                       = 0;        // Offset of the next byte to check
+    offset address                  = 0;        // Offset of the command that is checked
+    bool *isBoundary                = NULL;     // Bytecode offset -> command starts there (last one is the end of the bytecode)
+    verifier_jump_t *jumps          = NULL;
+    int jumpsCount                  = 0;
+    int violationsCount             = 0;
+};
+
+/**
+ * @brief Get the description of the violation
+ * 
+ * @param violation 
+ * @return const char*
+ */
+static const char *getViolationDescription(VERIFIER_VIOLATIONS violation)
+{
+    switch (violation)
+    {
+        case VERIFIER_VIOLATIONS::INVALID_OPCODE:               return "invalid opcode";
+        case VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE:          return "operand does not fit inside of the bytecode";
+        case VERIFIER_VIOLATIONS::BAD_OPERAND_TYPE:             return "argument is neither register nor immediate";
+        case VERIFIER_VIOLATIONS::BAD_REGISTER_CODE:            return "invalid register code";
+        case VERIFIER_VIOLATIONS::JUMP_TARGET_IS_NOT_COMMAND:   return "jump target is not a command boundary";
+        case VERIFIER_VIOLATIONS::RAM_ADDRESS_OUT_OF_RANGE:     return "constant RAM address is out of range";
+        case VERIFIER_VIOLATIONS::POP_INTO_IMMEDIATE:           return "pop into immediate";
+        default:                                                return "unknown violation";
+    }
+}
+
+/**
+ * @brief Function that reports the violation of the command that is checked
+ * 
+ * @param verifier 
+ * @param violation 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES reportViolation(verifier_t *verifier, VERIFIER_VIOLATIONS violation)
+{
+    // Error check
+    if (verifier == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Report
+    fprintf(stderr, RED "[VERIFIER]" RESET " 0x%04x: %s (%d)\n",
+            verifier->address, getViolationDescription(violation), (int) violation);
+    ++verifier->violationsCount;
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that checks MRI-encoded operand of the command (`BAD_OBJECT_PASSED` means the length of the command is unknown)
+ * 
+ * @param verifier 
+ * @param opcode 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES verifyValueOperand(verifier_t *verifier, byte opcode)
+{
+    // Error check
+    if (verifier == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    text_t *byteCode = verifier->byteCode;
+    if (verifier->ip >= byteCode->size)
+    {
+        IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Get metainfo
+    size_t argc     = (size_t) GET_TOTAL_ARGS(byteCode->data[verifier->ip]);
+    int globalMRI   = (int)    GET_GLOBAL_MRI(byteCode->data[verifier->ip]);
+    ++verifier->ip;
+
+    // Check arguments
+    int regsCount           = 0;
+    int intRegsCount        = 0;
+    bool firstIsRegister    = false;
+    double constant         = 0;
+    for (size_t arg = 0; arg < argc; ++arg)
+    {
+        if (verifier->ip >= byteCode->size)
+        {
+            IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        if (MRI_IS_REGISTER(byteCode->data[verifier->ip]))
+        {
+            ++verifier->ip;
+            if (verifier->ip + sizeof(byte) > byteCode->size)
+            {
+                IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            byte regCode = (byte) byteCode->data[verifier->ip];
+            if (regCode >= MAX_REGS_COUNT && !IS_INT_REGISTER_CODE(regCode))
+            {
+                IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::BAD_REGISTER_CODE));
+            }
+
+            ++(*(IS_INT_REGISTER_CODE(regCode) ? &intRegsCount : &regsCount));
+            firstIsRegister = firstIsRegister || arg == 0;
+
+            verifier->ip += sizeof(byte);
+        }
+        else if (MRI_IS_IMMEDIATE(byteCode->data[verifier->ip]))
+        {
+            ++verifier->ip;
+            if (verifier->ip + sizeof(double) > byteCode->size)
+            {
+                IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            double immediate = 0;
+            memcpy(&immediate, &byteCode->data[verifier->ip], sizeof(double));
+            constant += immediate;
+
+            verifier->ip += sizeof(double);
+        }
+        else
+        {
+            IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::BAD_OPERAND_TYPE));
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+    }
+
+    // Check constant RAM address (computed ones are checked at runtime)
+    if (MRI_IS_MEMORY(globalMRI))
+    {
+        if (regsCount == 0 && intRegsCount == 0 && !IS_VALID_RAM_INDEX(constant, verifier->RAMSize))
+        {
+            IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::RAM_ADDRESS_OUT_OF_RANGE));
+        }
+    }
+    else if (opcode == OPCODE_pop && !firstIsRegister)
+    {
+        IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::POP_INTO_IMMEDIATE));
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that checks the operand of INTEGER command (`BAD_OBJECT_PASSED` means the length of the command is unknown)
+ * 
+ * @param verifier 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES verifyIntegerOperand(verifier_t *verifier)
+{
+    // Error check
+    if (verifier == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    text_t *byteCode = verifier->byteCode;
+    if (verifier->ip + 2 * sizeof(byte) > byteCode->size)
+    {
+        IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Check destination
+    if (!IS_INT_REGISTER_CODE((byte) byteCode->data[verifier->ip]))
+    {
+        IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::BAD_REGISTER_CODE));
+    }
+    ++verifier->ip;
+
+    // Check source
+    byte sourceMRI = (byte) byteCode->data[verifier->ip++];
+    if (MRI_IS_REGISTER(sourceMRI))
+    {
+        if (verifier->ip + sizeof(byte) > byteCode->size)
+        {
+            IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+
+        if (!IS_INT_REGISTER_CODE((byte) byteCode->data[verifier->ip]))
+        {
+            IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::BAD_REGISTER_CODE));
+        }
+        verifier->ip += sizeof(byte);
+    }
+    else if (MRI_IS_IMMEDIATE(sourceMRI))
+    {
+        if (verifier->ip + sizeof(long long) > byteCode->size)
+        {
+            IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+        }
+        verifier->ip += sizeof(long long);
+    }
+    else
+    {
+        IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::BAD_OPERAND_TYPE));
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that checks one command of the bytecode (`BAD_OBJECT_PASSED` means the length of the command is unknown)
+ * 
+ * @param verifier 
+ * @return EXIT_CODES 
+ */
+static EXIT_CODES verifyCommand(verifier_t *verifier)
+{
+    // Error check
+    if (verifier == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Check opcode
+    text_t *byteCode = verifier->byteCode;
+    verifier->address = (offset) verifier->ip;
+    verifier->isBoundary[verifier->ip] = true;
+
+    byte opcode = (byte) byteCode->data[verifier->ip++];
+    OPERAND_TYPES type = OPERAND_TYPES::NONE;
+    IS_ERROR(getOperandType(opcode, &type))
+    {
+        IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::INVALID_OPCODE));
+        return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    // Check operand
+    switch (type)
+    {
+        case OPERAND_TYPES::VALUE:
+            return verifyValueOperand(verifier, opcode);
+        case OPERAND_TYPES::INTEGER:
+            return verifyIntegerOperand(verifier);
+        case OPERAND_TYPES::LABEL:
+        {
+            if (verifier->ip + sizeof(offset) > byteCode->size)
+            {
+                IS_OK_WO_EXIT(reportViolation(verifier, VERIFIER_VIOLATIONS::OPERAND_OUT_OF_CODE));
+                return EXIT_CODES::BAD_OBJECT_PASSED;
+            }
+
+            // Target is checked once all the boundaries are known
+            verifier_jump_t *jump = &verifier->jumps[verifier->jumpsCount++];
+            jump->address = verifier->address;
+            memcpy(&jump->target, &byteCode->data[verifier->ip], sizeof(offset));
+
+            verifier->ip += sizeof(offset);
+            break;
+        }
+        case OPERAND_TYPES::NONE:
+            break;
+        default:
+            return EXIT_CODES::BAD_OBJECT_PASSED;
+    }
+
+    return EXIT_CODES::NO_ERRORS;
+}
+
+/**
+ * @brief Function that checks the whole bytecode once before the execution (every violation is reported to stderr with its address)
+ * 
+ * Verified bytecode is guaranteed to have only valid opcodes, operands inside of the bytecode, jump targets on the command
+ * boundaries, valid register codes and constant RAM addresses in range (return addresses and computed RAM addresses
+ * are still checked at runtime)
+ * 
+ * @param byteCode 
+ * @param violationsCount 
+ * @return EXIT_CODES 
+ */
+EXIT_CODES verifyBytecode(text_t *byteCode, size_t RAMSize, int *violationsCount)
+{
+    // Error check
+    if (byteCode == NULL || violationsCount == NULL)
+    {
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::PASSED_OBJECT_IS_NULLPTR);
+        return EXIT_CODES::PASSED_OBJECT_IS_NULLPTR;
+    }
+
+    // Memory allocation (every label command is 1 + sizeof(offset) bytes long)
+    verifier_t verifier = {};
+    verifier.byteCode = byteCode;
+    verifier.RAMSize  = RAMSize;
+
+    verifier.isBoundary = (bool *) calloc(byteCode->size + 1, sizeof(bool));
+    CHECK_CALLOC_RESULT(verifier.isBoundary);
+
+    verifier.jumps = (verifier_jump_t *) calloc(byteCode->size / (1 + sizeof(offset)) + 1, sizeof(verifier_jump_t));
+    if (verifier.jumps == NULL)
+    {
+        free(verifier.isBoundary);
+        PRINT_ERROR_TRACING_MESSAGE(EXIT_CODES::BAD_STD_FUNC_RESULT);
+        return EXIT_CODES::BAD_STD_FUNC_RESULT;
+    }
+
+    // Check commands (stop at the first one with unknown length: next boundaries are unknown too)
+    bool isComplete = true;
+    while (verifier.ip < byteCode->size)
+    {
+        IS_ERROR(verifyCommand(&verifier))
+        {
+            isComplete = false;
+            break;
+        }
+    }
+    verifier.isBoundary[byteCode->size] = isComplete;
+
+    // Check jump targets (the ones after the unchecked part can not be proved or refuted)
+    for (int jump = 0; jump < verifier.jumpsCount; ++jump)
+    {
+        size_t target = (size_t) verifier.jumps[jump].target;
+        if (!isComplete && target >= verifier.ip)
+        {
+            continue;
+        }
+
+        if (target > byteCode->size || !verifier.isBoundary[target])
+        {
+            verifier.address = verifier.jumps[jump].address;
+            IS_OK_WO_EXIT(reportViolation(&verifier, VERIFIER_VIOLATIONS::JUMP_TARGET_IS_NOT_COMMAND));
+        }
+    }
+
+    *violationsCount = verifier.violationsCount;
+
+    free(verifier.isBoundary);
+    free(verifier.jumps);
+
+    return EXIT_CODES::NO_ERRORS;
+}